@@ -0,0 +1,102 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ObjWriter.h"
+
+#include "LogHandler.h"
+#include "Utils.h"
+
+namespace {
+
+constexpr int COORD_PRECISION = 9; // exact for the single precision of the houdini detail
+
+// OBJ indices are one-based, negative indices count back from the last written element
+int64_t toRelativeIndex(uint32_t index, size_t count) {
+	return static_cast<int64_t>(index) - static_cast<int64_t>(count);
+}
+
+} // namespace
+
+ObjWriter::ObjWriter(const std::filesystem::path& file) : mOut(file) {
+	if (!mOut)
+		LOG_ERR << "Cannot write " << file;
+	mOut.precision(COORD_PRECISION);
+}
+
+void ObjWriter::add(const wchar_t* name, const double* vtx, size_t vtxSize, const double* nrm, size_t nrmSize,
+                    const uint32_t* counts, size_t countsSize, const uint32_t* holeCounts, size_t holeCountsSize,
+                    const uint32_t* holeIndices, size_t holeIndicesSize, const uint32_t* vertexIndices,
+                    size_t vertexIndicesSize, const uint32_t* normalIndices, size_t normalIndicesSize,
+                    double const* const* uvs, size_t const* uvsSizes, uint32_t const* const* uvCounts,
+                    size_t const* uvCountsSizes, uint32_t const* const* uvIndices, size_t const* uvIndicesSizes,
+                    uint32_t uvSets, const uint32_t* faceRanges, size_t faceRangesSize,
+                    const prt::AttributeMap** materials, const prt::AttributeMap** reports, const int32_t* shapeIDs) {
+	const size_t vtxCount = vtxSize / 3;
+	const size_t nrmCount = (normalIndicesSize == vertexIndicesSize) ? nrmSize / 3 : 0;
+	const bool hasUVs = (uvSets > 0 && uvsSizes[0] > 0 && uvIndicesSizes[0] > 0);
+	const size_t uvCount = hasUVs ? uvsSizes[0] / 2 : 0;
+
+	mOut << "o " << toUTF8FromUTF16(name) << '\n';
+	for (size_t i = 0; i < vtxCount * 3; i += 3)
+		mOut << "v " << vtx[i] << ' ' << vtx[i + 1] << ' ' << vtx[i + 2] << '\n';
+	for (size_t i = 0; i < uvCount * 2; i += 2)
+		mOut << "vt " << uvs[0][i] << ' ' << uvs[0][i + 1] << '\n';
+	for (size_t i = 0; i < nrmCount * 3; i += 3)
+		mOut << "vn " << nrm[i] << ' ' << nrm[i + 1] << ' ' << nrm[i + 2] << '\n';
+
+	size_t vi = 0;
+	size_t uvi = 0;
+	for (size_t fi = 0; fi < countsSize; fi++) {
+		const bool faceHasUVs = hasUVs && fi < uvCountsSizes[0] && uvCounts[0][fi] > 0;
+		mOut << 'f';
+		for (uint32_t c = 0; c < counts[fi]; c++, vi++) {
+			mOut << ' ' << toRelativeIndex(vertexIndices[vi], vtxCount);
+			if (faceHasUVs || nrmCount > 0)
+				mOut << '/';
+			if (faceHasUVs)
+				mOut << toRelativeIndex(uvIndices[0][uvi++], uvCount);
+			if (nrmCount > 0)
+				mOut << '/' << toRelativeIndex(normalIndices[vi], nrmCount);
+		}
+		mOut << '\n';
+	}
+
+	mMeshCount++;
+	mFaceCount += countsSize;
+}
+
+prt::Status ObjWriter::generateError(size_t isIndex, prt::Status status, const wchar_t* message) {
+	LOG_ERR << "initial shape " << isIndex << ": " << message;
+	mErrorCount++;
+	return prt::STATUS_OK;
+}
+
+prt::Status ObjWriter::assetError(size_t isIndex, prt::CGAErrorLevel level, const wchar_t* key, const wchar_t* uri,
+                                  const wchar_t* message) {
+	LOG_WRN << "initial shape " << isIndex << ": asset " << key << ": " << message;
+	return prt::STATUS_OK;
+}
+
+prt::Status ObjWriter::cgaError(size_t isIndex, int32_t shapeID, prt::CGAErrorLevel level, int32_t methodId,
+                                int32_t pc, const wchar_t* message) {
+	LOG_WRN << "initial shape " << isIndex << ": CGA error: " << message;
+	return prt::STATUS_OK;
+}
+
+prt::Status ObjWriter::cgaPrint(size_t isIndex, int32_t shapeID, const wchar_t* txt) {
+	LOG_INF << "initial shape " << isIndex << ": " << txt;
+	return prt::STATUS_OK;
+}
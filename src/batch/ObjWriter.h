@@ -0,0 +1,116 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "encoder/HoudiniCallbacks.h"
+
+#include <filesystem>
+#include <fstream>
+
+/**
+ * writes the generated meshes as wavefront OBJ objects, the neutral replacement of the houdini detail without HDK.
+ * all indices are relative, so the files of several writers can be concatenated.
+ * expects triangulated faces with holes and only writes the first uv set.
+ */
+class ObjWriter : public HoudiniCallbacks {
+public:
+	explicit ObjWriter(const std::filesystem::path& file);
+	~ObjWriter() override = default;
+
+	bool isOpen() const {
+		return mOut.is_open() && mOut.good();
+	}
+
+	void close() {
+		mOut.close();
+	}
+
+	size_t getMeshCount() const {
+		return mMeshCount;
+	}
+
+	size_t getFaceCount() const {
+		return mFaceCount;
+	}
+
+	size_t getErrorCount() const {
+		return mErrorCount;
+	}
+
+	void add(const wchar_t* name, const double* vtx, size_t vtxSize, const double* nrm, size_t nrmSize,
+	         const uint32_t* counts, size_t countsSize, const uint32_t* holeCounts, size_t holeCountsSize,
+	         const uint32_t* holeIndices, size_t holeIndicesSize, const uint32_t* vertexIndices,
+	         size_t vertexIndicesSize, const uint32_t* normalIndices, size_t normalIndicesSize,
+	         double const* const* uvs, size_t const* uvsSizes, uint32_t const* const* uvCounts,
+	         size_t const* uvCountsSizes, uint32_t const* const* uvIndices, size_t const* uvIndicesSizes,
+	         uint32_t uvSets, const uint32_t* faceRanges, size_t faceRangesSize, const prt::AttributeMap** materials,
+	         const prt::AttributeMap** reports, const int32_t* shapeIDs) override;
+
+	prt::Status generateError(size_t isIndex, prt::Status status, const wchar_t* message) override;
+	prt::Status assetError(size_t isIndex, prt::CGAErrorLevel level, const wchar_t* key, const wchar_t* uri,
+	                       const wchar_t* message) override;
+	prt::Status cgaError(size_t isIndex, int32_t shapeID, prt::CGAErrorLevel level, int32_t methodId, int32_t pc,
+	                     const wchar_t* message) override;
+	prt::Status cgaPrint(size_t isIndex, int32_t shapeID, const wchar_t* txt) override;
+
+	prt::Status cgaReportBool(size_t, int32_t, const wchar_t*, bool) override {
+		return prt::STATUS_OK;
+	}
+	prt::Status cgaReportFloat(size_t, int32_t, const wchar_t*, double) override {
+		return prt::STATUS_OK;
+	}
+	prt::Status cgaReportString(size_t, int32_t, const wchar_t*, const wchar_t*) override {
+		return prt::STATUS_OK;
+	}
+	prt::Status attrBool(size_t, int32_t, const wchar_t*, bool) override {
+		return prt::STATUS_OK;
+	}
+	prt::Status attrFloat(size_t, int32_t, const wchar_t*, double) override {
+		return prt::STATUS_OK;
+	}
+	prt::Status attrString(size_t, int32_t, const wchar_t*, const wchar_t*) override {
+		return prt::STATUS_OK;
+	}
+
+#if ((PRT_VERSION_MAJOR > 1 && PRT_VERSION_MINOR > 1) || PRT_VERSION_MAJOR > 2)
+	prt::Status attrBoolArray(size_t, int32_t, const wchar_t*, const bool*, size_t, size_t) override {
+		return prt::STATUS_OK;
+	}
+	prt::Status attrFloatArray(size_t, int32_t, const wchar_t*, const double*, size_t, size_t) override {
+		return prt::STATUS_OK;
+	}
+	prt::Status attrStringArray(size_t, int32_t, const wchar_t*, const wchar_t* const*, size_t, size_t) override {
+		return prt::STATUS_OK;
+	}
+#elif (PRT_VERSION_MAJOR > 1 && PRT_VERSION_MINOR > 0)
+	prt::Status attrBoolArray(size_t, int32_t, const wchar_t*, const bool*, size_t) override {
+		return prt::STATUS_OK;
+	}
+	prt::Status attrFloatArray(size_t, int32_t, const wchar_t*, const double*, size_t) override {
+		return prt::STATUS_OK;
+	}
+	prt::Status attrStringArray(size_t, int32_t, const wchar_t*, const wchar_t* const*, size_t) override {
+		return prt::STATUS_OK;
+	}
+#endif
+
+private:
+	std::ofstream mOut;
+	size_t mMeshCount = 0;
+	size_t mFaceCount = 0;
+	size_t mErrorCount = 0;
+};
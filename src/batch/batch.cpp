@@ -0,0 +1,378 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ObjWriter.h"
+
+#include "HeadlessGenerate.h"
+#include "PRTContext.h"
+#include "SceneCapture.h"
+#include "Utils.h"
+
+#include "prt/API.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr const wchar_t* ENCODER_ID_CGA_ERROR = L"com.esri.prt.core.CGAErrorEncoder";
+constexpr const wchar_t* ENCODER_ID_CGA_PRINT = L"com.esri.prt.core.CGAPrintEncoder";
+constexpr const wchar_t* FILE_CGA_ERROR = L"CGAErrors.txt";
+constexpr const wchar_t* FILE_CGA_PRINT = L"CGAPrint.txt";
+
+constexpr const char* SCENE_FILE_EXT = ".pldscene";
+constexpr const char* OBJ_FILE_EXT = ".obj";
+constexpr const char* RPK_DISK_CACHE_ENV_VAR = "CITYENGINE_RPK_DISK_CACHE";
+
+struct Options {
+	std::vector<std::filesystem::path> inputs; // geometry files or scene captures
+	std::filesystem::path output;
+	std::filesystem::path rpk;
+	std::string startRule = "Default$Init";
+	int32_t seed = 0;
+	size_t threads = 0; // 0: number of cores
+	size_t shardIndex = 0;
+	size_t shardCount = 1;
+	std::filesystem::path rpkCacheDir;
+};
+
+constexpr const char* USAGE = R"(usage: palladio_batch --output=FILE.obj [--option=value ...] INPUT...
+  generates the initial shapes of the inputs like the generate node and writes the result into an OBJ file
+  INPUT               geometry file resolvable by PRT (e.g. OBJ, one initial shape per file)
+                      or scene capture (.pldscene, see CITYENGINE_CAPTURE_SCENE_DIR)
+  --output=PATH       result OBJ file
+  --rpk=PATH          rule package for the geometry files
+  --start-rule=RULE   start rule for the geometry files (default Default$Init)
+  --seed=N            random seed for the geometry files (default 0)
+  --threads=N         number of concurrent generate calls (default: number of cores)
+  --shard=K/N         only generate the initial shapes of shard K of N (default 0/1)
+  --rpk-cache-dir=DIR persistent cache of unpacked rule packages, like CITYENGINE_RPK_DISK_CACHE
+)";
+
+void parseShard(const std::string& value, Options& options) {
+	const size_t sep = value.find('/');
+	if (sep == std::string::npos)
+		throw std::invalid_argument(value);
+	options.shardIndex = std::stoul(value.substr(0, sep));
+	options.shardCount = std::stoul(value.substr(sep + 1));
+	if (options.shardCount == 0 || options.shardIndex >= options.shardCount)
+		throw std::invalid_argument(value);
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+	for (int i = 1; i < argc; i++) {
+		const std::string arg = argv[i];
+		if (arg.compare(0, 2, "--") != 0) {
+			options.inputs.emplace_back(arg);
+			continue;
+		}
+
+		const size_t sep = arg.find('=');
+		if (sep == std::string::npos)
+			return false;
+		const std::string name = arg.substr(2, sep - 2);
+		const std::string value = arg.substr(sep + 1);
+
+		if (name == "output")
+			options.output = value;
+		else if (name == "rpk")
+			options.rpk = value;
+		else if (name == "start-rule")
+			options.startRule = value;
+		else if (name == "seed")
+			options.seed = std::stoi(value);
+		else if (name == "threads")
+			options.threads = std::stoul(value);
+		else if (name == "shard")
+			parseShard(value, options);
+		else if (name == "rpk-cache-dir")
+			options.rpkCacheDir = value;
+		else
+			return false;
+	}
+	return !options.inputs.empty() && !options.output.empty();
+}
+
+void setEnvVar(const char* name, const std::string& value) {
+#ifdef _WIN32
+	_putenv_s(name, value.c_str());
+#else
+	setenv(name, value.c_str(), 1);
+#endif
+}
+
+bool isSceneCapture(const std::filesystem::path& p) {
+	return p.extension() == SCENE_FILE_EXT;
+}
+
+/**
+ * owns the initial shapes of all inputs and the data they refer to
+ */
+class InitialShapes {
+public:
+	InitialShapes(const Options& options, PRTContext& prtCtx) : mOptions(options), mPRTCtx(prtCtx) {
+		const AttributeMapBuilderUPtr amb(prt::AttributeMapBuilder::create());
+		mEmptyAttributes.reset(amb->createAttributeMap());
+	}
+
+	void addSceneCapture(const std::filesystem::path& file) {
+		auto scene = std::make_unique<CapturedScene>(readScene(file));
+		std::vector<CapturedShape> shardShapes;
+		for (auto& shape : scene->shapes) {
+			if (takeInput())
+				shardShapes.emplace_back(std::move(shape));
+		}
+		scene->shapes = std::move(shardShapes);
+		for (auto& is : createInitialShapes(scene->shapes, mPRTCtx))
+			add(std::move(is));
+		mScenes.emplace_back(std::move(scene));
+	}
+
+	void addGeometry(const std::filesystem::path& file) {
+		if (!takeInput())
+			return;
+		if (!mResolveMap) {
+			if (mOptions.rpk.empty())
+				throw std::runtime_error("geometry inputs require a rule package (--rpk)");
+			mResolveMap = mPRTCtx.getResolveMap(mOptions.rpk);
+			const auto cgb = mResolveMap ? getCGB(mResolveMap) : std::nullopt; // key -> uri
+			if (!cgb)
+				throw std::runtime_error("cannot load rule file of rule package " + mOptions.rpk.string());
+			mRuleFile = cgb->second;
+		}
+
+		const InitialShapeBuilderUPtr isb(prt::InitialShapeBuilder::create());
+		const std::wstring uri = toFileURI(std::filesystem::absolute(file).string());
+		const std::wstring startRule = toUTF16FromOSNarrow(mOptions.startRule);
+		const std::wstring name = file.stem().wstring();
+
+		prt::Status status = isb->resolveGeometry(uri.c_str(), mResolveMap.get(), mPRTCtx.mPRTCache.get());
+		if (status == prt::STATUS_OK) {
+			status = isb->setAttributes(mRuleFile.c_str(), startRule.c_str(), mOptions.seed, name.c_str(),
+			                            mEmptyAttributes.get(), mResolveMap.get());
+		}
+		InitialShapeUPtr is;
+		if (status == prt::STATUS_OK)
+			is.reset(isb->createInitialShapeAndReset(&status));
+		if (status != prt::STATUS_OK || !is)
+			throw std::runtime_error("cannot create initial shape from " + file.string() + ": " +
+			                         prt::getStatusDescription(status));
+		add(std::move(is));
+	}
+
+	size_t getInputCount() const {
+		return mInputCount;
+	}
+
+	const InitialShapeNOPtrVector& get() const {
+		return mInitialShapePtrs;
+	}
+
+private:
+	// the shards are assigned by the position within all inputs, returns true if the next input is in our shard
+	bool takeInput() {
+		return (mInputCount++ % mOptions.shardCount == mOptions.shardIndex);
+	}
+
+	void add(InitialShapeUPtr&& is) {
+		mInitialShapePtrs.push_back(is.get());
+		mInitialShapes.emplace_back(std::move(is));
+	}
+
+	const Options& mOptions;
+	PRTContext& mPRTCtx;
+
+	std::vector<std::unique_ptr<CapturedScene>> mScenes;
+	ResolveMapSPtr mResolveMap;
+	std::wstring mRuleFile;
+	AttributeMapUPtr mEmptyAttributes;
+
+	size_t mInputCount = 0;
+	std::vector<InitialShapeUPtr> mInitialShapes;
+	InitialShapeNOPtrVector mInitialShapePtrs;
+};
+
+/**
+ * the encoder setup of the generate node, faces with holes are triangulated for OBJ
+ */
+class EncoderSetup {
+public:
+	explicit EncoderSetup(const PRTContext& prtCtx) {
+		AttributeMapBuilderUPtr amb(prt::AttributeMapBuilder::create());
+		amb->setBool(EO_EMIT_ATTRIBUTES, false);
+		amb->setBool(EO_EMIT_MATERIALS, false);
+		amb->setBool(EO_EMIT_REPORTS, false);
+		amb->setBool(EO_TRIANGULATE_FACES_WITH_HOLES, true);
+		const AttributeMapUPtr houdiniOptions(amb->createAttributeMapAndReset());
+		mHoudiniEncoderOptions.reset(createValidatedOptions(ENCODER_ID_HOUDINI, houdiniOptions.get()));
+
+		amb->setString(L"name", FILE_CGA_ERROR);
+		const AttributeMapUPtr errOptions(amb->createAttributeMapAndReset());
+		mCGAErrorOptions.reset(createValidatedOptions(ENCODER_ID_CGA_ERROR, errOptions.get()));
+
+		amb->setString(L"name", FILE_CGA_PRINT);
+		const AttributeMapUPtr printOptions(amb->createAttributeMapAndReset());
+		mCGAPrintOptions.reset(createValidatedOptions(ENCODER_ID_CGA_PRINT, printOptions.get()));
+
+		amb->setInt(L"numberWorkerThreads", prtCtx.mCores);
+		mGenerateOptions.reset(amb->createAttributeMapAndReset());
+
+		if (!mHoudiniEncoderOptions || !mCGAErrorOptions || !mCGAPrintOptions)
+			throw std::runtime_error("cannot validate the encoder options, is the palladio codec missing?");
+
+		mSetup.encoders = {ENCODER_ID_HOUDINI, ENCODER_ID_CGA_ERROR, ENCODER_ID_CGA_PRINT};
+		mSetup.encoderOptions = {mHoudiniEncoderOptions.get(), mCGAErrorOptions.get(), mCGAPrintOptions.get()};
+		mSetup.generateOptions = mGenerateOptions.get();
+		mSetup.occlusion = true;
+	}
+
+	const GenerateSetup& get() const {
+		return mSetup;
+	}
+
+private:
+	AttributeMapUPtr mHoudiniEncoderOptions;
+	AttributeMapUPtr mCGAErrorOptions;
+	AttributeMapUPtr mCGAPrintOptions;
+	AttributeMapUPtr mGenerateOptions;
+	GenerateSetup mSetup;
+};
+
+std::filesystem::path getPartFile(const std::filesystem::path& output, size_t threadIndex) {
+	std::filesystem::path part = output;
+	part += ".part" + std::to_string(threadIndex);
+	return part;
+}
+
+// the ranges of the threads follow the input order, so does the concatenated output
+void concatenateParts(const std::filesystem::path& output, size_t parts) {
+	std::ofstream out(output, std::ofstream::binary);
+	if (!out)
+		throw std::runtime_error("cannot write " + output.string());
+	for (size_t t = 0; t < parts; t++) {
+		const std::filesystem::path part = getPartFile(output, t);
+		{
+			std::ifstream in(part, std::ifstream::binary);
+			if (in.peek() != std::ifstream::traits_type::eof())
+				out << in.rdbuf();
+		}
+		std::filesystem::remove(part);
+	}
+	if (!out)
+		throw std::runtime_error("cannot write " + output.string());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+	Options options;
+	try {
+		if (!parseOptions(argc, argv, options)) {
+			std::cerr << USAGE;
+			return 1;
+		}
+	}
+	catch (const std::logic_error&) { // invalid number or shard
+		std::cerr << USAGE;
+		return 1;
+	}
+	if (options.output.extension() != OBJ_FILE_EXT) {
+		std::cerr << "only OBJ output is supported, bgeo requires the houdini libraries" << std::endl;
+		return 1;
+	}
+
+	// the resolve map cache reads its configuration when PRT is initialized
+	if (!options.rpkCacheDir.empty())
+		setEnvVar(RPK_DISK_CACHE_ENV_VAR, options.rpkCacheDir.string());
+
+	const std::vector<std::filesystem::path> addExtDirs = {BATCH_PRT_EXT_DIR, BATCH_CODEC_EXT_DIR};
+	PRTContextUPtr prtCtx = std::make_unique<PRTContext>(addExtDirs);
+	if (!prtCtx->isAlive()) {
+		std::cerr << "Failed to initialize PRT" << std::endl;
+		return 1;
+	}
+
+	int exitCode = 0;
+	try {
+		const auto begin = Clock::now();
+
+		InitialShapes initialShapes(options, *prtCtx);
+		for (const auto& input : options.inputs) {
+			if (isSceneCapture(input))
+				initialShapes.addSceneCapture(input);
+			else
+				initialShapes.addGeometry(input);
+		}
+		const InitialShapeNOPtrVector& is = initialShapes.get();
+		if (is.empty())
+			throw std::runtime_error("no initial shapes in shard " + std::to_string(options.shardIndex));
+
+		const size_t threads = std::clamp<size_t>((options.threads > 0) ? options.threads : prtCtx->mCores, 1,
+		                                          is.size());
+
+		std::vector<std::unique_ptr<ObjWriter>> writers;
+		std::vector<prt::Callbacks*> callbacks;
+		for (size_t t = 0; t < threads; t++) {
+			writers.emplace_back(std::make_unique<ObjWriter>(getPartFile(options.output, t)));
+			if (!writers.back()->isOpen())
+				throw std::runtime_error("cannot write " + getPartFile(options.output, t).string());
+			callbacks.push_back(writers.back().get());
+		}
+
+		const EncoderSetup encoderSetup(*prtCtx);
+		const size_t failedCalls = generateHeadless(is, encoderSetup.get(), callbacks, prtCtx->mPRTCache.get());
+
+		size_t meshes = 0;
+		size_t faces = 0;
+		size_t errors = 0;
+		for (auto& writer : writers) {
+			writer->close();
+			meshes += writer->getMeshCount();
+			faces += writer->getFaceCount();
+			errors += writer->getErrorCount();
+		}
+		concatenateParts(options.output, threads);
+
+		const std::chrono::duration<double> elapsed = Clock::now() - begin;
+		std::cout << std::fixed << std::setprecision(3) << "shard " << options.shardIndex << "/"
+		          << options.shardCount << ": " << is.size() << " of " << initialShapes.getInputCount()
+		          << " initial shapes on " << threads << " threads, " << meshes << " meshes, " << faces
+		          << " faces in " << elapsed.count() << " s" << std::endl;
+
+		if (failedCalls > 0 || errors > 0) {
+			std::cerr << failedCalls << " generate calls and " << errors << " initial shapes failed" << std::endl;
+			exitCode = 1;
+		}
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		exitCode = 1;
+	}
+
+	prtCtx.reset();
+	return exitCode;
+}
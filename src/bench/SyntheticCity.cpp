@@ -0,0 +1,96 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SyntheticCity.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+
+namespace {
+
+constexpr double LOT_SPACING = 50.0;
+constexpr double LOT_MIN_EXTENT = 10.0;
+constexpr double LOT_MAX_EXTENT = 40.0;
+constexpr double COURTYARD_INSET = 0.3; // relative to the lot extent
+constexpr uint32_t HOLE_DELIMITER = std::numeric_limits<uint32_t>::max();
+
+// counter-clockwise seen from above (y-up), i.e. facing upwards
+void addRectangle(std::vector<double>& coords, double x0, double z0, double x1, double z1) {
+	coords.insert(coords.end(), {x0, 0.0, z0, x0, 0.0, z1, x1, 0.0, z1, x1, 0.0, z0});
+}
+
+} // namespace
+
+SyntheticCity::SyntheticCity(const Config& config) : mConfig(config) {
+	std::mt19937 rng(mConfig.seed);
+	std::uniform_real_distribution<double> extent(LOT_MIN_EXTENT, LOT_MAX_EXTENT);
+	std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+	const size_t columns = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(mConfig.lots))));
+
+	mLots.resize(mConfig.lots);
+	for (size_t li = 0; li < mLots.size(); li++) {
+		Lot& lot = mLots[li];
+
+		const double x0 = static_cast<double>(li % columns) * LOT_SPACING;
+		const double z0 = static_cast<double>(li / columns) * LOT_SPACING;
+		const double w = extent(rng);
+		const double d = extent(rng);
+
+		addRectangle(lot.coords, x0, z0, x0 + w, z0 + d);
+		lot.indices = {0, 1, 2, 3};
+		lot.faceCounts = {4};
+
+		if (unit(rng) < mConfig.holeDensity) {
+			// the hole ring has the opposite orientation
+			const double iw = COURTYARD_INSET * w;
+			const double id = COURTYARD_INSET * d;
+			addRectangle(lot.coords, x0 + iw, z0 + id, x0 + w - iw, z0 + d - id);
+			lot.indices.insert(lot.indices.end(), {7, 6, 5, 4});
+			lot.faceCounts.push_back(4);
+			lot.holes = {0, 1, HOLE_DELIMITER};
+		}
+
+		// planar projection onto the lot, the uvs are indexed like the vertices
+		for (size_t ci = 0; ci < lot.coords.size(); ci += 3) {
+			lot.uvs.push_back((lot.coords[ci] - x0) / w);
+			lot.uvs.push_back((lot.coords[ci + 2] - z0) / d);
+		}
+
+		lot.attributes.resize(mConfig.attributes);
+		for (double& a : lot.attributes)
+			a = unit(rng);
+	}
+
+	for (size_t ai = 0; ai < mConfig.attributes; ai++)
+		mAttributeNames.push_back(L"benchAttr" + std::to_wstring(ai));
+}
+
+void SyntheticCity::setup(size_t lotIdx, prt::InitialShapeBuilder& isb, prt::AttributeMapBuilder& isAttrs) const {
+	const Lot& lot = mLots[lotIdx];
+
+	isb.setGeometry(lot.coords.data(), lot.coords.size(), lot.indices.data(), lot.indices.size(),
+	                lot.faceCounts.data(), lot.faceCounts.size(), lot.holes.data(), lot.holes.size());
+
+	for (uint32_t uvSet = 0; uvSet < mConfig.uvSets; uvSet++) {
+		isb.setUVs(lot.uvs.data(), lot.uvs.size(), lot.indices.data(), lot.indices.size(), lot.faceCounts.data(),
+		           lot.faceCounts.size(), uvSet);
+	}
+
+	for (size_t ai = 0; ai < lot.attributes.size(); ai++)
+		isAttrs.setFloat(mAttributeNames[ai].c_str(), lot.attributes[ai]);
+}
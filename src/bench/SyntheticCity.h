@@ -0,0 +1,60 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "prt/AttributeMap.h"
+#include "prt/InitialShape.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * procedural grid of rectangular lots, optionally with a courtyard hole, used as initial shapes by the benchmarks
+ */
+class SyntheticCity {
+public:
+	struct Config {
+		size_t lots = 1000;
+		double holeDensity = 0.1; // fraction of the lots with a courtyard
+		uint32_t uvSets = 1;
+		size_t attributes = 0; // additional float attributes per lot
+		uint32_t seed = 0;
+	};
+
+	explicit SyntheticCity(const Config& config);
+
+	size_t size() const {
+		return mLots.size();
+	}
+
+	void setup(size_t lotIdx, prt::InitialShapeBuilder& isb, prt::AttributeMapBuilder& isAttrs) const;
+
+private:
+	struct Lot {
+		std::vector<double> coords;
+		std::vector<uint32_t> indices;
+		std::vector<uint32_t> faceCounts;
+		std::vector<uint32_t> holes;
+		std::vector<double> uvs;
+		std::vector<double> attributes;
+	};
+
+	const Config mConfig;
+	std::vector<Lot> mLots;
+	std::vector<std::wstring> mAttributeNames;
+};
@@ -0,0 +1,248 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SyntheticCity.h"
+#include "TestCallbacks.h"
+#include "TestUtils.h"
+
+#include "PRTContext.h"
+#include "Utils.h"
+
+#ifdef _WIN32
+#	include <Windows.h>
+#	include <Psapi.h>
+#else
+#	include <sys/resource.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const std::filesystem::path benchDataPath = BENCH_DATA_PATH;
+
+struct Options {
+	SyntheticCity::Config city;
+	size_t batchSize = 100; // initial shapes per generate call
+	size_t iterations = 3;
+	std::filesystem::path rpk = benchDataPath / "GenAttrs1.rpk";
+	std::string ruleFile = "bin/r1.cgb";
+	std::string startRule = "Default$Init";
+	std::filesystem::path output; // empty: stdout
+};
+
+constexpr const char* USAGE = R"(usage: palladio_bench [--option=value ...]
+  --lots=N            number of synthetic lots (default 1000)
+  --hole-density=F    fraction of lots with a courtyard hole (default 0.1)
+  --uv-sets=N         number of uv sets per lot (default 1)
+  --attributes=N      additional float attributes per lot (default 0)
+  --seed=N            seed of the lot layout (default 0)
+  --batch-size=N      initial shapes per generate call (default 100)
+  --iterations=N      number of times the whole city is generated (default 3)
+  --rpk=PATH          rule package (default: test data GenAttrs1.rpk)
+  --rule-file=KEY     rule file within the rule package (default bin/r1.cgb)
+  --start-rule=RULE   start rule (default Default$Init)
+  --output=PATH       JSON result file (default: stdout)
+)";
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+	for (int i = 1; i < argc; i++) {
+		const std::string arg = argv[i];
+		const size_t sep = arg.find('=');
+		if (arg.compare(0, 2, "--") != 0 || sep == std::string::npos)
+			return false;
+		const std::string name = arg.substr(2, sep - 2);
+		const std::string value = arg.substr(sep + 1);
+
+		if (name == "lots")
+			options.city.lots = std::stoul(value);
+		else if (name == "hole-density")
+			options.city.holeDensity = std::stod(value);
+		else if (name == "uv-sets")
+			options.city.uvSets = static_cast<uint32_t>(std::stoul(value));
+		else if (name == "attributes")
+			options.city.attributes = std::stoul(value);
+		else if (name == "seed")
+			options.city.seed = static_cast<uint32_t>(std::stoul(value));
+		else if (name == "batch-size")
+			options.batchSize = std::max<size_t>(1, std::stoul(value));
+		else if (name == "iterations")
+			options.iterations = std::max<size_t>(1, std::stoul(value));
+		else if (name == "rpk")
+			options.rpk = value;
+		else if (name == "rule-file")
+			options.ruleFile = value;
+		else if (name == "start-rule")
+			options.startRule = value;
+		else if (name == "output")
+			options.output = value;
+		else
+			return false;
+	}
+	return true;
+}
+
+uint64_t getPeakMemory() {
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS pmc;
+	if (::GetProcessMemoryInfo(::GetCurrentProcess(), &pmc, sizeof(pmc)) == 0)
+		return 0;
+	return pmc.PeakWorkingSetSize;
+#else
+	struct rusage usage;
+	if (::getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+	return static_cast<uint64_t>(usage.ru_maxrss) * 1024; // in kilobytes on linux
+#endif
+}
+
+// nearest-rank percentile of sorted values
+double getPercentile(const std::vector<double>& sortedValues, double p) {
+	if (sortedValues.empty())
+		return 0.0;
+	const size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sortedValues.size()));
+	return sortedValues[std::clamp<size_t>(rank, 1, sortedValues.size()) - 1];
+}
+
+struct Result {
+	size_t initialShapes = 0;
+	size_t generateCalls = 0;
+	size_t faces = 0;
+	double totalTime = 0.0;       // in seconds
+	std::vector<double> latencies; // per generate call in milliseconds
+};
+
+Result run(const Options& options, const SyntheticCity& city, const PRTContextUPtr& prtCtx) {
+	const std::wstring ruleFile = toUTF16FromOSNarrow(options.ruleFile);
+	const std::wstring startRule = toUTF16FromOSNarrow(options.startRule);
+
+	Result result;
+	for (size_t iteration = 0; iteration < options.iterations; iteration++) {
+		for (size_t batchStart = 0; batchStart < city.size(); batchStart += options.batchSize) {
+			const size_t batchSize = std::min(options.batchSize, city.size() - batchStart);
+			const std::vector<std::wstring> startRules(batchSize, startRule);
+			auto setup = [&city, batchStart](size_t isIdx, prt::InitialShapeBuilder& isb,
+			                                 prt::AttributeMapBuilder& isAttrs) {
+				city.setup(batchStart + isIdx, isb, isAttrs);
+			};
+
+			TestCallbacks tc;
+			const auto begin = Clock::now();
+			generate(tc, prtCtx, options.rpk, ruleFile, startRules, setup);
+			const std::chrono::duration<double> latency = Clock::now() - begin;
+
+			result.latencies.push_back(latency.count() * 1000.0);
+			result.totalTime += latency.count();
+			result.initialShapes += batchSize;
+			result.generateCalls++;
+			for (const auto& cr : tc.results)
+				result.faces += cr->cnts.size();
+		}
+	}
+	std::sort(result.latencies.begin(), result.latencies.end());
+	return result;
+}
+
+std::string toJSON(const Options& options, const Result& result) {
+	std::ostringstream out;
+	out << std::fixed << std::setprecision(3);
+	out << "{\n";
+	out << "  \"config\": {";
+	out << "\"lots\": " << options.city.lots << ", ";
+	out << "\"holeDensity\": " << options.city.holeDensity << ", ";
+	out << "\"uvSets\": " << options.city.uvSets << ", ";
+	out << "\"attributes\": " << options.city.attributes << ", ";
+	out << "\"seed\": " << options.city.seed << ", ";
+	out << "\"batchSize\": " << options.batchSize << ", ";
+	out << "\"iterations\": " << options.iterations << ", ";
+	out << "\"rpk\": \"" << options.rpk.filename().generic_string() << "\", ";
+	out << "\"startRule\": \"" << options.startRule << "\"},\n";
+	out << "  \"initialShapes\": " << result.initialShapes << ",\n";
+	out << "  \"generateCalls\": " << result.generateCalls << ",\n";
+	out << "  \"faces\": " << result.faces << ",\n";
+	out << "  \"totalTime\": " << result.totalTime << ",\n";
+	const double throughput = (result.totalTime > 0.0) ? result.initialShapes / result.totalTime : 0.0;
+	out << "  \"throughput\": " << throughput << ",\n"; // initial shapes per second
+	out << "  \"latency\": {\"unit\": \"ms\", ";
+	out << "\"min\": " << getPercentile(result.latencies, 0.0) << ", ";
+	out << "\"p50\": " << getPercentile(result.latencies, 50.0) << ", ";
+	out << "\"p90\": " << getPercentile(result.latencies, 90.0) << ", ";
+	out << "\"p99\": " << getPercentile(result.latencies, 99.0) << ", ";
+	out << "\"max\": " << getPercentile(result.latencies, 100.0) << "},\n";
+	out << "  \"peakMemory\": " << getPeakMemory() << "\n";
+	out << "}\n";
+	return out.str();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+	Options options;
+	try {
+		if (!parseOptions(argc, argv, options)) {
+			std::cerr << USAGE;
+			return 1;
+		}
+	}
+	catch (const std::logic_error&) { // invalid number
+		std::cerr << USAGE;
+		return 1;
+	}
+
+	const SyntheticCity city(options.city);
+
+	const std::vector<std::filesystem::path> addExtDirs = {BENCH_RUN_PRT_EXT_DIR, BENCH_RUN_CODEC_EXT_DIR};
+	const PRTContextUPtr prtCtx = std::make_unique<PRTContext>(addExtDirs);
+	if (!prtCtx->isAlive()) {
+		std::cerr << "Failed to initialize PRT" << std::endl;
+		return 1;
+	}
+
+	try {
+		// warm up the resolve map and rule file caches
+		Options warmUp = options;
+		warmUp.iterations = 1;
+		run(warmUp, SyntheticCity({1, 0.0, 0, 0, 0}), prtCtx);
+
+		const Result result = run(options, city, prtCtx);
+		const std::string json = toJSON(options, result);
+		if (options.output.empty()) {
+			std::cout << json;
+		}
+		else {
+			std::ofstream out(options.output);
+			out << json;
+		}
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
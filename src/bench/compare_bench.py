@@ -0,0 +1,46 @@
+import argparse
+import json
+import sys
+from pathlib import Path
+
+
+DEFAULT_THRESHOLD = 0.1 # relative slowdown flagged as regression
+
+
+def load_results(path):
+	with open(path, encoding='utf-8') as f:
+		return {b['name']: b['nsPerOp'] for b in json.load(f)['benchmarks']}
+
+
+def main():
+	parser = argparse.ArgumentParser(description='Compare palladio_microbench results against a stored baseline.')
+	parser.add_argument('baseline', type=Path, help='baseline JSON written by palladio_microbench --output')
+	parser.add_argument('current', type=Path, help='current JSON written by palladio_microbench --output')
+	parser.add_argument('--threshold', type=float, default=DEFAULT_THRESHOLD,
+						help=f'relative slowdown reported as regression (default {DEFAULT_THRESHOLD})')
+	args = parser.parse_args()
+
+	baseline = load_results(args.baseline)
+	current = load_results(args.current)
+
+	regressions = []
+	for name, ns in current.items():
+		if name not in baseline:
+			print(f'   new  {name}: {ns:.1f} ns')
+			continue
+		ratio = ns / baseline[name] if baseline[name] > 0 else 1.0
+		flag = 'SLOW' if ratio > 1.0 + args.threshold else 'FAST' if ratio < 1.0 - args.threshold else 'ok'
+		print(f'{flag:>6}  {name}: {baseline[name]:.1f} -> {ns:.1f} ns ({ratio - 1.0:+.1%})')
+		if flag == 'SLOW':
+			regressions.append(name)
+	for name in baseline.keys() - current.keys():
+		print(f'missing {name}')
+
+	if regressions:
+		print(f'>>> {len(regressions)} regression(s) above {args.threshold:.0%}')
+		return 1
+	return 0
+
+
+if __name__ == '__main__':
+	sys.exit(main())
@@ -0,0 +1,288 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "HoleConverter.h"
+#include "PRTContext.h"
+#include "Utils.h"
+#include "encoder/HoudiniEncoder.h"
+
+#include "prt/AttributeMap.h"
+#include "prtx/Geometry.h"
+#include "prtx/Material.h"
+#include "prtx/Mesh.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t SAMPLES = 5;            // the median sample is reported
+constexpr double MIN_SAMPLE_TIME = 0.05; // in seconds
+constexpr const char* FILTER_MATCH_ALL = "";
+
+// consumed results, keeps the compiler from optimizing away the benchmarked calls
+volatile size_t sink = 0;
+
+struct Benchmark {
+	std::string name;
+	std::function<void()> run;
+};
+
+struct Measurement {
+	std::string name;
+	size_t iterations = 0; // per sample
+	double nsPerOp = 0.0;
+};
+
+Measurement measure(const Benchmark& benchmark) {
+	// find the number of iterations to fill one sample
+	size_t iterations = 1;
+	while (true) {
+		const auto begin = Clock::now();
+		for (size_t i = 0; i < iterations; i++)
+			benchmark.run();
+		const std::chrono::duration<double> elapsed = Clock::now() - begin;
+		if (elapsed.count() >= MIN_SAMPLE_TIME)
+			break;
+		iterations *= 2;
+	}
+
+	std::vector<double> samples;
+	for (size_t s = 0; s < SAMPLES; s++) {
+		const auto begin = Clock::now();
+		for (size_t i = 0; i < iterations; i++)
+			benchmark.run();
+		const std::chrono::duration<double, std::nano> elapsed = Clock::now() - begin;
+		samples.push_back(elapsed.count() / iterations);
+	}
+	std::nth_element(samples.begin(), samples.begin() + SAMPLES / 2, samples.end());
+	return {benchmark.name, iterations, samples[SAMPLES / 2]};
+}
+
+// -- serializeGeometry
+
+// grid of quads with one vertex per grid point, all uv sets map the grid to the unit square
+prtx::GeometryPtr createGrid(uint32_t quads, uint32_t uvSets) {
+	const auto n = static_cast<uint32_t>(std::ceil(std::sqrt(quads)));
+
+	prtx::DoubleVector vtx;
+	prtx::DoubleVector uvs;
+	for (uint32_t z = 0; z <= n; z++) {
+		for (uint32_t x = 0; x <= n; x++) {
+			vtx.insert(vtx.end(), {static_cast<double>(x), 0.0, static_cast<double>(z)});
+			uvs.insert(uvs.end(), {static_cast<double>(x) / n, static_cast<double>(z) / n});
+		}
+	}
+
+	prtx::MeshBuilder mb;
+	mb.addVertexCoords(vtx);
+	for (uint32_t uvSet = 0; uvSet < uvSets; uvSet++)
+		mb.addUVCoords(uvSet, uvs);
+	for (uint32_t q = 0; q < quads; q++) {
+		const uint32_t i = (q / n) * (n + 1) + (q % n);
+		const prtx::IndexVector idx = {i, i + n + 1, i + n + 2, i + 1};
+		const uint32_t faceIdx = mb.addFace();
+		mb.setFaceVertexIndices(faceIdx, idx);
+		for (uint32_t uvSet = 0; uvSet < uvSets; uvSet++)
+			mb.setFaceUVIndices(faceIdx, uvSet, idx);
+	}
+
+	prtx::GeometryBuilder gb;
+	gb.addMesh(mb.createShared());
+	return gb.createShared();
+}
+
+Benchmark serializeGeometryBenchmark(uint32_t quads, uint32_t uvSets) {
+	const prtx::GeometryPtr geo = createGrid(quads, uvSets);
+	const prtx::GeometryPtrVector geos = {geo};
+	const std::vector<prtx::MaterialPtrVector> mats = {geo->getMeshes().front()->getMaterials()};
+
+	std::ostringstream name;
+	name << "serializeGeometry/faces=" << quads << "/uvSets=" << uvSets;
+	return {name.str(), [geos, mats]() {
+		        const detail::SerializedGeometry sg = detail::serializeGeometry(geos, mats);
+		        sink = sink + sg.vertexIndices.size();
+	        }};
+}
+
+// -- extractHoles
+
+// polygon with one hole, connected by a bridge edge in both directions (like houdini represents holes)
+struct BridgedPolygon : HoleConverter::EdgeSource {
+	explicit BridgedPolygon(int64_t ringSize) {
+		for (int64_t i = 0; i < ringSize; i++)
+			mVertexToPoint.push_back(i); // outer ring
+		for (int64_t i = 0; i < ringSize; i++)
+			mVertexToPoint.push_back(2 * ringSize - 1 - i); // hole ring, opposite winding
+		mVertexToPoint.push_back(2 * ringSize - 1);         // back across the bridge
+		mVertexToPoint.push_back(ringSize - 1);
+		mBridge = {ringSize - 1, 2 * ringSize - 1};
+
+		for (int64_t v = 0, num = mVertexToPoint.size(); v < num; v++)
+			mEdges.emplace_back(v, (v + 1) % num);
+	}
+
+	HoleConverter::Edges getEdges() const override {
+		return mEdges;
+	}
+
+	int64_t getPointIndex(int64_t vertexIndex) const override {
+		return mVertexToPoint[vertexIndex];
+	}
+
+	bool isBridge(int64_t pointIndexA, int64_t pointIndexB) const override {
+		return (pointIndexA == mBridge.first && pointIndexB == mBridge.second) ||
+		       (pointIndexA == mBridge.second && pointIndexB == mBridge.first);
+	}
+
+	std::vector<int64_t> mVertexToPoint;
+	HoleConverter::Edges mEdges;
+	HoleConverter::Edge mBridge;
+};
+
+Benchmark extractHolesBenchmark(int64_t ringSize) {
+	auto polygon = std::make_shared<BridgedPolygon>(ringSize);
+	return {"extractHoles/ringSize=" + std::to_string(ringSize), [polygon]() {
+		        const HoleConverter::FaceWithHoles fwh = HoleConverter::extractHoles(*polygon);
+		        sink = sink + fwh.size();
+	        }};
+}
+
+// -- convertMaterialToAttributeMap
+
+Benchmark convertMaterialBenchmark() {
+	// the default material carries the full set of CGA material keys
+	const prtx::GeometryPtr geo = createGrid(1, 0);
+	const prtx::MaterialPtr mat = geo->getMeshes().front()->getMaterials().front();
+	auto amb = std::make_shared<prtx::PRTUtils::AttributeMapBuilderPtr>(prt::AttributeMapBuilder::create());
+
+	return {"convertMaterialToAttributeMap/default", [mat, amb]() {
+		        detail::convertMaterialToAttributeMap(*amb, *mat, mat->getKeys());
+		        const AttributeMapUPtr am((*amb)->createAttributeMapAndReset());
+		        size_t keyCount = 0;
+		        am->getKeys(&keyCount);
+		        sink = sink + keyCount;
+	        }};
+}
+
+// -- string conversions
+
+Benchmark utf16ToNarrowBenchmark(size_t length) {
+	const std::wstring s(length, L'x');
+	return {"toOSNarrowFromUTF16/length=" + std::to_string(length),
+	        [s]() { sink = sink + toOSNarrowFromUTF16(s).size(); }};
+}
+
+Benchmark narrowToUTF16Benchmark(size_t length) {
+	const std::string s(length, 'x');
+	return {"toUTF16FromOSNarrow/length=" + std::to_string(length),
+	        [s]() { sink = sink + toUTF16FromOSNarrow(s).size(); }};
+}
+
+std::vector<Benchmark> createBenchmarks() {
+	std::vector<Benchmark> benchmarks;
+	for (uint32_t quads : {16, 1024, 65536}) {
+		for (uint32_t uvSets : {0, 1, 4})
+			benchmarks.push_back(serializeGeometryBenchmark(quads, uvSets));
+	}
+	for (int64_t ringSize : {4, 64, 4096})
+		benchmarks.push_back(extractHolesBenchmark(ringSize));
+	benchmarks.push_back(convertMaterialBenchmark());
+	for (size_t length : {16, 256, 4096}) {
+		benchmarks.push_back(utf16ToNarrowBenchmark(length));
+		benchmarks.push_back(narrowToUTF16Benchmark(length));
+	}
+	return benchmarks;
+}
+
+std::string toJSON(const std::vector<Measurement>& measurements) {
+	std::ostringstream out;
+	out << std::fixed << std::setprecision(1);
+	out << "{\n  \"benchmarks\": [";
+	for (size_t i = 0; i < measurements.size(); i++) {
+		const Measurement& m = measurements[i];
+		out << ((i > 0) ? "," : "") << "\n    {\"name\": \"" << m.name << "\", \"iterations\": " << m.iterations
+		    << ", \"nsPerOp\": " << m.nsPerOp << "}";
+	}
+	out << "\n  ]\n}\n";
+	return out.str();
+}
+
+constexpr const char* USAGE = R"(usage: palladio_microbench [--filter=SUBSTRING] [--output=PATH]
+  --filter=SUBSTRING  only run the benchmarks whose name contains SUBSTRING
+  --output=PATH       JSON result file (default: stdout), compare against a baseline with compare_bench.py
+)";
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+	std::string filter = FILTER_MATCH_ALL;
+	std::string output;
+	for (int i = 1; i < argc; i++) {
+		const std::string arg = argv[i];
+		if (arg.rfind("--filter=", 0) == 0)
+			filter = arg.substr(std::strlen("--filter="));
+		else if (arg.rfind("--output=", 0) == 0)
+			output = arg.substr(std::strlen("--output="));
+		else {
+			std::cerr << USAGE;
+			return 1;
+		}
+	}
+
+	// the prtx builders need an initialized PRT
+	const std::vector<std::filesystem::path> addExtDirs = {BENCH_RUN_PRT_EXT_DIR, BENCH_RUN_CODEC_EXT_DIR};
+	PRTContextUPtr prtCtx = std::make_unique<PRTContext>(addExtDirs);
+	if (!prtCtx->isAlive()) {
+		std::cerr << "Failed to initialize PRT" << std::endl;
+		return 1;
+	}
+
+	std::vector<Measurement> measurements;
+	{
+		const std::vector<Benchmark> benchmarks = createBenchmarks(); // holds prtx objects, release before PRT
+		for (const Benchmark& b : benchmarks) {
+			if (b.name.find(filter) == std::string::npos)
+				continue;
+			measurements.push_back(measure(b));
+			std::cerr << measurements.back().name << ": " << measurements.back().nsPerOp << " ns" << std::endl;
+		}
+	}
+	prtCtx.reset();
+
+	const std::string json = toJSON(measurements);
+	if (output.empty()) {
+		std::cout << json;
+	}
+	else {
+		std::ofstream out(output);
+		out << json;
+	}
+	return 0;
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TestCallbacks.h"
+
+#include "CallbackRecording.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr const char* USAGE = R"(usage: palladio_replay RECORDING [--iterations=N]
+  replays a callback recording (see CITYENGINE_RECORD_CALLBACKS_DIR) into a sink which copies all data
+  --iterations=N      number of replays, the fastest is reported (default 3)
+)";
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+	std::filesystem::path recording;
+	size_t iterations = 3;
+	try {
+		for (int i = 1; i < argc; i++) {
+			const std::string arg = argv[i];
+			if (arg.rfind("--iterations=", 0) == 0)
+				iterations = std::max<size_t>(1, std::stoul(arg.substr(std::strlen("--iterations="))));
+			else if (arg.rfind("--", 0) != 0 && recording.empty())
+				recording = arg;
+			else
+				throw std::invalid_argument(arg);
+		}
+	}
+	catch (const std::logic_error&) {
+		std::cerr << USAGE;
+		return 1;
+	}
+	if (recording.empty()) {
+		std::cerr << USAGE;
+		return 1;
+	}
+
+	try {
+		double fastest = 0.0;
+		for (size_t i = 0; i < iterations; i++) {
+			// one sink per recorded stream, i.e. per generate thread of the recorded cook
+			std::map<uint32_t, TestCallbacks> sinks;
+			const auto begin = Clock::now();
+			const size_t calls = replayCallbacks(
+			        recording, [&sinks](uint32_t stream) -> HoudiniCallbacks& { return sinks[stream]; });
+			const std::chrono::duration<double> elapsed = Clock::now() - begin;
+			fastest = (i == 0) ? elapsed.count() : std::min(fastest, elapsed.count());
+
+			size_t meshes = 0;
+			size_t faces = 0;
+			for (const auto& [stream, sink] : sinks) {
+				meshes += sink.results.size();
+				for (const auto& cr : sink.results)
+					faces += cr->cnts.size();
+			}
+			std::cout << std::fixed << std::setprecision(3) << "replay " << i << ": " << calls << " calls, "
+			          << sinks.size() << " streams, " << meshes << " meshes, " << faces << " faces in "
+			          << elapsed.count() << " s" << std::endl;
+		}
+		std::cout << "fastest: " << fastest << " s" << std::endl;
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TestCallbacks.h"
+
+#include "HeadlessGenerate.h"
+#include "PRTContext.h"
+#include "SceneCapture.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr const char* USAGE = R"(usage: palladio_scene SCENE [--threads=N] [--iterations=N]
+  reruns the generate workload of a scene capture (see CITYENGINE_CAPTURE_SCENE_DIR)
+  --threads=N         number of concurrent generate calls (default: number of cores, like the generate node)
+  --iterations=N      number of runs, the fastest is reported (default 3)
+)";
+
+struct Result {
+	size_t failedCalls = 0;
+	size_t meshes = 0;
+	size_t faces = 0;
+};
+
+Result run(const InitialShapeNOPtrVector& is, const GenerateSetup& setup, PRTContext& prtCtx, size_t nThreads) {
+	std::vector<TestCallbacks> callbacks(nThreads);
+	std::vector<prt::Callbacks*> callbackPtrs;
+	for (TestCallbacks& tc : callbacks)
+		callbackPtrs.push_back(&tc);
+
+	Result result;
+	result.failedCalls = generateHeadless(is, setup, callbackPtrs, prtCtx.mPRTCache.get());
+	for (const TestCallbacks& tc : callbacks) {
+		result.meshes += tc.results.size();
+		for (const auto& cr : tc.results)
+			result.faces += cr->cnts.size();
+	}
+	return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+	std::filesystem::path sceneFile;
+	size_t threads = 0;
+	size_t iterations = 3;
+	try {
+		for (int i = 1; i < argc; i++) {
+			const std::string arg = argv[i];
+			if (arg.rfind("--threads=", 0) == 0)
+				threads = std::stoul(arg.substr(std::strlen("--threads=")));
+			else if (arg.rfind("--iterations=", 0) == 0)
+				iterations = std::max<size_t>(1, std::stoul(arg.substr(std::strlen("--iterations="))));
+			else if (arg.rfind("--", 0) != 0 && sceneFile.empty())
+				sceneFile = arg;
+			else
+				throw std::invalid_argument(arg);
+		}
+	}
+	catch (const std::logic_error&) {
+		std::cerr << USAGE;
+		return 1;
+	}
+	if (sceneFile.empty()) {
+		std::cerr << USAGE;
+		return 1;
+	}
+
+	const std::vector<std::filesystem::path> addExtDirs = {BENCH_RUN_PRT_EXT_DIR, BENCH_RUN_CODEC_EXT_DIR};
+	PRTContextUPtr prtCtx = std::make_unique<PRTContext>(addExtDirs);
+	if (!prtCtx->isAlive()) {
+		std::cerr << "Failed to initialize PRT" << std::endl;
+		return 1;
+	}
+
+	int exitCode = 0;
+	try {
+		const CapturedScene scene = readScene(sceneFile);
+		if (scene.shapes.empty())
+			throw std::runtime_error("scene capture contains no initial shapes");
+		const std::vector<InitialShapeUPtr> initialShapes = createInitialShapes(scene.shapes, *prtCtx);
+		InitialShapeNOPtrVector is;
+		for (const auto& initialShape : initialShapes)
+			is.push_back(initialShape.get());
+		const GenerateSetup setup = getGenerateSetup(scene);
+
+		if (threads == 0)
+			threads = prtCtx->mCores;
+		threads = std::clamp<size_t>(threads, 1, is.size());
+
+		double fastest = 0.0;
+		for (size_t i = 0; i < iterations; i++) {
+			const auto begin = Clock::now();
+			const Result result = run(is, setup, *prtCtx, threads);
+			const std::chrono::duration<double> elapsed = Clock::now() - begin;
+			fastest = (i == 0) ? elapsed.count() : std::min(fastest, elapsed.count());
+
+			std::cout << std::fixed << std::setprecision(3) << "run " << i << ": " << is.size()
+			          << " initial shapes on " << threads << " threads, " << result.meshes << " meshes, "
+			          << result.faces << " faces in " << elapsed.count() << " s" << std::endl;
+			if (result.failedCalls > 0) {
+				std::cerr << result.failedCalls << " generate calls failed" << std::endl;
+				exitCode = 1;
+			}
+		}
+		std::cout << "fastest: " << fastest << " s" << std::endl;
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		exitCode = 1;
+	}
+
+	prtCtx.reset();
+	return exitCode;
+}
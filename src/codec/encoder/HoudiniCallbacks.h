@@ -28,6 +28,12 @@ class HoudiniCallbacks : public prt::Callbacks {
 public:
 	~HoudiniCallbacks() override = default;
 
+	/**
+	 * called before the add call of each initial shape
+	 * @param isIndex index of the initial shape in the initial shapes of the generate call
+	 */
+	virtual void beginInitialShape(size_t isIndex) {}
+
 	/**
 	 * @param name initial shape (primitive group) name, optionally used to create primitive groups on output
 	 * @param vtx vertex coordinate array
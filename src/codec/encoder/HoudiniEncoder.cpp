@@ -148,91 +148,6 @@ const std::set<std::wstring> MATERIAL_ATTRIBUTE_BLACKLIST = {
 #endif
 };
 
-void convertMaterialToAttributeMap(prtx::PRTUtils::AttributeMapBuilderPtr& aBuilder, const prtx::Material& prtxAttr,
-                                   const prtx::WStringVector& keys) {
-	if constexpr (DBG)
-		log_debug(L"-- converting material: %1%") % prtxAttr.name();
-	for (const auto& key : keys) {
-		if (MATERIAL_ATTRIBUTE_BLACKLIST.count(key) > 0)
-			continue;
-
-		if constexpr (DBG)
-			log_debug(L"   key: %1%") % key;
-
-		switch (prtxAttr.getType(key)) {
-			case prt::Attributable::PT_BOOL:
-				aBuilder->setBool(key.c_str(), prtxAttr.getBool(key) == prtx::PRTX_TRUE);
-				break;
-
-			case prt::Attributable::PT_FLOAT:
-				aBuilder->setFloat(key.c_str(), prtxAttr.getFloat(key));
-				break;
-
-			case prt::Attributable::PT_INT:
-				aBuilder->setInt(key.c_str(), prtxAttr.getInt(key));
-				break;
-
-			case prt::Attributable::PT_STRING: {
-				const std::wstring& v = prtxAttr.getString(key); // explicit copy
-				aBuilder->setString(key.c_str(), v.c_str());     // also passing on empty strings
-				break;
-			}
-
-			case prt::Attributable::PT_BOOL_ARRAY: {
-				const std::vector<uint8_t>& ba = prtxAttr.getBoolArray(key);
-				auto boo = std::unique_ptr<bool[]>(new bool[ba.size()]);
-				for (size_t i = 0; i < ba.size(); i++)
-					boo[i] = (ba[i] == prtx::PRTX_TRUE);
-				aBuilder->setBoolArray(key.c_str(), boo.get(), ba.size());
-				break;
-			}
-
-			case prt::Attributable::PT_INT_ARRAY: {
-				const std::vector<int32_t>& array = prtxAttr.getIntArray(key);
-				aBuilder->setIntArray(key.c_str(), &array[0], array.size());
-				break;
-			}
-
-			case prt::Attributable::PT_FLOAT_ARRAY: {
-				const std::vector<double>& array = prtxAttr.getFloatArray(key);
-				aBuilder->setFloatArray(key.c_str(), array.data(), array.size());
-				break;
-			}
-
-			case prt::Attributable::PT_STRING_ARRAY: {
-				const prtx::WStringVector& a = prtxAttr.getStringArray(key);
-				std::vector<const wchar_t*> pw = toPtrVec(a);
-				aBuilder->setStringArray(key.c_str(), pw.data(), pw.size());
-				break;
-			}
-
-			case prtx::Material::PT_TEXTURE: {
-				const auto& t = prtxAttr.getTexture(key);
-				const std::wstring p = t->getURI()->wstring();
-				aBuilder->setString(key.c_str(), p.c_str());
-				break;
-			}
-
-			case prtx::Material::PT_TEXTURE_ARRAY: {
-				const auto& ta = prtxAttr.getTextureArray(key);
-
-				prtx::WStringVector pa(ta.size());
-				std::transform(ta.begin(), ta.end(), pa.begin(),
-				               [](const prtx::TexturePtr& t) { return t->getURI()->wstring(); });
-
-				std::vector<const wchar_t*> ppa = toPtrVec(pa);
-				aBuilder->setStringArray(key.c_str(), ppa.data(), ppa.size());
-				break;
-			}
-
-			default:
-				if constexpr (DBG)
-					log_debug(L"ignored atttribute '%s' with type %d") % key % prtxAttr.getType(key);
-				break;
-		}
-	}
-}
-
 void convertReportsToAttributeMap(prtx::PRTUtils::AttributeMapBuilderPtr& amb, const prtx::ReportsPtr& r) {
 	if (!r)
 		return;
@@ -369,6 +284,91 @@ const prtx::IndexVector EMPTY_IDX;
 
 namespace detail {
 
+void convertMaterialToAttributeMap(prtx::PRTUtils::AttributeMapBuilderPtr& aBuilder, const prtx::Material& prtxAttr,
+                                   const prtx::WStringVector& keys) {
+	if constexpr (DBG)
+		log_debug(L"-- converting material: %1%") % prtxAttr.name();
+	for (const auto& key : keys) {
+		if (MATERIAL_ATTRIBUTE_BLACKLIST.count(key) > 0)
+			continue;
+
+		if constexpr (DBG)
+			log_debug(L"   key: %1%") % key;
+
+		switch (prtxAttr.getType(key)) {
+			case prt::Attributable::PT_BOOL:
+				aBuilder->setBool(key.c_str(), prtxAttr.getBool(key) == prtx::PRTX_TRUE);
+				break;
+
+			case prt::Attributable::PT_FLOAT:
+				aBuilder->setFloat(key.c_str(), prtxAttr.getFloat(key));
+				break;
+
+			case prt::Attributable::PT_INT:
+				aBuilder->setInt(key.c_str(), prtxAttr.getInt(key));
+				break;
+
+			case prt::Attributable::PT_STRING: {
+				const std::wstring& v = prtxAttr.getString(key); // explicit copy
+				aBuilder->setString(key.c_str(), v.c_str());     // also passing on empty strings
+				break;
+			}
+
+			case prt::Attributable::PT_BOOL_ARRAY: {
+				const std::vector<uint8_t>& ba = prtxAttr.getBoolArray(key);
+				auto boo = std::unique_ptr<bool[]>(new bool[ba.size()]);
+				for (size_t i = 0; i < ba.size(); i++)
+					boo[i] = (ba[i] == prtx::PRTX_TRUE);
+				aBuilder->setBoolArray(key.c_str(), boo.get(), ba.size());
+				break;
+			}
+
+			case prt::Attributable::PT_INT_ARRAY: {
+				const std::vector<int32_t>& array = prtxAttr.getIntArray(key);
+				aBuilder->setIntArray(key.c_str(), &array[0], array.size());
+				break;
+			}
+
+			case prt::Attributable::PT_FLOAT_ARRAY: {
+				const std::vector<double>& array = prtxAttr.getFloatArray(key);
+				aBuilder->setFloatArray(key.c_str(), array.data(), array.size());
+				break;
+			}
+
+			case prt::Attributable::PT_STRING_ARRAY: {
+				const prtx::WStringVector& a = prtxAttr.getStringArray(key);
+				std::vector<const wchar_t*> pw = toPtrVec(a);
+				aBuilder->setStringArray(key.c_str(), pw.data(), pw.size());
+				break;
+			}
+
+			case prtx::Material::PT_TEXTURE: {
+				const auto& t = prtxAttr.getTexture(key);
+				const std::wstring p = t->getURI()->wstring();
+				aBuilder->setString(key.c_str(), p.c_str());
+				break;
+			}
+
+			case prtx::Material::PT_TEXTURE_ARRAY: {
+				const auto& ta = prtxAttr.getTextureArray(key);
+
+				prtx::WStringVector pa(ta.size());
+				std::transform(ta.begin(), ta.end(), pa.begin(),
+				               [](const prtx::TexturePtr& t) { return t->getURI()->wstring(); });
+
+				std::vector<const wchar_t*> ppa = toPtrVec(pa);
+				aBuilder->setStringArray(key.c_str(), ppa.data(), ppa.size());
+				break;
+			}
+
+			default:
+				if constexpr (DBG)
+					log_debug(L"ignored atttribute '%s' with type %d") % key % prtxAttr.getType(key);
+				break;
+		}
+	}
+}
+
 SerializedGeometry serializeGeometry(const prtx::GeometryPtrVector& geometries,
                                      const std::vector<prtx::MaterialPtrVector>& materials) {
 	// PASS 1: scan
@@ -552,6 +552,7 @@ void HoudiniEncoder::encode(prtx::GenerateContext& context, size_t initialShapeI
 
 	prtx::EncodePreparator::InstanceVector instances;
 	encPrep->fetchFinalizedInstances(instances, encodePreparatorFlags);
+	cb->beginInitialShape(initialShapeIndex);
 	convertGeometry(initialShape, instances, cb);
 }
 
@@ -604,7 +605,7 @@ void HoudiniEncoder::convertGeometry(const prtx::InitialShape& initialShape,
 			faceRanges.push_back(faceCount);
 
 			if (emitMaterials) {
-				convertMaterialToAttributeMap(amb, *(mat.get()), mat->getKeys());
+				detail::convertMaterialToAttributeMap(amb, *(mat.get()), mat->getKeys());
 				matAttrMaps.v.push_back(amb->createAttributeMapAndReset());
 			}
 
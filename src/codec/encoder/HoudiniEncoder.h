@@ -68,6 +68,10 @@ struct SerializedGeometry {
 CODEC_EXPORTS_API SerializedGeometry serializeGeometry(const prtx::GeometryPtrVector& geometries,
                                                        const std::vector<prtx::MaterialPtrVector>& materials);
 
+// visible for tests
+CODEC_EXPORTS_API void convertMaterialToAttributeMap(prtx::PRTUtils::AttributeMapBuilderPtr& aBuilder,
+                                                     const prtx::Material& prtxAttr, const prtx::WStringVector& keys);
+
 } // namespace detail
 
 class HoudiniEncoder : public prtx::GeometryEncoder {
@@ -17,7 +17,7 @@
 #include "AttributeConversion.h"
 #include "LRUCache.h"
 #include "LogHandler.h"
-#include "MultiWatch.h"
+#include "Tracing.h"
 
 #include <bitset>
 #include <mutex>
@@ -320,7 +320,7 @@ const GA_Defaults GA_DEFAULT(0);
 } // namespace
 
 void ToHoudini::createAttributeHandles(bool useArrayTypes) {
-	WA("all");
+	PLD_TRACE_SCOPE("attribute handles");
 
 	for (auto& hm : mHandleMap) {
 		const auto& utKey = hm.first;
@@ -418,8 +418,6 @@ void ToHoudini::setAttributeValues(const prt::AttributeMap* attrMap, const GA_In
 }
 
 void ToHoudini::addProtoHandle(HandleMap& handleMap, const std::wstring& handleName, ProtoHandle&& ph) {
-	WA("all");
-
 	const UT_StringHolder& utName = NameConversion::toPrimAttr(handleName);
 	if constexpr (DBG)
 		LOG_DBG << "handle name conversion: handleName = " << handleName << ", utName = " << utName;
@@ -526,8 +524,6 @@ std::wstring removeGroups(const std::wstring& fullyQualifiedAttrName) {
 }
 
 UT_String toPrimAttr(const std::wstring& fullyQualifiedAttrName) {
-	WA("all");
-
 	const auto cv = StringConversionCaches::toPrimAttr.get(fullyQualifiedAttrName);
 	if (cv)
 		return cv.value();
@@ -542,8 +538,6 @@ UT_String toPrimAttr(const std::wstring& fullyQualifiedAttrName) {
 }
 
 std::wstring toRuleAttr(const std::wstring& style, const UT_StringHolder& attrName) {
-	WA("all");
-
 	std::string s = attrName.toStdString();
 
 	UT_StringHolder ruleAttr(s);
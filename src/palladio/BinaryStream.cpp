@@ -0,0 +1,201 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BinaryStream.h"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+constexpr uint64_t MAX_ARRAY_SIZE = uint64_t(1) << 40; // guards allocations against corrupt sizes
+
+} // namespace
+
+namespace BinaryStream {
+
+void writeHeader(std::ostream& out, const Magic& magic, uint32_t version) {
+	out.write(magic, sizeof(Magic));
+	write(out, version);
+}
+
+void writeString(std::ostream& out, const wchar_t* s) {
+	const std::string utf8 = (s != nullptr) ? toUTF8FromUTF16(s) : std::string();
+	writeArray(out, utf8.data(), utf8.size());
+}
+
+void writeStringArray(std::ostream& out, const wchar_t* const* ptr, size_t size) {
+	write<uint64_t>(out, size);
+	for (size_t i = 0; i < size; i++)
+		writeString(out, ptr[i]);
+}
+
+void writeBoolArray(std::ostream& out, const bool* ptr, size_t size) {
+	write<uint64_t>(out, size);
+	for (size_t i = 0; i < size; i++)
+		write<uint8_t>(out, ptr[i] ? 1 : 0);
+}
+
+void writeAttributeMap(std::ostream& out, const prt::AttributeMap* am) {
+	size_t keyCount = 0;
+	const wchar_t* const* keys = am->getKeys(&keyCount);
+	write<uint64_t>(out, keyCount);
+	for (size_t k = 0; k < keyCount; k++) {
+		const wchar_t* key = keys[k];
+		const prt::Attributable::PrimitiveType type = am->getType(key);
+		writeString(out, key);
+		write<uint8_t>(out, static_cast<uint8_t>(type));
+		size_t size = 0;
+		switch (type) {
+			case prt::Attributable::PT_BOOL:
+				write<uint8_t>(out, am->getBool(key) ? 1 : 0);
+				break;
+			case prt::Attributable::PT_FLOAT:
+				write<double>(out, am->getFloat(key));
+				break;
+			case prt::Attributable::PT_INT:
+				write<int32_t>(out, am->getInt(key));
+				break;
+			case prt::Attributable::PT_STRING:
+				writeString(out, am->getString(key));
+				break;
+			case prt::Attributable::PT_BOOL_ARRAY: {
+				const bool* a = am->getBoolArray(key, &size);
+				writeBoolArray(out, a, size);
+				break;
+			}
+			case prt::Attributable::PT_FLOAT_ARRAY: {
+				const double* a = am->getFloatArray(key, &size);
+				writeArray(out, a, size);
+				break;
+			}
+			case prt::Attributable::PT_INT_ARRAY: {
+				const int32_t* a = am->getIntArray(key, &size);
+				writeArray(out, a, size);
+				break;
+			}
+			case prt::Attributable::PT_STRING_ARRAY: {
+				const wchar_t* const* a = am->getStringArray(key, &size);
+				writeStringArray(out, a, size);
+				break;
+			}
+			default: // no payload, dropped when reading
+				break;
+		}
+	}
+}
+
+Reader::Reader(const std::filesystem::path& file, const std::string& fileKind)
+    : mFile(file), mFileKind(fileKind), mIn(file, std::ifstream::binary) {
+	if (!mIn)
+		throw std::runtime_error("cannot open " + fileKind + " " + file.string());
+}
+
+void Reader::readHeader(const Magic& magic, uint32_t version) {
+	Magic fileMagic;
+	readBytes(fileMagic, sizeof(Magic));
+	if (std::memcmp(fileMagic, magic, sizeof(Magic)) != 0)
+		throw std::runtime_error("not a " + mFileKind + ": " + mFile.string());
+	const auto fileVersion = read<uint32_t>();
+	if (fileVersion != version)
+		throw std::runtime_error("unsupported " + mFileKind + " version " + std::to_string(fileVersion));
+}
+
+std::wstring Reader::readString() {
+	const std::vector<char> utf8 = readArray<char>();
+	return toUTF16FromUTF8(std::string(utf8.begin(), utf8.end()));
+}
+
+std::vector<std::wstring> Reader::readStringArray() {
+	std::vector<std::wstring> v(readSize());
+	for (auto& s : v)
+		s = readString();
+	return v;
+}
+
+std::unique_ptr<bool[]> Reader::readBoolArray(size_t& size) {
+	size = readSize();
+	auto v = std::make_unique<bool[]>(size);
+	for (size_t i = 0; i < size; i++)
+		v[i] = (read<uint8_t>() != 0);
+	return v;
+}
+
+AttributeMapUPtr Reader::readAttributeMap() {
+	AttributeMapBuilderUPtr amb(prt::AttributeMapBuilder::create());
+	const uint64_t keyCount = read<uint64_t>();
+	for (uint64_t k = 0; k < keyCount; k++) {
+		const std::wstring key = readString();
+		const auto type = static_cast<prt::Attributable::PrimitiveType>(read<uint8_t>());
+		switch (type) {
+			case prt::Attributable::PT_BOOL:
+				amb->setBool(key.c_str(), read<uint8_t>() != 0);
+				break;
+			case prt::Attributable::PT_FLOAT:
+				amb->setFloat(key.c_str(), read<double>());
+				break;
+			case prt::Attributable::PT_INT:
+				amb->setInt(key.c_str(), read<int32_t>());
+				break;
+			case prt::Attributable::PT_STRING:
+				amb->setString(key.c_str(), readString().c_str());
+				break;
+			case prt::Attributable::PT_BOOL_ARRAY: {
+				size_t size = 0;
+				const std::unique_ptr<bool[]> a = readBoolArray(size);
+				amb->setBoolArray(key.c_str(), a.get(), size);
+				break;
+			}
+			case prt::Attributable::PT_FLOAT_ARRAY: {
+				const std::vector<double> a = readArray<double>();
+				amb->setFloatArray(key.c_str(), a.data(), a.size());
+				break;
+			}
+			case prt::Attributable::PT_INT_ARRAY: {
+				const std::vector<int32_t> a = readArray<int32_t>();
+				amb->setIntArray(key.c_str(), a.data(), a.size());
+				break;
+			}
+			case prt::Attributable::PT_STRING_ARRAY: {
+				const std::vector<std::wstring> a = readStringArray();
+				const std::vector<const wchar_t*> pa = toPtrVec(a);
+				amb->setStringArray(key.c_str(), pa.data(), pa.size());
+				break;
+			}
+			default:
+				break;
+		}
+	}
+	return AttributeMapUPtr(amb->createAttributeMap());
+}
+
+void Reader::fail(const std::string& what) const {
+	throw std::runtime_error(what + " " + mFileKind + " " + mFile.string());
+}
+
+size_t Reader::readSize() {
+	const auto size = read<uint64_t>();
+	if (size > MAX_ARRAY_SIZE)
+		fail();
+	return static_cast<size_t>(size);
+}
+
+void Reader::readBytes(char* dst, size_t size) {
+	if (!mIn.read(dst, size))
+		fail();
+}
+
+} // namespace BinaryStream
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Utils.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * helpers for the binary palladio files (callback recordings, scene captures). all values are written in native byte
+ * order, strings as UTF-8 (wchar_t differs in size between the platforms).
+ */
+namespace BinaryStream {
+
+using Magic = char[8];
+
+template <typename T>
+void write(std::ostream& out, const T& v) {
+	out.write(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+template <typename T>
+void writeArray(std::ostream& out, const T* data, size_t size) {
+	write<uint64_t>(out, size);
+	if (size > 0)
+		out.write(reinterpret_cast<const char*>(data), size * sizeof(T));
+}
+
+void writeHeader(std::ostream& out, const Magic& magic, uint32_t version);
+void writeString(std::ostream& out, const wchar_t* s);
+void writeStringArray(std::ostream& out, const wchar_t* const* ptr, size_t size);
+void writeBoolArray(std::ostream& out, const bool* ptr, size_t size);
+void writeAttributeMap(std::ostream& out, const prt::AttributeMap* am);
+
+/**
+ * reads the values in the order they were written, throws std::runtime_error on a truncated or corrupt file
+ */
+class Reader {
+public:
+	/**
+	 * fileKind names the file in error messages, e.g. "callback recording"
+	 */
+	Reader(const std::filesystem::path& file, const std::string& fileKind);
+
+	/**
+	 * checks the magic bytes and the version written by writeHeader
+	 */
+	void readHeader(const Magic& magic, uint32_t version);
+
+	bool atEnd() {
+		return mIn.peek() == std::ifstream::traits_type::eof();
+	}
+
+	template <typename T>
+	T read() {
+		T v;
+		readBytes(reinterpret_cast<char*>(&v), sizeof(T));
+		return v;
+	}
+
+	template <typename T>
+	std::vector<T> readArray() {
+		std::vector<T> v(readSize());
+		if (!v.empty())
+			readBytes(reinterpret_cast<char*>(v.data()), v.size() * sizeof(T));
+		return v;
+	}
+
+	std::wstring readString();
+	std::vector<std::wstring> readStringArray();
+
+	// std::vector<bool> cannot be passed on as array
+	std::unique_ptr<bool[]> readBoolArray(size_t& size);
+
+	AttributeMapUPtr readAttributeMap();
+
+	[[noreturn]] void fail(const std::string& what = "truncated or corrupt") const;
+
+private:
+	size_t readSize();
+	void readBytes(char* dst, size_t size);
+
+	const std::filesystem::path mFile;
+	const std::string mFileKind;
+	std::ifstream mIn;
+};
+
+} // namespace BinaryStream
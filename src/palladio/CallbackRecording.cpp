@@ -0,0 +1,354 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CallbackRecording.h"
+#include "BinaryStream.h"
+#include "LogHandler.h"
+#include "Utils.h"
+
+#include "prt/AttributeMap.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+using namespace BinaryStream;
+
+constexpr const char* RECORD_CALLBACKS_DIR_ENV_VAR = "CITYENGINE_RECORD_CALLBACKS_DIR";
+constexpr const char* RECORDING_FILE_EXT = ".pldrec";
+constexpr BinaryStream::Magic RECORDING_MAGIC = {'P', 'L', 'D', 'R', 'E', 'C', '\0', '\0'};
+constexpr uint32_t RECORDING_VERSION = 2; // 2: stream of the recorder in every record
+constexpr const char* RECORDING_FILE_KIND = "callback recording";
+
+enum class RecordType : uint8_t {
+	ADD = 1,
+	ATTR_BOOL,
+	ATTR_FLOAT,
+	ATTR_STRING,
+	ATTR_BOOL_ARRAY,
+	ATTR_FLOAT_ARRAY,
+	ATTR_STRING_ARRAY,
+	GENERATE_ERROR
+};
+
+// -- writing
+
+void writeAttributeMaps(std::ostream& out, const prt::AttributeMap** maps, size_t count) {
+	write<uint8_t>(out, (maps != nullptr) ? 1 : 0);
+	if (maps != nullptr) {
+		for (size_t i = 0; i < count; i++)
+			writeAttributeMap(out, maps[i]);
+	}
+}
+
+void writeRecordHeader(std::ostream& out, RecordType type, uint32_t stream) {
+	write(out, type);
+	write<uint32_t>(out, stream);
+}
+
+void writeAttrHeader(std::ostream& out, RecordType type, uint32_t stream, size_t isIndex, int32_t shapeID,
+                     const wchar_t* key) {
+	writeRecordHeader(out, type, stream);
+	write<uint64_t>(out, isIndex);
+	write<int32_t>(out, shapeID);
+	writeString(out, key);
+}
+
+// -- reading
+
+AttributeMapVector readAttributeMaps(Reader& reader, size_t count) {
+	AttributeMapVector maps;
+	if (reader.read<uint8_t>() != 0) {
+		for (size_t i = 0; i < count; i++)
+			maps.emplace_back(reader.readAttributeMap());
+	}
+	return maps;
+}
+
+template <typename T>
+std::pair<std::vector<const T*>, std::vector<size_t>> toPtrVecWithSizes(const std::vector<std::vector<T>>& v) {
+	std::vector<const T*> pv(v.size());
+	std::vector<size_t> ps(v.size());
+	for (size_t i = 0; i < v.size(); i++) {
+		pv[i] = v[i].data();
+		ps[i] = v[i].size();
+	}
+	return {pv, ps};
+}
+
+std::vector<const prt::AttributeMap*> toPtrVec(const AttributeMapVector& maps) {
+	std::vector<const prt::AttributeMap*> pv(maps.size());
+	for (size_t i = 0; i < maps.size(); i++)
+		pv[i] = maps[i].get();
+	return pv;
+}
+
+void replayAdd(Reader& reader, HoudiniCallbacks& sink) {
+	const std::wstring name = reader.readString();
+	const std::vector<double> vtx = reader.readArray<double>();
+	const std::vector<double> nrm = reader.readArray<double>();
+	const std::vector<uint32_t> counts = reader.readArray<uint32_t>();
+	const std::vector<uint32_t> holeCounts = reader.readArray<uint32_t>();
+	const std::vector<uint32_t> holeIndices = reader.readArray<uint32_t>();
+	const std::vector<uint32_t> vertexIndices = reader.readArray<uint32_t>();
+	const std::vector<uint32_t> normalIndices = reader.readArray<uint32_t>();
+
+	const auto uvSets = reader.read<uint32_t>();
+	std::vector<std::vector<double>> uvs(uvSets);
+	std::vector<std::vector<uint32_t>> uvCounts(uvSets);
+	std::vector<std::vector<uint32_t>> uvIndices(uvSets);
+	for (uint32_t uvSet = 0; uvSet < uvSets; uvSet++) {
+		uvs[uvSet] = reader.readArray<double>();
+		uvCounts[uvSet] = reader.readArray<uint32_t>();
+		uvIndices[uvSet] = reader.readArray<uint32_t>();
+	}
+	const auto puvs = toPtrVecWithSizes(uvs);
+	const auto puvCounts = toPtrVecWithSizes(uvCounts);
+	const auto puvIndices = toPtrVecWithSizes(uvIndices);
+
+	const std::vector<uint32_t> faceRanges = reader.readArray<uint32_t>();
+	const size_t rangeCount = faceRanges.empty() ? 0 : faceRanges.size() - 1;
+	const AttributeMapVector materials = readAttributeMaps(reader, rangeCount);
+	const AttributeMapVector reports = readAttributeMaps(reader, rangeCount);
+	const std::vector<int32_t> shapeIDs = reader.readArray<int32_t>();
+
+	std::vector<const prt::AttributeMap*> pMaterials = toPtrVec(materials);
+	std::vector<const prt::AttributeMap*> pReports = toPtrVec(reports);
+
+	sink.add(name.c_str(), vtx.data(), vtx.size(), nrm.data(), nrm.size(), counts.data(), counts.size(),
+	         holeCounts.data(), holeCounts.size(), holeIndices.data(), holeIndices.size(), vertexIndices.data(),
+	         vertexIndices.size(), normalIndices.data(), normalIndices.size(), puvs.first.data(), puvs.second.data(),
+	         puvCounts.first.data(), puvCounts.second.data(), puvIndices.first.data(), puvIndices.second.data(), uvSets,
+	         faceRanges.data(), faceRanges.size(), pMaterials.empty() ? nullptr : pMaterials.data(),
+	         pReports.empty() ? nullptr : pReports.data(), shapeIDs.data());
+}
+
+} // namespace
+
+CallbackRecording::CallbackRecording(const std::filesystem::path& file)
+    : mFile(file), mOut(file, std::ofstream::binary) {
+	if (!mOut) {
+		LOG_WRN << "Cannot write callback recording " << file;
+		return;
+	}
+	writeHeader(mOut, RECORDING_MAGIC, RECORDING_VERSION);
+}
+
+uint32_t CallbackRecording::addStream() {
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mStreams++;
+}
+
+std::filesystem::path CallbackRecording::getRecordingFile(const std::string& nodeName) {
+	const char* e = std::getenv(RECORD_CALLBACKS_DIR_ENV_VAR);
+	if (e == nullptr || std::strlen(e) == 0)
+		return {};
+
+	const std::filesystem::path recordingDir = e;
+	std::error_code ec;
+	std::filesystem::create_directories(recordingDir, ec);
+	std::filesystem::path recordingFile = recordingDir / (nodeName + RECORDING_FILE_EXT);
+	ensureNonExistingFile(recordingFile);
+	return recordingFile;
+}
+
+void CallbackRecorder::add(const wchar_t* name, const double* vtx, size_t vtxSize, const double* nrm, size_t nrmSize,
+                           const uint32_t* counts, size_t countsSize, const uint32_t* holeCounts,
+                           size_t holeCountsSize, const uint32_t* holeIndices, size_t holeIndicesSize,
+                           const uint32_t* vertexIndices, size_t vertexIndicesSize, const uint32_t* normalIndices,
+                           size_t normalIndicesSize, double const* const* uvs, size_t const* uvsSizes,
+                           uint32_t const* const* uvCounts, size_t const* uvCountsSizes,
+                           uint32_t const* const* uvIndices, size_t const* uvIndicesSizes, uint32_t uvSets,
+                           const uint32_t* faceRanges, size_t faceRangesSize, const prt::AttributeMap** materials,
+                           const prt::AttributeMap** reports, const int32_t* shapeIDs) {
+	{
+		std::lock_guard<std::mutex> lock(mRecording.mMutex);
+		std::ostream& out = mRecording.mOut;
+		writeRecordHeader(out, RecordType::ADD, mStream);
+		writeString(out, name);
+		writeArray(out, vtx, vtxSize);
+		writeArray(out, nrm, nrmSize);
+		writeArray(out, counts, countsSize);
+		writeArray(out, holeCounts, holeCountsSize);
+		writeArray(out, holeIndices, holeIndicesSize);
+		writeArray(out, vertexIndices, vertexIndicesSize);
+		writeArray(out, normalIndices, normalIndicesSize);
+		write<uint32_t>(out, uvSets);
+		for (uint32_t uvSet = 0; uvSet < uvSets; uvSet++) {
+			writeArray(out, uvs[uvSet], uvsSizes[uvSet]);
+			writeArray(out, uvCounts[uvSet], uvCountsSizes[uvSet]);
+			writeArray(out, uvIndices[uvSet], uvIndicesSizes[uvSet]);
+		}
+		writeArray(out, faceRanges, faceRangesSize);
+		const size_t rangeCount = (faceRangesSize > 0) ? faceRangesSize - 1 : 0;
+		writeAttributeMaps(out, materials, rangeCount);
+		writeAttributeMaps(out, reports, rangeCount);
+		writeArray(out, shapeIDs, (shapeIDs != nullptr) ? rangeCount : 0);
+	}
+
+	mSink.add(name, vtx, vtxSize, nrm, nrmSize, counts, countsSize, holeCounts, holeCountsSize, holeIndices,
+	          holeIndicesSize, vertexIndices, vertexIndicesSize, normalIndices, normalIndicesSize, uvs, uvsSizes,
+	          uvCounts, uvCountsSizes, uvIndices, uvIndicesSizes, uvSets, faceRanges, faceRangesSize, materials,
+	          reports, shapeIDs);
+}
+
+prt::Status CallbackRecorder::generateError(size_t isIndex, prt::Status status, const wchar_t* message) {
+	{
+		std::lock_guard<std::mutex> lock(mRecording.mMutex);
+		writeRecordHeader(mRecording.mOut, RecordType::GENERATE_ERROR, mStream);
+		write<uint64_t>(mRecording.mOut, isIndex);
+		write<int32_t>(mRecording.mOut, status);
+		writeString(mRecording.mOut, message);
+	}
+	return mSink.generateError(isIndex, status, message);
+}
+
+prt::Status CallbackRecorder::attrBool(size_t isIndex, int32_t shapeID, const wchar_t* key, bool value) {
+	{
+		std::lock_guard<std::mutex> lock(mRecording.mMutex);
+		writeAttrHeader(mRecording.mOut, RecordType::ATTR_BOOL, mStream, isIndex, shapeID, key);
+		write<uint8_t>(mRecording.mOut, value ? 1 : 0);
+	}
+	return mSink.attrBool(isIndex, shapeID, key, value);
+}
+
+prt::Status CallbackRecorder::attrFloat(size_t isIndex, int32_t shapeID, const wchar_t* key, double value) {
+	{
+		std::lock_guard<std::mutex> lock(mRecording.mMutex);
+		writeAttrHeader(mRecording.mOut, RecordType::ATTR_FLOAT, mStream, isIndex, shapeID, key);
+		write<double>(mRecording.mOut, value);
+	}
+	return mSink.attrFloat(isIndex, shapeID, key, value);
+}
+
+prt::Status CallbackRecorder::attrString(size_t isIndex, int32_t shapeID, const wchar_t* key, const wchar_t* value) {
+	{
+		std::lock_guard<std::mutex> lock(mRecording.mMutex);
+		writeAttrHeader(mRecording.mOut, RecordType::ATTR_STRING, mStream, isIndex, shapeID, key);
+		writeString(mRecording.mOut, value);
+	}
+	return mSink.attrString(isIndex, shapeID, key, value);
+}
+
+#if ((PRT_VERSION_MAJOR > 1 && PRT_VERSION_MINOR > 1) || PRT_VERSION_MAJOR > 2)
+prt::Status CallbackRecorder::attrBoolArray(size_t isIndex, int32_t shapeID, const wchar_t* key, const bool* ptr,
+                                            size_t size, size_t nRows) {
+	{
+		std::lock_guard<std::mutex> lock(mRecording.mMutex);
+		writeAttrHeader(mRecording.mOut, RecordType::ATTR_BOOL_ARRAY, mStream, isIndex, shapeID, key);
+		write<uint64_t>(mRecording.mOut, nRows);
+		writeBoolArray(mRecording.mOut, ptr, size);
+	}
+	return mSink.attrBoolArray(isIndex, shapeID, key, ptr, size, nRows);
+}
+
+prt::Status CallbackRecorder::attrFloatArray(size_t isIndex, int32_t shapeID, const wchar_t* key, const double* ptr,
+                                             size_t size, size_t nRows) {
+	{
+		std::lock_guard<std::mutex> lock(mRecording.mMutex);
+		writeAttrHeader(mRecording.mOut, RecordType::ATTR_FLOAT_ARRAY, mStream, isIndex, shapeID, key);
+		write<uint64_t>(mRecording.mOut, nRows);
+		writeArray(mRecording.mOut, ptr, size);
+	}
+	return mSink.attrFloatArray(isIndex, shapeID, key, ptr, size, nRows);
+}
+
+prt::Status CallbackRecorder::attrStringArray(size_t isIndex, int32_t shapeID, const wchar_t* key,
+                                              const wchar_t* const* ptr, size_t size, size_t nRows) {
+	{
+		std::lock_guard<std::mutex> lock(mRecording.mMutex);
+		writeAttrHeader(mRecording.mOut, RecordType::ATTR_STRING_ARRAY, mStream, isIndex, shapeID, key);
+		write<uint64_t>(mRecording.mOut, nRows);
+		writeStringArray(mRecording.mOut, ptr, size);
+	}
+	return mSink.attrStringArray(isIndex, shapeID, key, ptr, size, nRows);
+}
+#endif
+
+size_t replayCallbacks(const std::filesystem::path& file, const ReplaySinkProvider& getSink) {
+	Reader reader(file, RECORDING_FILE_KIND);
+	reader.readHeader(RECORDING_MAGIC, RECORDING_VERSION);
+
+	size_t calls = 0;
+	while (!reader.atEnd()) {
+		const auto type = reader.read<RecordType>();
+		HoudiniCallbacks& sink = getSink(reader.read<uint32_t>());
+		if (type == RecordType::ADD) {
+			replayAdd(reader, sink);
+			calls++;
+			continue;
+		}
+		if (type == RecordType::GENERATE_ERROR) {
+			const auto isIndex = static_cast<size_t>(reader.read<uint64_t>());
+			const auto status = static_cast<prt::Status>(reader.read<int32_t>());
+			sink.generateError(isIndex, status, reader.readString().c_str());
+			calls++;
+			continue;
+		}
+
+		const auto isIndex = static_cast<size_t>(reader.read<uint64_t>());
+		const auto shapeID = reader.read<int32_t>();
+		const std::wstring key = reader.readString();
+		switch (type) {
+			case RecordType::ATTR_BOOL:
+				sink.attrBool(isIndex, shapeID, key.c_str(), reader.read<uint8_t>() != 0);
+				break;
+			case RecordType::ATTR_FLOAT:
+				sink.attrFloat(isIndex, shapeID, key.c_str(), reader.read<double>());
+				break;
+			case RecordType::ATTR_STRING:
+				sink.attrString(isIndex, shapeID, key.c_str(), reader.readString().c_str());
+				break;
+#if ((PRT_VERSION_MAJOR > 1 && PRT_VERSION_MINOR > 1) || PRT_VERSION_MAJOR > 2)
+			case RecordType::ATTR_BOOL_ARRAY: {
+				const auto nRows = static_cast<size_t>(reader.read<uint64_t>());
+				size_t size = 0;
+				const std::unique_ptr<bool[]> a = reader.readBoolArray(size);
+				sink.attrBoolArray(isIndex, shapeID, key.c_str(), a.get(), size, nRows);
+				break;
+			}
+			case RecordType::ATTR_FLOAT_ARRAY: {
+				const auto nRows = static_cast<size_t>(reader.read<uint64_t>());
+				const std::vector<double> a = reader.readArray<double>();
+				sink.attrFloatArray(isIndex, shapeID, key.c_str(), a.data(), a.size(), nRows);
+				break;
+			}
+			case RecordType::ATTR_STRING_ARRAY: {
+				const auto nRows = static_cast<size_t>(reader.read<uint64_t>());
+				const std::vector<std::wstring> a = reader.readStringArray();
+				const std::vector<const wchar_t*> pa = toPtrVec(a);
+				sink.attrStringArray(isIndex, shapeID, key.c_str(), pa.data(), pa.size(), nRows);
+				break;
+			}
+#endif
+			default:
+				reader.fail("unknown record in");
+		}
+		calls++;
+	}
+	return calls;
+}
+
+size_t replayCallbacks(const std::filesystem::path& file, HoudiniCallbacks& sink) {
+	return replayCallbacks(file, [&sink, &file](uint32_t stream) -> HoudiniCallbacks& {
+		if (stream != 0)
+			throw std::runtime_error("more than one stream in callback recording " + file.string());
+		return sink;
+	});
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "PalladioMain.h"
+#include "encoder/HoudiniCallbacks.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/**
+ * binary recording of the geometry, attribute and generate error callbacks of a cook, used to replay production data into
+ * ModelConverter (or any other sink) without PRT. the stream is written in native byte order.
+ */
+class PLD_TEST_EXPORTS_API CallbackRecording {
+public:
+	explicit CallbackRecording(const std::filesystem::path& file);
+	CallbackRecording(const CallbackRecording&) = delete;
+	CallbackRecording& operator=(const CallbackRecording&) = delete;
+
+	bool isOpen() const {
+		return mOut.is_open() && mOut.good();
+	}
+
+	const std::filesystem::path& getFile() const {
+		return mFile;
+	}
+
+	/**
+	 * returns the recording file for the node if the CITYENGINE_RECORD_CALLBACKS_DIR environment variable is set
+	 */
+	static std::filesystem::path getRecordingFile(const std::string& nodeName);
+
+private:
+	friend class CallbackRecorder;
+
+	uint32_t addStream();
+
+	const std::filesystem::path mFile;
+	std::mutex mMutex; // the recorders of all generate threads share the file
+	std::ofstream mOut;
+	uint32_t mStreams = 0;
+};
+
+using CallbackRecordingUPtr = std::unique_ptr<CallbackRecording>;
+
+/**
+ * records the add, attr* and generateError calls into the recording and forwards all calls to the sink.
+ * each recorder writes its own stream, numbered in construction order, so the calls of concurrent generate threads
+ * can be told apart on replay.
+ */
+class PLD_TEST_EXPORTS_API CallbackRecorder : public HoudiniCallbacks {
+public:
+	CallbackRecorder(CallbackRecording& recording, HoudiniCallbacks& sink)
+	    : mRecording(recording), mSink(sink), mStream(recording.addStream()) {}
+	~CallbackRecorder() override = default;
+
+	uint32_t getStream() const {
+		return mStream;
+	}
+
+	void beginInitialShape(size_t isIndex) override {
+		mSink.beginInitialShape(isIndex); // not recorded, replay does not know the generate calls
+	}
+
+	void add(const wchar_t* name, const double* vtx, size_t vtxSize, const double* nrm, size_t nrmSize,
+	         const uint32_t* counts, size_t countsSize, const uint32_t* holeCounts, size_t holeCountsSize,
+	         const uint32_t* holeIndices, size_t holeIndicesSize, const uint32_t* vertexIndices,
+	         size_t vertexIndicesSize, const uint32_t* normalIndices, size_t normalIndicesSize,
+	         double const* const* uvs, size_t const* uvsSizes, uint32_t const* const* uvCounts,
+	         size_t const* uvCountsSizes, uint32_t const* const* uvIndices, size_t const* uvIndicesSizes,
+	         uint32_t uvSets, const uint32_t* faceRanges, size_t faceRangesSize, const prt::AttributeMap** materials,
+	         const prt::AttributeMap** reports, const int32_t* shapeIDs) override;
+
+	prt::Status generateError(size_t isIndex, prt::Status status, const wchar_t* message) override;
+	prt::Status assetError(size_t isIndex, prt::CGAErrorLevel level, const wchar_t* key, const wchar_t* uri,
+	                       const wchar_t* message) override {
+		return mSink.assetError(isIndex, level, key, uri, message);
+	}
+	prt::Status cgaError(size_t isIndex, int32_t shapeID, prt::CGAErrorLevel level, int32_t methodId, int32_t pc,
+	                     const wchar_t* message) override {
+		return mSink.cgaError(isIndex, shapeID, level, methodId, pc, message);
+	}
+	prt::Status cgaPrint(size_t isIndex, int32_t shapeID, const wchar_t* txt) override {
+		return mSink.cgaPrint(isIndex, shapeID, txt);
+	}
+	prt::Status cgaReportBool(size_t isIndex, int32_t shapeID, const wchar_t* key, bool value) override {
+		return mSink.cgaReportBool(isIndex, shapeID, key, value);
+	}
+	prt::Status cgaReportFloat(size_t isIndex, int32_t shapeID, const wchar_t* key, double value) override {
+		return mSink.cgaReportFloat(isIndex, shapeID, key, value);
+	}
+	prt::Status cgaReportString(size_t isIndex, int32_t shapeID, const wchar_t* key, const wchar_t* value) override {
+		return mSink.cgaReportString(isIndex, shapeID, key, value);
+	}
+
+	prt::Status attrBool(size_t isIndex, int32_t shapeID, const wchar_t* key, bool value) override;
+	prt::Status attrFloat(size_t isIndex, int32_t shapeID, const wchar_t* key, double value) override;
+	prt::Status attrString(size_t isIndex, int32_t shapeID, const wchar_t* key, const wchar_t* value) override;
+
+#if ((PRT_VERSION_MAJOR > 1 && PRT_VERSION_MINOR > 1) || PRT_VERSION_MAJOR > 2)
+	prt::Status attrBoolArray(size_t isIndex, int32_t shapeID, const wchar_t* key, const bool* ptr, size_t size,
+	                          size_t nRows) override;
+	prt::Status attrFloatArray(size_t isIndex, int32_t shapeID, const wchar_t* key, const double* ptr, size_t size,
+	                           size_t nRows) override;
+	prt::Status attrStringArray(size_t isIndex, int32_t shapeID, const wchar_t* key, const wchar_t* const* ptr,
+	                            size_t size, size_t nRows) override;
+#elif (PRT_VERSION_MAJOR > 1 && PRT_VERSION_MINOR > 0)
+	prt::Status attrBoolArray(size_t isIndex, int32_t shapeID, const wchar_t* key, const bool* ptr,
+	                          size_t size) override {
+		return mSink.attrBoolArray(isIndex, shapeID, key, ptr, size);
+	}
+	prt::Status attrFloatArray(size_t isIndex, int32_t shapeID, const wchar_t* key, const double* ptr,
+	                           size_t size) override {
+		return mSink.attrFloatArray(isIndex, shapeID, key, ptr, size);
+	}
+	prt::Status attrStringArray(size_t isIndex, int32_t shapeID, const wchar_t* key, const wchar_t* const* ptr,
+	                            size_t size) override {
+		return mSink.attrStringArray(isIndex, shapeID, key, ptr, size);
+	}
+#endif
+
+private:
+	CallbackRecording& mRecording;
+	HoudiniCallbacks& mSink;
+	const uint32_t mStream;
+};
+
+using CallbackRecorderUPtr = std::unique_ptr<CallbackRecorder>;
+
+using ReplaySinkProvider = std::function<HoudiniCallbacks&(uint32_t stream)>;
+
+/**
+ * feeds each recorded stream into the sink returned for it, in recording order, returns the number of replayed calls.
+ * throws std::runtime_error if the file cannot be read or is not a valid recording.
+ */
+PLD_TEST_EXPORTS_API size_t replayCallbacks(const std::filesystem::path& file, const ReplaySinkProvider& getSink);
+
+/**
+ * replays the recording of a single recorder into the sink, throws std::runtime_error if it contains other streams
+ */
+PLD_TEST_EXPORTS_API size_t replayCallbacks(const std::filesystem::path& file, HoudiniCallbacks& sink);
@@ -0,0 +1,128 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CookReport.h"
+#include "LogHandler.h"
+#include "Utils.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+constexpr const char* COOK_REPORT_DIR_ENV_VAR = "CITYENGINE_COOK_REPORT_DIR";
+constexpr const char* COOK_REPORT_FILE_EXT = ".json";
+constexpr double BYTES_PER_MB = 1024.0 * 1024.0;
+
+std::filesystem::path getCookReportDirectory() {
+	const char* e = std::getenv(COOK_REPORT_DIR_ENV_VAR);
+	if (e == nullptr || std::strlen(e) == 0)
+		return {};
+	return e;
+}
+
+} // namespace
+
+void CookReport::addStage(const char* name, Duration duration) {
+	stages.emplace_back(name, duration);
+}
+
+void CookReport::setResolveMapCacheStatistics(const ResolveMapCache::Statistics& before,
+                                              const ResolveMapCache::Statistics& after) {
+	// note: the cache is shared by all nodes, i.e. concurrent cooks of other nodes are included
+	rpkCacheHits = after.hits - before.hits;
+	rpkCacheMisses = after.misses - before.misses;
+	rpkCacheReloads = after.reloads - before.reloads;
+	prtCacheFlushedEntries = after.flushedPRTEntries - before.flushedPRTEntries;
+}
+
+void CookReport::finish() {
+	cookTime = Clock::now() - begin;
+}
+
+double CookReport::getThreadUtilization() const {
+	const double available = threads * threadWallTime.count();
+	return (available > 0.0) ? threadBusyTime.count() / available : 0.0;
+}
+
+std::string CookReport::toText() const {
+	std::ostringstream out;
+	out << std::fixed << std::setprecision(3);
+	out << "Last cook: " << cookTime.count() << " s\n";
+	for (const auto& [name, duration] : stages)
+		out << "    " << name << ": " << duration.count() << " s\n";
+	out << "Initial shapes: " << initialShapes << "\n";
+	if (threads > 0) {
+		out << "Generate threads: " << threads << " (utilization " << std::setprecision(0)
+		    << 100.0 * getThreadUtilization() << "%, waited " << std::setprecision(3) << lockWaitTime.count()
+		    << " s for the detail)\n";
+		out << "Detail writes: " << detailWriteTime.count() << " s\n";
+	}
+	out << "RPK cache: " << rpkCacheHits << " hits, " << rpkCacheMisses << " misses (" << rpkCacheReloads
+	    << " reloads), " << prtCacheFlushedEntries << " PRT cache entries flushed\n";
+	out << "Output: " << primitives << " primitives, " << points << " points, " << std::setprecision(1)
+	    << memoryUsage / BYTES_PER_MB << " MB\n";
+	return out.str();
+}
+
+std::string CookReport::toJSON() const {
+	std::ostringstream out;
+	out << std::fixed << std::setprecision(6);
+	out << "{\n";
+	out << "  \"cookTime\": " << cookTime.count() << ",\n";
+	out << "  \"stages\": [";
+	for (size_t i = 0; i < stages.size(); i++) {
+		out << ((i > 0) ? ", " : "") << "{\"name\": \"" << stages[i].first << "\", ";
+		out << "\"time\": " << stages[i].second.count() << "}";
+	}
+	out << "],\n";
+	out << "  \"initialShapes\": " << initialShapes << ",\n";
+	out << "  \"threads\": " << threads << ",\n";
+	out << "  \"threadBusyTime\": " << threadBusyTime.count() << ",\n";
+	out << "  \"threadWallTime\": " << threadWallTime.count() << ",\n";
+	out << "  \"threadUtilization\": " << getThreadUtilization() << ",\n";
+	out << "  \"lockWaitTime\": " << lockWaitTime.count() << ",\n";
+	out << "  \"detailWriteTime\": " << detailWriteTime.count() << ",\n";
+	out << "  \"rpkCacheHits\": " << rpkCacheHits << ",\n";
+	out << "  \"rpkCacheMisses\": " << rpkCacheMisses << ",\n";
+	out << "  \"rpkCacheReloads\": " << rpkCacheReloads << ",\n";
+	out << "  \"prtCacheFlushedEntries\": " << prtCacheFlushedEntries << ",\n";
+	out << "  \"primitives\": " << primitives << ",\n";
+	out << "  \"points\": " << points << ",\n";
+	out << "  \"memoryUsage\": " << memoryUsage << "\n";
+	out << "}\n";
+	return out.str();
+}
+
+void CookReport::write(const std::string& nodeName) const {
+	const std::filesystem::path reportDir = getCookReportDirectory();
+	if (reportDir.empty())
+		return;
+
+	std::error_code ec;
+	std::filesystem::create_directories(reportDir, ec);
+	std::filesystem::path reportFile = reportDir / (nodeName + COOK_REPORT_FILE_EXT);
+	ensureNonExistingFile(reportFile);
+
+	std::ofstream out(reportFile, std::ofstream::binary);
+	out << toJSON();
+	if (!out)
+		LOG_WRN << "Cannot write cook report " << reportFile;
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "PalladioMain.h"
+#include "ResolveMapCache.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * performance statistics of the last cook of an assign or generate node, shown in the node info panel and optionally
+ * written as JSON sidecar into the directory given by the CITYENGINE_COOK_REPORT_DIR environment variable
+ */
+struct PLD_TEST_EXPORTS_API CookReport {
+	using Clock = std::chrono::steady_clock;
+	using Duration = std::chrono::duration<double>;
+
+	class StageTimer {
+	public:
+		StageTimer(CookReport& report, const char* name) : mReport(report), mName(name), mBegin(Clock::now()) {}
+		StageTimer(const StageTimer&) = delete;
+		StageTimer& operator=(const StageTimer&) = delete;
+		~StageTimer() {
+			mReport.addStage(mName, Clock::now() - mBegin);
+		}
+
+	private:
+		CookReport& mReport;
+		const char* const mName;
+		const Clock::time_point mBegin;
+	};
+
+	void addStage(const char* name, Duration duration);
+	void setResolveMapCacheStatistics(const ResolveMapCache::Statistics& before,
+	                                  const ResolveMapCache::Statistics& after);
+	void finish();
+
+	double getThreadUtilization() const;
+
+	std::string toText() const;
+	std::string toJSON() const;
+
+	/**
+	 * writes the JSON sidecar if CITYENGINE_COOK_REPORT_DIR is set
+	 */
+	void write(const std::string& nodeName) const;
+
+	Clock::time_point begin = Clock::now();
+	Duration cookTime{0.0};
+	std::vector<std::pair<const char*, Duration>> stages; // in order of completion, name must be a string literal
+
+	size_t initialShapes = 0;
+	size_t threads = 0;
+	Duration threadBusyTime{0.0};  // accumulated time the generate threads spent in PRT
+	Duration threadWallTime{0.0};  // time from starting to joining the generate threads
+	Duration lockWaitTime{0.0};    // accumulated time the generate threads waited for the detail
+	Duration detailWriteTime{0.0}; // time the detail writer thread spent writing the generated geometry
+
+	size_t rpkCacheHits = 0;
+	size_t rpkCacheMisses = 0;
+	size_t rpkCacheReloads = 0;
+	size_t prtCacheFlushedEntries = 0;
+
+	size_t primitives = 0;
+	size_t points = 0;
+	int64_t memoryUsage = 0; // of the output detail in bytes
+};
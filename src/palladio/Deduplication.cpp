@@ -0,0 +1,141 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Deduplication.h"
+#include "BinaryStream.h"
+
+#include "prt/InitialShape.h"
+
+#include <cmath>
+#include <numeric>
+#include <sstream>
+#include <unordered_map>
+
+namespace {
+
+using namespace BinaryStream;
+
+// the initial shape relative to its first vertex as bytes, equal bytes mean identical initial shapes (a few equal
+// shapes with vertices just across a rounding boundary are missed, which is harmless)
+std::string getCanonicalForm(const prt::InitialShape* is, double tolerance) {
+	std::ostringstream out(std::ios::binary);
+
+	const double* vtx = is->getVertices();
+	const size_t vtxCount = is->getVertexCount();
+	write<uint64_t>(out, vtxCount);
+	for (size_t i = 0; i < vtxCount; i++) {
+		const double relative = vtx[i] - vtx[i % 3];
+		write<int64_t>(out, std::llround(relative / tolerance));
+	}
+	writeArray(out, is->getIndices(), is->getIndexCount());
+	writeArray(out, is->getFaceCounts(), is->getFaceCountsCount());
+	writeArray(out, is->getHoles(), is->getHolesCount());
+
+	write<uint32_t>(out, is->getUVSetsCount());
+	for (uint32_t uvSet = 0; uvSet < is->getUVSetsCount(); uvSet++) {
+		writeArray(out, is->getUVs(uvSet), is->getUVsCount(uvSet));
+		writeArray(out, is->getUVIndices(uvSet), is->getUVIndicesCount(uvSet));
+		writeArray(out, is->getFaceUVCounts(uvSet), is->getFaceUVCountsCount(uvSet));
+	}
+
+	writeString(out, is->getRuleFile());
+	writeString(out, is->getStartRule());
+	write<int32_t>(out, is->getRandomSeed());
+	write<uintptr_t>(out, reinterpret_cast<uintptr_t>(is->getResolveMap())); // shared per rule package
+	if (is->getAttributeMap() != nullptr)
+		writeAttributeMap(out, is->getAttributeMap());
+
+	return out.str();
+}
+
+} // namespace
+
+namespace Deduplication {
+
+size_t Classes::getDuplicateCount() const {
+	return std::accumulate(duplicates.begin(), duplicates.end(), size_t(0),
+	                       [](size_t n, const std::vector<Duplicate>& d) { return n + d.size(); });
+}
+
+Classes classify(const InitialShapeNOPtrVector& initialShapes, double tolerance) {
+	Classes classes;
+	std::unordered_map<std::string, size_t> representativeByForm; // into classes.representatives
+	for (size_t isIdx = 0; isIdx < initialShapes.size(); isIdx++) {
+		const prt::InitialShape* is = initialShapes[isIdx];
+		const auto [it, inserted] =
+		        representativeByForm.emplace(getCanonicalForm(is, tolerance), classes.representatives.size());
+		if (inserted || is->getVertexCount() < 3) {
+			classes.representatives.push_back(isIdx);
+			classes.duplicates.emplace_back();
+			continue;
+		}
+
+		const prt::InitialShape* representative = initialShapes[classes.representatives[it->second]];
+		Duplicate d{isIdx, {}};
+		for (size_t axis = 0; axis < 3; axis++)
+			d.offset[axis] = is->getVertices()[axis] - representative->getVertices()[axis];
+		classes.duplicates[it->second].push_back(d);
+	}
+	return classes;
+}
+
+void DuplicateEmitter::beginInitialShape(size_t isIndex) {
+	mCurrentRepresentative = mIsStartPos + isIndex;
+	mSink.beginInitialShape(isIndex);
+}
+
+prt::Status DuplicateEmitter::generateError(size_t isIndex, prt::Status status, const wchar_t* message) {
+	const size_t representative = mIsStartPos + isIndex;
+	if (representative >= mClasses.representatives.size())
+		return mSink.generateError(isIndex, status, message);
+
+	const prt::Status sinkStatus = mSink.generateError(mClasses.representatives[representative], status, message);
+	for (const Duplicate& d : mClasses.duplicates[representative])
+		mSink.generateError(d.index, status, message);
+	return sinkStatus;
+}
+
+void DuplicateEmitter::add(const wchar_t* name, const double* vtx, size_t vtxSize, const double* nrm, size_t nrmSize,
+                           const uint32_t* counts, size_t countsSize, const uint32_t* holeCounts,
+                           size_t holeCountsSize, const uint32_t* holeIndices, size_t holeIndicesSize,
+                           const uint32_t* vertexIndices, size_t vertexIndicesSize, const uint32_t* normalIndices,
+                           size_t normalIndicesSize, double const* const* uvs, size_t const* uvsSizes,
+                           uint32_t const* const* uvCounts, size_t const* uvCountsSizes,
+                           uint32_t const* const* uvIndices, size_t const* uvIndicesSizes, uint32_t uvSets,
+                           const uint32_t* faceRanges, size_t faceRangesSize, const prt::AttributeMap** materials,
+                           const prt::AttributeMap** reports, const int32_t* shapeIDs) {
+	mSink.add(name, vtx, vtxSize, nrm, nrmSize, counts, countsSize, holeCounts, holeCountsSize, holeIndices,
+	          holeIndicesSize, vertexIndices, vertexIndicesSize, normalIndices, normalIndicesSize, uvs, uvsSizes,
+	          uvCounts, uvCountsSizes, uvIndices, uvIndicesSizes, uvSets, faceRanges, faceRangesSize, materials,
+	          reports, shapeIDs);
+
+	const size_t representative = mCurrentRepresentative;
+	mCurrentRepresentative = NO_SHAPE;
+	if (representative >= mClasses.duplicates.size())
+		return;
+
+	std::vector<double> translated(vtxSize);
+	for (const Duplicate& d : mClasses.duplicates[representative]) {
+		for (size_t i = 0; i < vtxSize; i++)
+			translated[i] = vtx[i] + d.offset[i % 3];
+		mSink.add(mInitialShapes[d.index]->getName(), translated.data(), vtxSize, nrm, nrmSize, counts, countsSize,
+		          holeCounts, holeCountsSize, holeIndices, holeIndicesSize, vertexIndices, vertexIndicesSize,
+		          normalIndices, normalIndicesSize, uvs, uvsSizes, uvCounts, uvCountsSizes, uvIndices,
+		          uvIndicesSizes, uvSets, faceRanges, faceRangesSize, materials, reports, shapeIDs);
+	}
+}
+
+} // namespace Deduplication
@@ -0,0 +1,153 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Utils.h"
+#include "encoder/HoudiniCallbacks.h"
+
+#include <array>
+#include <limits>
+#include <vector>
+
+/**
+ * generation of identical initial shapes (up to translation) only once. two initial shapes are identical if their
+ * geometry relative to their first vertex, uvs, rule, start rule, random seed, rule attributes and resolve map match.
+ * note that rules which depend on the absolute position (e.g. occlusion or world space projections) can generate
+ * different models for identical initial shapes.
+ */
+namespace Deduplication {
+
+constexpr double DEFAULT_TOLERANCE = 1e-5; // vertex positions closer than this are considered equal
+
+struct Duplicate {
+	size_t index;                 // into the initial shapes
+	std::array<double, 3> offset; // translation from the representative
+};
+
+struct Classes {
+	std::vector<size_t> representatives;            // into the initial shapes, in increasing order
+	std::vector<std::vector<Duplicate>> duplicates; // per representative
+
+	size_t getDuplicateCount() const;
+};
+
+PLD_TEST_EXPORTS_API Classes classify(const InitialShapeNOPtrVector& initialShapes,
+                                      double tolerance = DEFAULT_TOLERANCE);
+
+/**
+ * forwards all calls to the sink and repeats the add call of each generated representative for its duplicates, with
+ * translated vertices and the name of the duplicate. relies on the encoder announcing each initial shape with
+ * beginInitialShape before its add call.
+ */
+class PLD_TEST_EXPORTS_API DuplicateEmitter : public HoudiniCallbacks {
+public:
+	/**
+	 * isStartPos is the index of the first initial shape of the generate call in classes.representatives
+	 */
+	DuplicateEmitter(HoudiniCallbacks& sink, const Classes& classes, const InitialShapeNOPtrVector& initialShapes,
+	                 size_t isStartPos)
+	    : mSink(sink), mClasses(classes), mInitialShapes(initialShapes), mIsStartPos(isStartPos) {}
+	~DuplicateEmitter() override = default;
+
+	void beginInitialShape(size_t isIndex) override;
+
+	void add(const wchar_t* name, const double* vtx, size_t vtxSize, const double* nrm, size_t nrmSize,
+	         const uint32_t* counts, size_t countsSize, const uint32_t* holeCounts, size_t holeCountsSize,
+	         const uint32_t* holeIndices, size_t holeIndicesSize, const uint32_t* vertexIndices,
+	         size_t vertexIndicesSize, const uint32_t* normalIndices, size_t normalIndicesSize,
+	         double const* const* uvs, size_t const* uvsSizes, uint32_t const* const* uvCounts,
+	         size_t const* uvCountsSizes, uint32_t const* const* uvIndices, size_t const* uvIndicesSizes,
+	         uint32_t uvSets, const uint32_t* faceRanges, size_t faceRangesSize, const prt::AttributeMap** materials,
+	         const prt::AttributeMap** reports, const int32_t* shapeIDs) override;
+
+	/**
+	 * forwards the error with the index of the representative in the initial shapes and repeats it for its duplicates
+	 */
+	prt::Status generateError(size_t isIndex, prt::Status status, const wchar_t* message) override;
+	prt::Status assetError(size_t isIndex, prt::CGAErrorLevel level, const wchar_t* key, const wchar_t* uri,
+	                       const wchar_t* message) override {
+		return mSink.assetError(isIndex, level, key, uri, message);
+	}
+	prt::Status cgaError(size_t isIndex, int32_t shapeID, prt::CGAErrorLevel level, int32_t methodId, int32_t pc,
+	                     const wchar_t* message) override {
+		return mSink.cgaError(isIndex, shapeID, level, methodId, pc, message);
+	}
+	prt::Status cgaPrint(size_t isIndex, int32_t shapeID, const wchar_t* txt) override {
+		return mSink.cgaPrint(isIndex, shapeID, txt);
+	}
+	prt::Status cgaReportBool(size_t isIndex, int32_t shapeID, const wchar_t* key, bool value) override {
+		return mSink.cgaReportBool(isIndex, shapeID, key, value);
+	}
+	prt::Status cgaReportFloat(size_t isIndex, int32_t shapeID, const wchar_t* key, double value) override {
+		return mSink.cgaReportFloat(isIndex, shapeID, key, value);
+	}
+	prt::Status cgaReportString(size_t isIndex, int32_t shapeID, const wchar_t* key, const wchar_t* value) override {
+		return mSink.cgaReportString(isIndex, shapeID, key, value);
+	}
+	prt::Status attrBool(size_t isIndex, int32_t shapeID, const wchar_t* key, bool value) override {
+		return mSink.attrBool(isIndex, shapeID, key, value);
+	}
+	prt::Status attrFloat(size_t isIndex, int32_t shapeID, const wchar_t* key, double value) override {
+		return mSink.attrFloat(isIndex, shapeID, key, value);
+	}
+	prt::Status attrString(size_t isIndex, int32_t shapeID, const wchar_t* key, const wchar_t* value) override {
+		return mSink.attrString(isIndex, shapeID, key, value);
+	}
+
+#if ((PRT_VERSION_MAJOR > 1 && PRT_VERSION_MINOR > 1) || PRT_VERSION_MAJOR > 2)
+	prt::Status attrBoolArray(size_t isIndex, int32_t shapeID, const wchar_t* key, const bool* ptr, size_t size,
+	                          size_t nRows) override {
+		return mSink.attrBoolArray(isIndex, shapeID, key, ptr, size, nRows);
+	}
+	prt::Status attrFloatArray(size_t isIndex, int32_t shapeID, const wchar_t* key, const double* ptr, size_t size,
+	                           size_t nRows) override {
+		return mSink.attrFloatArray(isIndex, shapeID, key, ptr, size, nRows);
+	}
+	prt::Status attrStringArray(size_t isIndex, int32_t shapeID, const wchar_t* key, const wchar_t* const* ptr,
+	                            size_t size, size_t nRows) override {
+		return mSink.attrStringArray(isIndex, shapeID, key, ptr, size, nRows);
+	}
+#elif (PRT_VERSION_MAJOR > 1 && PRT_VERSION_MINOR > 0)
+	prt::Status attrBoolArray(size_t isIndex, int32_t shapeID, const wchar_t* key, const bool* ptr,
+	                          size_t size) override {
+		return mSink.attrBoolArray(isIndex, shapeID, key, ptr, size);
+	}
+	prt::Status attrFloatArray(size_t isIndex, int32_t shapeID, const wchar_t* key, const double* ptr,
+	                           size_t size) override {
+		return mSink.attrFloatArray(isIndex, shapeID, key, ptr, size);
+	}
+	prt::Status attrStringArray(size_t isIndex, int32_t shapeID, const wchar_t* key, const wchar_t* const* ptr,
+	                            size_t size) override {
+		return mSink.attrStringArray(isIndex, shapeID, key, ptr, size);
+	}
+#endif
+
+	prt::Callbacks::Continuation progress(float percentageCompleted) override {
+		return mSink.progress(percentageCompleted);
+	}
+
+private:
+	static constexpr size_t NO_SHAPE = std::numeric_limits<size_t>::max();
+
+	HoudiniCallbacks& mSink;
+	const Classes& mClasses;
+	const InitialShapeNOPtrVector& mInitialShapes;
+	const size_t mIsStartPos;
+	size_t mCurrentRepresentative = NO_SHAPE; // index into mClasses.representatives
+};
+
+} // namespace Deduplication
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DetailWriter.h"
+#include "LogHandler.h"
+
+#include <cassert>
+#include <exception>
+
+DetailWriter::DetailWriter(size_t maxQueuedBytes)
+    : mMaxQueuedBytes(maxQueuedBytes), mThread(&DetailWriter::run, this) {}
+
+DetailWriter::~DetailWriter() {
+	finish();
+}
+
+void DetailWriter::enqueue(Write&& write, size_t bytes) {
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		assert(!mClosed);
+		if (mQueuedBytes > 0 && mQueuedBytes + bytes > mMaxQueuedBytes) {
+			const auto blockBegin = std::chrono::steady_clock::now();
+			mQueueChanged.wait(lock, [this, bytes] {
+				return mQueuedBytes == 0 || mQueuedBytes + bytes <= mMaxQueuedBytes;
+			});
+			mBlockedTime += std::chrono::steady_clock::now() - blockBegin;
+		}
+		mQueue.emplace_back(std::move(write), bytes);
+		mQueuedBytes += bytes;
+	}
+	mQueueChanged.notify_all();
+}
+
+void DetailWriter::finish() {
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mClosed = true;
+	}
+	mQueueChanged.notify_all();
+	if (mThread.joinable())
+		mThread.join();
+}
+
+DetailWriter::Duration DetailWriter::getBlockedTime() const {
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mBlockedTime;
+}
+
+DetailWriter::Duration DetailWriter::getBusyTime() const {
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mBusyTime;
+}
+
+void DetailWriter::run() {
+	while (true) {
+		std::pair<Write, size_t> write;
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mQueueChanged.wait(lock, [this] { return !mQueue.empty() || mClosed; });
+			if (mQueue.empty())
+				return; // closed and drained
+			write = std::move(mQueue.front());
+			mQueue.pop_front();
+		}
+
+		const auto writeBegin = std::chrono::steady_clock::now();
+		try {
+			write.first();
+		}
+		catch (const std::exception& e) {
+			LOG_ERR << "failed to write generated geometry: " << e.what();
+		}
+		const Duration writeTime = std::chrono::steady_clock::now() - writeBegin;
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mQueuedBytes -= write.second;
+			mBusyTime += writeTime;
+		}
+		mQueueChanged.notify_all(); // the generate threads might wait for the limit
+	}
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Utils.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+/**
+ * runs the writes into the houdini detail of one cook on a dedicated thread, in enqueue order. the generate threads
+ * only copy their meshes into the queue and continue with the next shape instead of waiting for the detail. the
+ * queue is bounded by the bytes of the pending writes: enqueue blocks while the limit is exceeded.
+ */
+class PLD_TEST_EXPORTS_API DetailWriter {
+public:
+	using Write = std::function<void()>;
+	using Duration = std::chrono::duration<double>;
+
+	static constexpr size_t DEFAULT_MAX_QUEUED_BYTES = size_t(256) << 20;
+
+	explicit DetailWriter(size_t maxQueuedBytes = DEFAULT_MAX_QUEUED_BYTES);
+	DetailWriter(const DetailWriter&) = delete;
+	DetailWriter& operator=(const DetailWriter&) = delete;
+	~DetailWriter();
+
+	// bytes is the memory held by the write, a single write larger than the limit is still accepted
+	void enqueue(Write&& write, size_t bytes);
+
+	// waits until all enqueued writes are done, afterwards the detail can be used again
+	void finish();
+
+	// accumulated time enqueue blocked because of the limit
+	Duration getBlockedTime() const;
+
+	// accumulated time the writer thread spent in the writes
+	Duration getBusyTime() const;
+
+private:
+	void run();
+
+	const size_t mMaxQueuedBytes;
+
+	mutable std::mutex mMutex;
+	std::condition_variable mQueueChanged;
+	std::deque<std::pair<Write, size_t>> mQueue;
+	size_t mQueuedBytes = 0; // including the write in progress
+	bool mClosed = false;
+	Duration mBlockedTime{0.0};
+	Duration mBusyTime{0.0};
+
+	std::thread mThread;
+};
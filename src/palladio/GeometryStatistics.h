@@ -0,0 +1,65 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+/**
+ * the geometry the add callback received for an initial shape, the emitted face and vertex counts stand in for memory
+ */
+struct GeometryStatistics {
+	size_t leafShapes = 0;
+	size_t faces = 0;
+	size_t vertices = 0;
+
+	// takes the sizes of the arrays passed to HoudiniCallbacks::add
+	void add(size_t faceRangesSize, size_t countsSize, size_t vertexIndicesSize) {
+		leafShapes += (faceRangesSize > 0) ? faceRangesSize - 1 : 0;
+		faces += countsSize;
+		vertices += vertexIndicesSize;
+	}
+};
+
+/**
+ * counts the geometry of the add calls towards the initial shape the encoder announced with beginInitialShape,
+ * T is GeometryStatistics or derived from it
+ */
+template <typename T>
+class GeometryStatisticsCounter {
+public:
+	// the statistics of the initial shapes of the next generate call, in its order (nullptr: no statistics)
+	void setStatistics(T* statistics) {
+		mStatistics = statistics;
+		mCurrent = statistics;
+	}
+
+	void beginInitialShape(size_t isIndex) {
+		if (mStatistics != nullptr)
+			mCurrent = mStatistics + isIndex;
+	}
+
+	// returns the statistics the geometry was counted towards (nullptr: none)
+	T* add(size_t faceRangesSize, size_t countsSize, size_t vertexIndicesSize) {
+		if (mCurrent != nullptr)
+			mCurrent->add(faceRangesSize, countsSize, vertexIndicesSize);
+		return mCurrent;
+	}
+
+private:
+	T* mStatistics = nullptr;
+	T* mCurrent = nullptr;
+};
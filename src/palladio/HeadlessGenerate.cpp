@@ -0,0 +1,115 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "HeadlessGenerate.h"
+#include "LogHandler.h"
+
+#include "prt/API.h"
+
+#include <algorithm>
+#include <future>
+#include <map>
+#include <stdexcept>
+
+namespace {
+
+/**
+ * runs generateRange(threadIndex, isStartPos, isCount) concurrently on the same initial shape ranges as the generate
+ * node, returns the number of calls which did not return STATUS_OK
+ */
+template <typename F>
+size_t forEachRange(size_t isCount, size_t nThreads, F generateRange) {
+	const size_t isRangeSize = isCount / nThreads; // the last thread takes the remainder
+	std::vector<prt::Status> batchStatus(nThreads, prt::STATUS_OK);
+
+	std::vector<std::future<void>> futures;
+	futures.reserve(nThreads);
+	for (size_t ti = 0; ti < nThreads; ti++) {
+		const size_t isStartPos = ti * isRangeSize;
+		const size_t isPastEndPos = (ti < nThreads - 1) ? (ti + 1) * isRangeSize : isCount;
+		if (isStartPos == isPastEndPos)
+			continue;
+		futures.emplace_back(std::async(std::launch::async, [&, ti, isStartPos, isPastEndPos] {
+			batchStatus[ti] = generateRange(ti, isStartPos, isPastEndPos - isStartPos);
+			if (batchStatus[ti] != prt::STATUS_OK) {
+				LOG_WRN << "generate of initial shapes " << isStartPos << " to " << isPastEndPos
+				        << " failed with status: '" << prt::getStatusDescription(batchStatus[ti]) << "'";
+			}
+		}));
+	}
+	std::for_each(futures.begin(), futures.end(), [](std::future<void>& f) { f.wait(); });
+
+	return std::count_if(batchStatus.begin(), batchStatus.end(), [](prt::Status s) { return s != prt::STATUS_OK; });
+}
+
+} // namespace
+
+GenerateSetup getGenerateSetup(const CapturedScene& scene) {
+	GenerateSetup setup;
+	for (const CapturedEncoder& encoder : scene.encoders) {
+		setup.encoders.push_back(encoder.id.c_str());
+		setup.encoderOptions.push_back(encoder.options.get());
+	}
+	setup.generateOptions = scene.generateOptions.get();
+	setup.occlusion = scene.occlusion;
+	return setup;
+}
+
+std::vector<InitialShapeUPtr> createInitialShapes(const std::vector<CapturedShape>& shapes, PRTContext& prtCtx) {
+	std::map<std::filesystem::path, ResolveMapSPtr> resolveMaps;
+	std::vector<InitialShapeUPtr> initialShapes;
+	initialShapes.reserve(shapes.size());
+	for (const CapturedShape& shape : shapes) {
+		ResolveMapSPtr& resolveMap = resolveMaps[shape.rulePackage];
+		if (!resolveMap) {
+			resolveMap = prtCtx.getResolveMap(shape.rulePackage);
+			if (!resolveMap)
+				throw std::runtime_error("cannot load rule package " + shape.rulePackage.string());
+		}
+		initialShapes.emplace_back(createInitialShape(shape, resolveMap.get()));
+	}
+	return initialShapes;
+}
+
+size_t generateHeadless(const InitialShapeNOPtrVector& initialShapes, const GenerateSetup& setup,
+                        const std::vector<prt::Callbacks*>& callbacks, prt::Cache* prtCache) {
+	const InitialShapeNOPtrVector& is = initialShapes;
+	size_t failedCalls = 0;
+
+	std::vector<prt::OcclusionSet::Handle> occlusionHandles;
+	OcclusionSetUPtr occlusionSet;
+	if (setup.occlusion) {
+		occlusionHandles.resize(is.size());
+		occlusionSet.reset(prt::OcclusionSet::create());
+		failedCalls += forEachRange(is.size(), callbacks.size(), [&](size_t ti, size_t isStartPos, size_t isCount) {
+			return prt::generateOccluders(&is[isStartPos], isCount, &occlusionHandles[isStartPos], nullptr, 0,
+			                              nullptr, callbacks[ti], prtCache, occlusionSet.get(),
+			                              setup.generateOptions);
+		});
+	}
+
+	failedCalls += forEachRange(is.size(), callbacks.size(), [&](size_t ti, size_t isStartPos, size_t isCount) {
+		const prt::OcclusionSet::Handle* handles = setup.occlusion ? &occlusionHandles[isStartPos] : nullptr;
+		return prt::generate(&is[isStartPos], isCount, handles, setup.encoders.data(), setup.encoders.size(),
+		                     setup.encoderOptions.data(), callbacks[ti], prtCache, occlusionSet.get(),
+		                     setup.generateOptions);
+	});
+
+	if (occlusionSet)
+		occlusionSet->dispose(occlusionHandles.data(), occlusionHandles.size());
+
+	return failedCalls;
+}
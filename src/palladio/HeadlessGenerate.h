@@ -0,0 +1,54 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "PRTContext.h"
+#include "SceneCapture.h"
+#include "Utils.h"
+
+#include "prt/Callbacks.h"
+
+#include <vector>
+
+/**
+ * encoders and options of a generate call outside of houdini
+ */
+struct GenerateSetup {
+	std::vector<const wchar_t*> encoders;
+	AttributeMapNOPtrVector encoderOptions;
+	const prt::AttributeMap* generateOptions = nullptr;
+	bool occlusion = true; // generate the occluders of all initial shapes first, like the generate node
+};
+
+/**
+ * the setup of a scene capture, valid as long as the scene
+ */
+PLD_TEST_EXPORTS_API GenerateSetup getGenerateSetup(const CapturedScene& scene);
+
+/**
+ * recreates the captured initial shapes, the rule packages are loaded through the resolve map cache of the context.
+ * throws std::runtime_error if a rule package cannot be loaded or an initial shape cannot be created.
+ */
+PLD_TEST_EXPORTS_API std::vector<InitialShapeUPtr> createInitialShapes(const std::vector<CapturedShape>& shapes,
+                                                                       PRTContext& prtCtx);
+
+/**
+ * generates the initial shapes with the scheduling of the generate node: one thread per callbacks instance, each
+ * thread generates one contiguous range of initial shapes. returns the number of failed generate calls.
+ */
+PLD_TEST_EXPORTS_API size_t generateHeadless(const InitialShapeNOPtrVector& initialShapes, const GenerateSetup& setup,
+                                             const std::vector<prt::Callbacks*>& callbacks, prt::Cache* prtCache);
@@ -17,11 +17,12 @@
 #include "ModelConverter.h"
 #include "AttributeConversion.h"
 #include "LogHandler.h"
-#include "MultiWatch.h"
 #include "ShapeConverter.h"
+#include "Tracing.h"
 
 #include "GU/GU_HoleInfo.h"
 
+#include <memory>
 #include <mutex>
 #include <variant>
 
@@ -55,7 +56,59 @@ void setVertexNormals(GA_RWHandleV3& handle, const GA_Detail::OffsetMarker& mark
 	}
 }
 
-std::mutex mDetailMutex; // guard the houdini detail object (and the hole groups)
+std::mutex mDetailMutex; // guard the houdini detail object (and the hole groups) without detail writer
+
+// owned copy of the arguments of HoudiniCallbacks::add for the detail writer, the encoder buffers are only valid
+// during the call
+struct Mesh {
+	std::wstring name;
+	std::vector<double> vtx;
+	std::vector<double> nrm;
+	std::vector<uint32_t> counts;
+	std::vector<uint32_t> holeCounts;
+	std::vector<uint32_t> holeIndices;
+	std::vector<uint32_t> vertexIndices;
+	std::vector<uint32_t> normalIndices;
+	std::vector<std::vector<double>> uvs;
+	std::vector<std::vector<uint32_t>> uvCounts;
+	std::vector<std::vector<uint32_t>> uvIndices;
+	std::vector<uint32_t> faceRanges;
+	std::vector<AttributeMapUPtr> materials;       // per face range, empty if not emitted
+	std::vector<AttributeMapUPtr> reports;         // per face range, empty if not emitted
+	std::vector<AttributeMapUPtr> shapeAttributes; // per face range, nullptr if the shape has no attributes
+
+	size_t getBytes() const {
+		size_t bytes = sizeof(Mesh) + (vtx.size() + nrm.size()) * sizeof(double);
+		bytes += (counts.size() + holeCounts.size() + holeIndices.size() + vertexIndices.size() +
+		          normalIndices.size() + faceRanges.size()) *
+		         sizeof(uint32_t);
+		for (size_t uvSet = 0; uvSet < uvs.size(); uvSet++)
+			bytes += uvs[uvSet].size() * sizeof(double) +
+			         (uvCounts[uvSet].size() + uvIndices[uvSet].size()) * sizeof(uint32_t);
+		return bytes;
+	}
+};
+
+template <typename T>
+std::vector<T> copyArray(const T* ptr, size_t size) {
+	return (ptr != nullptr) ? std::vector<T>(ptr, ptr + size) : std::vector<T>();
+}
+
+std::vector<AttributeMapUPtr> copyAttributeMaps(const prt::AttributeMap** maps, size_t count) {
+	std::vector<AttributeMapUPtr> copies;
+	if (maps == nullptr)
+		return copies;
+	copies.reserve(count);
+	for (size_t i = 0; i < count; i++) {
+		if (maps[i] == nullptr) {
+			copies.emplace_back();
+			continue;
+		}
+		const AttributeMapBuilderUPtr amb(prt::AttributeMapBuilder::createFromAttributeMap(maps[i]));
+		copies.emplace_back(amb->createAttributeMap());
+	}
+	return copies;
+}
 
 GA_Offset createPrimitives(GU_Detail* mDetail, PrimitiveGroups& holeGroups, GroupCreation gc, const wchar_t* name,
                            const double* vtx, size_t vtxSize, const double* nrm, size_t nrmSize, const uint32_t* counts,
@@ -65,7 +118,7 @@ GA_Offset createPrimitives(GU_Detail* mDetail, PrimitiveGroups& holeGroups, Grou
                            double const* const* uvs, size_t const* uvsSizes, uint32_t const* const* uvCounts,
                            size_t const* uvCountsSizes, uint32_t const* const* uvIndices, size_t const* uvIndicesSizes,
                            uint32_t uvSets) {
-	WA("all");
+	PLD_TRACE_SCOPE("detail write");
 
 	// -- create primitives
 	const GA_Detail::OffsetMarker marker(*mDetail);
@@ -179,11 +232,85 @@ GA_Offset createPrimitives(GU_Detail* mDetail, PrimitiveGroups& holeGroups, Grou
 	return primStartOffset;
 }
 
+// materials/reports are nullptr if not emitted, shapeAttributes is empty if no shape has attributes
+void convertFaceRangeAttributes(GU_Detail* detail, GA_Offset primStartOffset, const uint32_t* faceRanges,
+                                size_t faceRangesSize, const prt::AttributeMap* const* materials,
+                                const prt::AttributeMap* const* reports,
+                                const std::vector<AttributeMapUPtr>& shapeAttributes) {
+	if constexpr (DBG)
+		LOG_DBG << "got " << faceRangesSize - 1 << " face ranges";
+	if (faceRangesSize > 1) {
+		PLD_TRACE_SCOPE("materials/reports");
+
+		AttributeConversion::ToHoudini toHoudini(detail);
+		for (size_t fri = 0; fri < faceRangesSize - 1; fri++) {
+			const GA_Offset rangeStart = primStartOffset + faceRanges[fri];
+			const GA_Size rangeSize = faceRanges[fri + 1] - faceRanges[fri];
+
+			if (materials != nullptr) {
+				toHoudini.convert(materials[fri], rangeStart, rangeSize);
+			}
+
+			if (reports != nullptr) {
+				toHoudini.convert(reports[fri], rangeStart, rangeSize);
+			}
+
+			if (!shapeAttributes.empty() && shapeAttributes[fri]) {
+				toHoudini.convert(shapeAttributes[fri].get(), rangeStart, rangeSize,
+				                  AttributeConversion::ToHoudini::ArrayHandling::ARRAY);
+			}
+		}
+	}
+}
+
+std::vector<const prt::AttributeMap*> toPtrVec(const std::vector<AttributeMapUPtr>& maps) {
+	std::vector<const prt::AttributeMap*> pv(maps.size());
+	for (size_t i = 0; i < maps.size(); i++)
+		pv[i] = maps[i].get();
+	return pv;
+}
+
+void writeMesh(GU_Detail* detail, PrimitiveGroups& holeGroups, GroupCreation gc, const Mesh& m,
+               InitialShapeStatistics* shapeStatistics) {
+	const uint32_t uvSets = static_cast<uint32_t>(m.uvs.size());
+	std::vector<const double*> uvs(uvSets);
+	std::vector<size_t> uvsSizes(uvSets);
+	std::vector<const uint32_t*> uvCounts(uvSets);
+	std::vector<size_t> uvCountsSizes(uvSets);
+	std::vector<const uint32_t*> uvIndices(uvSets);
+	std::vector<size_t> uvIndicesSizes(uvSets);
+	for (uint32_t uvSet = 0; uvSet < uvSets; uvSet++) {
+		uvs[uvSet] = m.uvs[uvSet].data();
+		uvsSizes[uvSet] = m.uvs[uvSet].size();
+		uvCounts[uvSet] = m.uvCounts[uvSet].data();
+		uvCountsSizes[uvSet] = m.uvCounts[uvSet].size();
+		uvIndices[uvSet] = m.uvIndices[uvSet].data();
+		uvIndicesSizes[uvSet] = m.uvIndices[uvSet].size();
+	}
+
+	const GA_Offset primStartOffset = createPrimitives(
+	        detail, holeGroups, gc, m.name.c_str(), m.vtx.data(), m.vtx.size(), m.nrm.data(), m.nrm.size(),
+	        m.counts.data(), m.counts.size(), m.holeCounts.data(), m.holeCounts.size(), m.holeIndices.data(),
+	        m.holeIndices.size(), m.vertexIndices.data(), m.vertexIndices.size(), m.normalIndices.data(),
+	        m.normalIndices.size(), uvs.data(), uvsSizes.data(), uvCounts.data(), uvCountsSizes.data(),
+	        uvIndices.data(), uvIndicesSizes.data(), uvSets);
+
+	if (shapeStatistics != nullptr)
+		shapeStatistics->primitiveRanges.emplace_back(primStartOffset, static_cast<GA_Size>(m.counts.size()));
+
+	const std::vector<const prt::AttributeMap*> materials = toPtrVec(m.materials);
+	const std::vector<const prt::AttributeMap*> reports = toPtrVec(m.reports);
+	convertFaceRangeAttributes(detail, primStartOffset, m.faceRanges.data(), m.faceRanges.size(),
+	                           materials.empty() ? nullptr : materials.data(),
+	                           reports.empty() ? nullptr : reports.data(), m.shapeAttributes);
+}
+
 } // namespace
 
 ModelConverter::ModelConverter(GU_Detail* detail, GroupCreation gc, std::vector<prt::Status>& statuses,
-                               UT_AutoInterrupt* autoInterrupt)
-    : mDetail(detail), mGroupCreation(gc), mStatuses(statuses), mAutoInterrupt(autoInterrupt) {}
+                               UT_AutoInterrupt* autoInterrupt, DetailWriter* detailWriter)
+    : mDetail(detail), mGroupCreation(gc), mStatuses(statuses), mAutoInterrupt(autoInterrupt),
+      mDetailWriter(detailWriter) {}
 
 void ModelConverter::buildHoles() {
 	// after all meshes have been added, we can run buildHoles (which might delete some prims)
@@ -201,45 +328,69 @@ void ModelConverter::add(const wchar_t* name, const double* vtx, size_t vtxSize,
                          uint32_t uvSets, const uint32_t* faceRanges, size_t faceRangesSize,
                          const prt::AttributeMap** materials, const prt::AttributeMap** reports,
                          const int32_t* shapeIDs) {
+	const size_t faceRangeCount = (faceRangesSize > 0) ? faceRangesSize - 1 : 0;
+
+	// implicit contract: the attr{Bool,Float,String} callbacks are called prior to ModelConverter::add
+	std::vector<AttributeMapUPtr> shapeAttributes;
+	if (!mShapeAttributeBuilders.empty()) {
+		for (size_t fri = 0; fri < faceRangeCount; fri++) {
+			auto it = mShapeAttributeBuilders.find(shapeIDs[fri]);
+			shapeAttributes.emplace_back((it != mShapeAttributeBuilders.end()) ? it->second->createAttributeMap()
+			                                                                    : nullptr);
+		}
+	}
+
+	// changes with the next initial shape
+	InitialShapeStatistics* shapeStatistics = mShapeStatistics.add(faceRangesSize, countsSize, vertexIndicesSize);
+	if (mDetailWriter != nullptr) {
+		const auto enqueueBegin = std::chrono::steady_clock::now();
+
+		// the writer thread runs after this call returns, i.e. it needs a copy of the encoder buffers
+		Mesh m;
+		m.name = name;
+		m.vtx = copyArray(vtx, vtxSize);
+		m.nrm = copyArray(nrm, nrmSize);
+		m.counts = copyArray(counts, countsSize);
+		m.holeCounts = copyArray(holeCounts, holeCountsSize);
+		m.holeIndices = copyArray(holeIndices, holeIndicesSize);
+		m.vertexIndices = copyArray(vertexIndices, vertexIndicesSize);
+		m.normalIndices = copyArray(normalIndices, normalIndicesSize);
+		for (uint32_t uvSet = 0; uvSet < uvSets; uvSet++) {
+			m.uvs.emplace_back(copyArray(uvs[uvSet], uvsSizes[uvSet]));
+			m.uvCounts.emplace_back(copyArray(uvCounts[uvSet], uvCountsSizes[uvSet]));
+			m.uvIndices.emplace_back(copyArray(uvIndices[uvSet], uvIndicesSizes[uvSet]));
+		}
+		m.faceRanges = copyArray(faceRanges, faceRangesSize);
+		m.materials = copyAttributeMaps(materials, faceRangeCount);
+		m.reports = copyAttributeMaps(reports, faceRangeCount);
+		m.shapeAttributes = std::move(shapeAttributes);
+
+		const size_t bytes = m.getBytes();
+		auto mesh = std::make_shared<const Mesh>(std::move(m)); // std::function needs a copyable write
+		mDetailWriter->enqueue(
+		        [this, mesh, shapeStatistics]() {
+			        writeMesh(mDetail, mHoleGroups, mGroupCreation, *mesh, shapeStatistics);
+		        },
+		        bytes);
+		mLockWaitTime += std::chrono::steady_clock::now() - enqueueBegin;
+		return;
+	}
+
 	// we need to protect mDetail, it is accessed by multiple generate threads
+	const auto lockBegin = std::chrono::steady_clock::now();
 	std::lock_guard<std::mutex> guard(mDetailMutex);
+	mLockWaitTime += std::chrono::steady_clock::now() - lockBegin;
 
 	const GA_Offset primStartOffset = createPrimitives(
 	        mDetail, mHoleGroups, mGroupCreation, name, vtx, vtxSize, nrm, nrmSize, counts, countsSize, holeCounts,
 	        holeCountsSize, holeIndices, holeIndicesSize, vertexIndices, vertexIndicesSize, normalIndices,
 	        normalIndicesSize, uvs, uvsSizes, uvCounts, uvCountsSizes, uvIndices, uvIndicesSizes, uvSets);
 
-	// -- convert materials/reports into primitive attributes based on face ranges
-	if constexpr (DBG)
-		LOG_DBG << "got " << faceRangesSize - 1 << " face ranges";
-	if (faceRangesSize > 1) {
-		WA("add materials/reports");
-
-		AttributeConversion::ToHoudini toHoudini(mDetail);
-		for (size_t fri = 0; fri < faceRangesSize - 1; fri++) {
-			const GA_Offset rangeStart = primStartOffset + faceRanges[fri];
-			const GA_Size rangeSize = faceRanges[fri + 1] - faceRanges[fri];
-
-			if (materials != nullptr) {
-				toHoudini.convert(materials[fri], rangeStart, rangeSize);
-			}
+	if (shapeStatistics != nullptr)
+		shapeStatistics->primitiveRanges.emplace_back(primStartOffset, static_cast<GA_Size>(countsSize));
 
-			if (reports != nullptr) {
-				toHoudini.convert(reports[fri], rangeStart, rangeSize);
-			}
-
-			if (!mShapeAttributeBuilders.empty()) {
-				// implicit contract: the attr{Bool,Float,String} callbacks are called prior to ModelConverter::add
-				const int32_t shapeID = shapeIDs[fri];
-				auto it = mShapeAttributeBuilders.find(shapeID);
-				if (it != mShapeAttributeBuilders.end()) {
-					const AttributeMapUPtr attrMap(it->second->createAttributeMap());
-					toHoudini.convert(attrMap.get(), rangeStart, rangeSize,
-					                  AttributeConversion::ToHoudini::ArrayHandling::ARRAY);
-				}
-			}
-		}
-	}
+	convertFaceRangeAttributes(mDetail, primStartOffset, faceRanges, faceRangesSize, materials, reports,
+	                           shapeAttributes);
 }
 
 prt::Status ModelConverter::generateError(size_t isIndex, prt::Status status, const wchar_t* message) {
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include "DetailWriter.h"
+#include "GeometryStatistics.h"
 #include "PalladioMain.h"
 #include "ShapeConverter.h"
 #include "Utils.h"
@@ -39,7 +41,9 @@
 #	pragma GCC diagnostic pop
 #endif
 
+#include <chrono>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace ModelConversion {
@@ -65,15 +69,36 @@ struct PrimitiveGroupDestroyer {
 using PrimitiveGroupUPtr = std::unique_ptr<GA_PrimitiveGroup, PrimitiveGroupDestroyer>;
 using PrimitiveGroups = std::vector<PrimitiveGroupUPtr>;
 
+struct InitialShapeStatistics : GeometryStatistics {
+	double generateTime = 0.0; // in seconds, includes encoding
+	std::vector<std::pair<GA_Offset, GA_Size>> primitiveRanges; // the generated primitives
+};
+
 class ModelConverter : public HoudiniCallbacks {
 public:
+	// without detail writer, add writes into the detail on the calling thread (serialized by a global lock)
 	explicit ModelConverter(GU_Detail* gdp, GroupCreation gc, std::vector<prt::Status>& statuses,
-	                        UT_AutoInterrupt* autoInterrupt = nullptr);
+	                        UT_AutoInterrupt* autoInterrupt = nullptr, DetailWriter* detailWriter = nullptr);
 	~ModelConverter() override = default;
 
 	void buildHoles();
 
+	// accumulated time the add callback waited for the detail or, with detail writer, for its queue
+	std::chrono::duration<double> getLockWaitTime() const {
+		return mLockWaitTime;
+	}
+
+	// the geometry passed to add is counted towards shapeStatistics[isIndex] of the initial shape announced by
+	// beginInitialShape (nullptr: no statistics)
+	void setShapeStatistics(InitialShapeStatistics* shapeStatistics) {
+		mShapeStatistics.setStatistics(shapeStatistics);
+	}
+
 protected:
+	void beginInitialShape(size_t isIndex) override {
+		mShapeStatistics.beginInitialShape(isIndex);
+	}
+
 	void add(const wchar_t* name, const double* vtx, size_t vtxSize, const double* nrm, size_t nrmSize,
 	         const uint32_t* counts, size_t countsSize, const uint32_t* holeCounts, size_t holeCountsSize,
 	         const uint32_t* holeIndices, size_t holeIndicesSize, const uint32_t* vertexIndices,
@@ -131,6 +156,9 @@ private:
 	std::vector<prt::Status>& mStatuses;
 	UT_AutoInterrupt* mAutoInterrupt;
 	std::map<int32_t, AttributeMapBuilderUPtr> mShapeAttributeBuilders;
+	std::chrono::duration<double> mLockWaitTime{0.0};
+	GeometryStatisticsCounter<InitialShapeStatistics> mShapeStatistics;
+	DetailWriter* mDetailWriter;
 };
 
 using ModelConverterUPtr = std::unique_ptr<ModelConverter>;
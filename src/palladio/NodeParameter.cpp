@@ -25,6 +25,8 @@
 
 #include "CH/CH_Manager.h"
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
 #include <random>
 #include <string>
@@ -122,7 +124,8 @@ int updateRPK(void* data, int, fpreal32 time, const PRM_Template*) {
 	node->evalString(utNextRPKStr, AssignNodeParams::RPK.getToken(), 0, time);
 	const std::filesystem::path nextRPK(utNextRPKStr.toStdString());
 
-	ResolveMapSPtr resolveMap = prtCtx->getResolveMap(nextRPK);
+	// explicit (re)load by the user, always check for a changed RPK
+	ResolveMapSPtr resolveMap = prtCtx->getResolveMap(nextRPK, ResolveMapCache::Validation::FORCED);
 	if (!resolveMap) {
 		LOG_WRN << "invalid resolve map";
 		return NOT_CHANGED;
@@ -157,9 +160,6 @@ int updateRPK(void* data, int, fpreal32 time, const PRM_Template*) {
 	AssignNodeParams::setStyle(node, startRuleStyle, time);
 	AssignNodeParams::setStartRule(node, startRuleName, time);
 
-	// reset was successful, try to optimize the cache
-	prtCtx->mPRTCache->flushAll();
-
 	return CHANGED;
 }
 
@@ -337,4 +337,90 @@ GroupCreation getGroupCreation(const OP_Node* node, fpreal t) {
 	}
 };
 
+ShapeStatistics getShapeStatistics(const OP_Node* node, fpreal t) {
+	const auto ord = node->evalInt(SHAPE_STATISTICS.getToken(), 0, t);
+	switch (ord) {
+		case 1:
+			return ShapeStatistics::GENERATED;
+		case 2:
+			return ShapeStatistics::INITIAL_SHAPES;
+		default:
+			return ShapeStatistics::NONE;
+	}
+}
+
+Sharding::Selection getShardSelection(const OP_Node* node, fpreal t) {
+	Sharding::Selection selection;
+	selection.count = static_cast<size_t>(std::max<exint>(node->evalInt(SHARD_COUNT.getToken(), 0, t), 1));
+	selection.index = static_cast<size_t>(std::max<exint>(node->evalInt(SHARD_INDEX.getToken(), 0, t), 0));
+	selection.neighbourOccluders = (node->evalInt(SHARD_NEIGHBOURS.getToken(), 0, t) > 0);
+	selection.neighbourDistance = std::max(node->evalFloat(SHARD_NEIGHBOUR_DISTANCE.getToken(), 0, t), 0.0);
+	return selection;
+}
+
+size_t getWorkerProcesses(const OP_Node* node, fpreal t) {
+	return static_cast<size_t>(std::max<exint>(node->evalInt(WORKER_PROCESSES.getToken(), 0, t), 0));
+}
+
+bool getDeduplicateShapes(const OP_Node* node, fpreal t) {
+	return (node->evalInt(DEDUPLICATE_SHAPES.getToken(), 0, t) > 0);
+}
+
+RegionOfInterest::Selection getRegionOfInterest(const OP_Node* node, fpreal t) {
+	RegionOfInterest::Selection selection;
+	switch (node->evalInt(ROI_MODE.getToken(), 0, t)) {
+		case 1:
+			selection.mode = RegionOfInterest::Mode::BOUNDING_BOX;
+			break;
+		case 2:
+			selection.mode = RegionOfInterest::Mode::CAMERA_FRUSTUM;
+			break;
+		case 3:
+			selection.mode = RegionOfInterest::Mode::PRIMITIVE_GROUP;
+			break;
+		default:
+			selection.mode = RegionOfInterest::Mode::NONE;
+			break;
+	}
+	selection.outside = (node->evalInt(ROI_OUTSIDE.getToken(), 0, t) == 1) ? RegionOfInterest::Outside::PASS_THROUGH
+	                                                                        : RegionOfInterest::Outside::SKIP;
+
+	for (int axis = 0; axis < 3; axis++) {
+		const double center = node->evalFloat(ROI_CENTER.getToken(), axis, t);
+		const double halfSize = std::abs(node->evalFloat(ROI_SIZE.getToken(), axis, t)) / 2.0;
+		selection.box.min[axis] = center - halfSize;
+		selection.box.max[axis] = center + halfSize;
+	}
+
+	UT_String s;
+	node->evalString(s, ROI_CAMERA.getToken(), 0, t);
+	selection.camera = s.toStdString();
+	node->evalString(s, ROI_GROUP.getToken(), 0, t);
+	selection.group = s.toStdString();
+	return selection;
+}
+
+Preview::Settings getPreview(const OP_Node* node, fpreal t) {
+	Preview::Settings settings;
+	switch (node->evalInt(GENERATION_MODE.getToken(), 0, t)) {
+		case 1:
+			settings.mode = Preview::Mode::FOOTPRINTS;
+			break;
+		case 2:
+			settings.mode = Preview::Mode::START_RULE;
+			break;
+		default:
+			settings.mode = Preview::Mode::FULL;
+			break;
+	}
+
+	UT_String s;
+	node->evalString(s, PREVIEW_HEIGHT_ATTR.getToken(), 0, t);
+	settings.heightAttribute = toUTF16FromOSNarrow(s.toStdString());
+	settings.defaultHeight = std::max(node->evalFloat(PREVIEW_HEIGHT.getToken(), 0, t), 0.0);
+	node->evalString(s, PREVIEW_START_RULE.getToken(), 0, t);
+	settings.startRule = toUTF16FromOSNarrow(s.toStdString());
+	return settings;
+}
+
 } // namespace GenerateNodeParams
\ No newline at end of file
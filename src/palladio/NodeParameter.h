@@ -16,8 +16,11 @@
 
 #pragma once
 
+#include "Preview.h"
 #include "PrimitiveClassifier.h"
+#include "RegionOfInterest.h"
 #include "ShapeConverter.h"
+#include "Sharding.h"
 #include "Utils.h"
 
 #include "GA/GA_Types.h"
@@ -153,6 +156,115 @@ static PRM_Default DEFAULT_GROUP_CREATION(0, GROUP_CREATION_TOKENS[DEFAULT_GROUP
 
 GroupCreation getGroupCreation(const OP_Node* node, fpreal t);
 
+static PRM_Name SHAPE_STATISTICS("shapeStats", "Shape Statistics");
+static const char* SHAPE_STATISTICS_TOKENS[] = {"NONE", "GENERATED", "INITIAL_SHAPES"};
+static const char* SHAPE_STATISTICS_LABELS[] = {"Do not record", "Record on generated primitives",
+                                                "Record on initial shapes (skips output geometry)"};
+static PRM_Name SHAPE_STATISTICS_MENU_ITEMS[] = {PRM_Name(SHAPE_STATISTICS_TOKENS[0], SHAPE_STATISTICS_LABELS[0]),
+                                                 PRM_Name(SHAPE_STATISTICS_TOKENS[1], SHAPE_STATISTICS_LABELS[1]),
+                                                 PRM_Name(SHAPE_STATISTICS_TOKENS[2], SHAPE_STATISTICS_LABELS[2]),
+                                                 PRM_Name(nullptr)};
+static PRM_ChoiceList shapeStatisticsMenu((PRM_ChoiceListType)(PRM_CHOICELIST_EXCLUSIVE | PRM_CHOICELIST_REPLACE),
+                                          SHAPE_STATISTICS_MENU_ITEMS);
+static PRM_Default DEFAULT_SHAPE_STATISTICS(0, SHAPE_STATISTICS_TOKENS[0]);
+
+ShapeStatistics getShapeStatistics(const OP_Node* node, fpreal t);
+
+// -- SHARDING
+static PRM_Name SHARD_INDEX("shardIndex", "Shard Index");
+static PRM_Range SHARD_INDEX_RANGE(PRM_RANGE_RESTRICTED, 0, PRM_RANGE_UI, 15);
+const std::string SHARD_INDEX_HELP = "Only generates the initial shapes of this shard (0 to shard count - 1). The "
+                                     "shards are derived from the primitive classifier value (or the geometry of "
+                                     "unclassified primitives), every machine of a farm computes the same shards.";
+static PRM_Name SHARD_COUNT("shardCount", "Shard Count");
+static PRM_Range SHARD_COUNT_RANGE(PRM_RANGE_RESTRICTED, 1, PRM_RANGE_UI, 16);
+const std::string SHARD_COUNT_HELP = "Number of shards the initial shapes are split into, 1 generates all shapes.";
+static PRM_Name SHARD_NEIGHBOURS("shardNeighbours", "Neighbour Occluders");
+const std::string SHARD_NEIGHBOURS_HELP = "Adds the initial shapes of other shards near the shard to the occlusion "
+                                          "queries, so occlusion at the shard boundaries matches the unsharded "
+                                          "result. The neighbours are not generated.";
+static PRM_Name SHARD_NEIGHBOUR_DISTANCE("shardNeighbourDistance", "Neighbour Distance");
+static PRM_Range SHARD_NEIGHBOUR_DISTANCE_RANGE(PRM_RANGE_RESTRICTED, 0.0, PRM_RANGE_UI, 100.0);
+static PRM_Default DEFAULT_SHARD_NEIGHBOUR_DISTANCE(10.0);
+
+Sharding::Selection getShardSelection(const OP_Node* node, fpreal t);
+
+// -- WORKER PROCESSES
+static PRM_Name WORKER_PROCESSES("workerProcesses", "Worker Processes");
+static PRM_Range WORKER_PROCESSES_RANGE(PRM_RANGE_RESTRICTED, 0, PRM_RANGE_UI, 16);
+const std::string WORKER_PROCESSES_HELP =
+        "Generates in this number of local worker processes instead of inside Houdini (0: off). Each worker generates "
+        "a contiguous part of the initial shapes, occlusion queries only see the shapes of the same worker. A crashing "
+        "worker only fails its own initial shapes. Shape statistics are not supported in worker processes.";
+
+size_t getWorkerProcesses(const OP_Node* node, fpreal t);
+
+// -- DEDUPLICATION
+static PRM_Name DEDUPLICATE_SHAPES("deduplicateShapes", "Deduplicate Initial Shapes");
+const std::string DEDUPLICATE_SHAPES_HELP =
+        "Generates initial shapes which only differ by a translation (same geometry, rule, start rule, seed and rule "
+        "attributes) once and copies the result to the others. Only enable this if the rules do not depend on the "
+        "position, e.g. through occlusion queries. Not supported with shape statistics or worker processes.";
+
+bool getDeduplicateShapes(const OP_Node* node, fpreal t);
+
+// -- REGION OF INTEREST
+static PRM_Name ROI_MODE("roiMode", "Region of Interest");
+static const char* ROI_MODE_TOKENS[] = {"NONE", "BOUNDING_BOX", "CAMERA_FRUSTUM", "PRIMITIVE_GROUP"};
+static const char* ROI_MODE_LABELS[] = {"All initial shapes", "Bounding box", "Camera frustum", "Primitive group"};
+static PRM_Name ROI_MODE_MENU_ITEMS[] = {PRM_Name(ROI_MODE_TOKENS[0], ROI_MODE_LABELS[0]),
+                                         PRM_Name(ROI_MODE_TOKENS[1], ROI_MODE_LABELS[1]),
+                                         PRM_Name(ROI_MODE_TOKENS[2], ROI_MODE_LABELS[2]),
+                                         PRM_Name(ROI_MODE_TOKENS[3], ROI_MODE_LABELS[3]), PRM_Name(nullptr)};
+static PRM_ChoiceList roiModeMenu((PRM_ChoiceListType)(PRM_CHOICELIST_EXCLUSIVE | PRM_CHOICELIST_REPLACE),
+                                  ROI_MODE_MENU_ITEMS);
+static PRM_Default DEFAULT_ROI_MODE(0, ROI_MODE_TOKENS[0]);
+const std::string ROI_MODE_HELP = "Only generates the initial shapes intersecting the region of interest, e.g. to "
+                                  "iterate on one district of a city. Occlusion queries only see the initial shapes "
+                                  "inside the region.";
+static PRM_Name ROI_CENTER("roiCenter", "Region Center");
+static PRM_Name ROI_SIZE("roiSize", "Region Size");
+static PRM_Default DEFAULT_ROI_SIZE[] = {PRM_Default(100.0), PRM_Default(100.0), PRM_Default(100.0)};
+static PRM_Name ROI_CAMERA("roiCamera", "Region Camera");
+static PRM_Name ROI_GROUP("roiGroup", "Region Group");
+static PRM_Name ROI_OUTSIDE("roiOutside", "Outside of Region");
+static const char* ROI_OUTSIDE_TOKENS[] = {"SKIP", "PASS_THROUGH"};
+static const char* ROI_OUTSIDE_LABELS[] = {"Skip initial shapes", "Pass initial shapes through"};
+static PRM_Name ROI_OUTSIDE_MENU_ITEMS[] = {PRM_Name(ROI_OUTSIDE_TOKENS[0], ROI_OUTSIDE_LABELS[0]),
+                                            PRM_Name(ROI_OUTSIDE_TOKENS[1], ROI_OUTSIDE_LABELS[1]), PRM_Name(nullptr)};
+static PRM_ChoiceList roiOutsideMenu((PRM_ChoiceListType)(PRM_CHOICELIST_EXCLUSIVE | PRM_CHOICELIST_REPLACE),
+                                     ROI_OUTSIDE_MENU_ITEMS);
+static PRM_Default DEFAULT_ROI_OUTSIDE(0, ROI_OUTSIDE_TOKENS[0]);
+
+RegionOfInterest::Selection getRegionOfInterest(const OP_Node* node, fpreal t);
+
+// -- PREVIEW
+static PRM_Name GENERATION_MODE("generationMode", "Generation Mode");
+static const char* GENERATION_MODE_TOKENS[] = {"FULL", "FOOTPRINTS", "START_RULE"};
+static const char* GENERATION_MODE_LABELS[] = {"Full generation", "Preview: extruded footprints",
+                                               "Preview: preview start rule"};
+static PRM_Name GENERATION_MODE_MENU_ITEMS[] = {PRM_Name(GENERATION_MODE_TOKENS[0], GENERATION_MODE_LABELS[0]),
+                                                PRM_Name(GENERATION_MODE_TOKENS[1], GENERATION_MODE_LABELS[1]),
+                                                PRM_Name(GENERATION_MODE_TOKENS[2], GENERATION_MODE_LABELS[2]),
+                                                PRM_Name(nullptr)};
+static PRM_ChoiceList generationModeMenu((PRM_ChoiceListType)(PRM_CHOICELIST_EXCLUSIVE | PRM_CHOICELIST_REPLACE),
+                                         GENERATION_MODE_MENU_ITEMS);
+static PRM_Default DEFAULT_GENERATION_MODE(0, GENERATION_MODE_TOKENS[0]);
+const std::string GENERATION_MODE_HELP =
+        "The preview modes emit a cheap proxy per initial shape to keep the viewport responsive on large inputs, "
+        "switch to full generation for renders. Extruded footprints does not run the rules and extrudes each initial "
+        "shape to its height attribute. Preview start rule runs the rules from the preview start rule instead of the "
+        "start rule of the initial shapes, e.g. a rule only creating the bounding box of the building.";
+static PRM_Name PREVIEW_HEIGHT_ATTR("previewHeightAttr", "Preview Height Attribute");
+static PRM_Default DEFAULT_PREVIEW_HEIGHT_ATTR(0.0f, "height", CH_STRING_LITERAL);
+static PRM_Name PREVIEW_HEIGHT("previewHeight", "Preview Default Height");
+static PRM_Range PREVIEW_HEIGHT_RANGE(PRM_RANGE_RESTRICTED, 0.0, PRM_RANGE_UI, 100.0);
+static PRM_Default DEFAULT_PREVIEW_HEIGHT(10.0);
+static PRM_Name PREVIEW_START_RULE("previewStartRule", "Preview Start Rule");
+static PRM_Default DEFAULT_PREVIEW_START_RULE(0.0f, "Preview", CH_STRING_LITERAL);
+
+Preview::Settings getPreview(const OP_Node* node, fpreal t);
+
 static PRM_Name EMIT_ATTRS("emitAttrs", "Re-emit set CGA attributes");
 static PRM_Name EMIT_MATERIAL("emitMaterials", "Emit material attributes");
 static PRM_Name EMIT_REPORTS("emitReports", "Emit CGA reports");
@@ -163,6 +275,43 @@ static PRM_Template PARAM_TEMPLATES[]{PRM_Template(PRM_ORD, PRM_Template::PRM_EX
                                       PRM_Template(PRM_TOGGLE, 1, &EMIT_MATERIAL),
                                       PRM_Template(PRM_TOGGLE, 1, &EMIT_REPORTS),
                                       PRM_Template(PRM_TOGGLE, 1, &TRIANGULATE_FACES_WITH_HOLES, PRMoneDefaults),
+                                      PRM_Template(PRM_ORD, PRM_Template::PRM_EXPORT_MAX, 1, &SHAPE_STATISTICS,
+                                                   &DEFAULT_SHAPE_STATISTICS, &shapeStatisticsMenu),
+                                      PRM_Template(PRM_INT, 1, &SHARD_INDEX, PRMzeroDefaults, nullptr,
+                                                   &SHARD_INDEX_RANGE, PRM_Callback(), nullptr, 1,
+                                                   SHARD_INDEX_HELP.c_str()),
+                                      PRM_Template(PRM_INT, 1, &SHARD_COUNT, PRMoneDefaults, nullptr,
+                                                   &SHARD_COUNT_RANGE, PRM_Callback(), nullptr, 1,
+                                                   SHARD_COUNT_HELP.c_str()),
+                                      PRM_Template(PRM_TOGGLE | PRM_TYPE_JOIN_NEXT, 1, &SHARD_NEIGHBOURS,
+                                                   PRMzeroDefaults, nullptr, nullptr, PRM_Callback(), nullptr, 1,
+                                                   SHARD_NEIGHBOURS_HELP.c_str()),
+                                      PRM_Template(PRM_FLT, 1, &SHARD_NEIGHBOUR_DISTANCE,
+                                                   &DEFAULT_SHARD_NEIGHBOUR_DISTANCE, nullptr,
+                                                   &SHARD_NEIGHBOUR_DISTANCE_RANGE),
+                                      PRM_Template(PRM_INT, 1, &WORKER_PROCESSES, PRMzeroDefaults, nullptr,
+                                                   &WORKER_PROCESSES_RANGE, PRM_Callback(), nullptr, 1,
+                                                   WORKER_PROCESSES_HELP.c_str()),
+                                      PRM_Template(PRM_TOGGLE, 1, &DEDUPLICATE_SHAPES, PRMzeroDefaults, nullptr,
+                                                   nullptr, PRM_Callback(), nullptr, 1,
+                                                   DEDUPLICATE_SHAPES_HELP.c_str()),
+                                      PRM_Template(PRM_ORD, PRM_Template::PRM_EXPORT_MAX, 1, &ROI_MODE,
+                                                   &DEFAULT_ROI_MODE, &roiModeMenu, nullptr, PRM_Callback(), nullptr, 1,
+                                                   ROI_MODE_HELP.c_str()),
+                                      PRM_Template(PRM_XYZ, 3, &ROI_CENTER, PRMzeroDefaults),
+                                      PRM_Template(PRM_XYZ, 3, &ROI_SIZE, DEFAULT_ROI_SIZE),
+                                      PRM_Template(PRM_STRING, PRM_TYPE_DYNAMIC_PATH, 1, &ROI_CAMERA, nullptr, nullptr,
+                                                   nullptr, PRM_Callback(), &PRM_SpareData::objCameraPath),
+                                      PRM_Template(PRM_STRING, 1, &ROI_GROUP),
+                                      PRM_Template(PRM_ORD, PRM_Template::PRM_EXPORT_MAX, 1, &ROI_OUTSIDE,
+                                                   &DEFAULT_ROI_OUTSIDE, &roiOutsideMenu),
+                                      PRM_Template(PRM_ORD, PRM_Template::PRM_EXPORT_MAX, 1, &GENERATION_MODE,
+                                                   &DEFAULT_GENERATION_MODE, &generationModeMenu, nullptr,
+                                                   PRM_Callback(), nullptr, 1, GENERATION_MODE_HELP.c_str()),
+                                      PRM_Template(PRM_STRING, 1, &PREVIEW_HEIGHT_ATTR, &DEFAULT_PREVIEW_HEIGHT_ATTR),
+                                      PRM_Template(PRM_FLT, 1, &PREVIEW_HEIGHT, &DEFAULT_PREVIEW_HEIGHT, nullptr,
+                                                   &PREVIEW_HEIGHT_RANGE),
+                                      PRM_Template(PRM_STRING, 1, &PREVIEW_START_RULE, &DEFAULT_PREVIEW_START_RULE),
                                       PRM_Template(PRM_ORD, PRM_Template::PRM_EXPORT_MAX, 1,
                                                    &CommonNodeParams::LOG_LEVEL, &CommonNodeParams::DEFAULT_LOG_LEVEL,
                                                    &CommonNodeParams::logLevelMenu),
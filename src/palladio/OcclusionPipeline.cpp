@@ -0,0 +1,125 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "OcclusionPipeline.h"
+#include "LogHandler.h"
+#include "Tracing.h"
+
+#include "prt/API.h"
+
+#include <algorithm>
+
+namespace {
+
+constexpr size_t QUEUED_BATCHES_PER_CONSUMER = 2; // keeps the consumers busy while the producer fills the next batch
+
+} // namespace
+
+OcclusionPipeline::OcclusionPipeline(const std::vector<prt::Callbacks*>& callbacks, prt::Cache* cache,
+                                     const prt::AttributeMap* generateOptions, size_t batchSize)
+    : mCache(cache), mGenerateOptions(generateOptions), mBatchSize(std::max<size_t>(batchSize, 1)),
+      mOcclusionSet(prt::OcclusionSet::create()), mQueueCapacity(QUEUED_BATCHES_PER_CONSUMER * callbacks.size()),
+      mBusyTimes(callbacks.size(), CookReport::Duration(0.0)), mBegin(CookReport::Clock::now()) {
+	mConsumers.reserve(callbacks.size());
+	for (size_t ci = 0; ci < callbacks.size(); ci++)
+		mConsumers.emplace_back(&OcclusionPipeline::consume, this, callbacks[ci], std::ref(mBusyTimes[ci]));
+}
+
+OcclusionPipeline::~OcclusionPipeline() {
+	{
+		std::lock_guard<std::mutex> lock(mQueueMutex);
+		mClosed = true;
+	}
+	mQueueChanged.notify_all();
+	for (auto& c : mConsumers) {
+		if (c.joinable())
+			c.join();
+	}
+}
+
+void OcclusionPipeline::push(const prt::InitialShape* initialShape) {
+	if (mBatches.empty() || mBatches.back()->initialShapes.size() == mBatchSize) {
+		mBatches.emplace_back(std::make_unique<Batch>());
+		mBatches.back()->initialShapes.reserve(mBatchSize);
+	}
+	mBatches.back()->initialShapes.push_back(initialShape);
+	if (mBatches.back()->initialShapes.size() == mBatchSize)
+		enqueue();
+}
+
+std::vector<prt::OcclusionSet::Handle> OcclusionPipeline::finish(CookReport& cookReport) {
+	if (!mBatches.empty() && mBatches.back()->initialShapes.size() < mBatchSize)
+		enqueue(); // the last partial batch
+
+	{
+		std::lock_guard<std::mutex> lock(mQueueMutex);
+		mClosed = true;
+	}
+	mQueueChanged.notify_all();
+	for (auto& c : mConsumers)
+		c.join();
+
+	std::vector<prt::OcclusionSet::Handle> occlusionHandles;
+	for (const auto& b : mBatches)
+		occlusionHandles.insert(occlusionHandles.end(), b->occlusionHandles.begin(), b->occlusionHandles.end());
+
+	// the pass overlaps with the creation of the initial shapes, the wall time starts with the pipeline
+	const CookReport::Duration passTime = CookReport::Clock::now() - mBegin;
+	cookReport.addStage("occlusion", passTime);
+	cookReport.threadWallTime += passTime;
+	for (const auto& t : mBusyTimes)
+		cookReport.threadBusyTime += t;
+
+	return occlusionHandles;
+}
+
+void OcclusionPipeline::enqueue() {
+	Batch* batch = mBatches.back().get();
+	batch->occlusionHandles.resize(batch->initialShapes.size());
+	{
+		std::unique_lock<std::mutex> lock(mQueueMutex);
+		mQueueChanged.wait(lock, [this] { return mQueue.size() < mQueueCapacity; });
+		mQueue.push_back(batch);
+	}
+	mQueueChanged.notify_all();
+}
+
+void OcclusionPipeline::consume(prt::Callbacks* callbacks, CookReport::Duration& busyTime) {
+	while (true) {
+		Batch* batch = nullptr;
+		{
+			std::unique_lock<std::mutex> lock(mQueueMutex);
+			mQueueChanged.wait(lock, [this] { return !mQueue.empty() || mClosed; });
+			if (mQueue.empty())
+				return; // closed and drained
+			batch = mQueue.front();
+			mQueue.pop_front();
+		}
+		mQueueChanged.notify_all(); // the producer might wait for a free slot
+
+		PLD_TRACE_SCOPE("occlusion");
+		const auto batchBegin = CookReport::Clock::now();
+		const prt::Status status = prt::generateOccluders(
+		        batch->initialShapes.data(), batch->initialShapes.size(), batch->occlusionHandles.data(), nullptr, 0,
+		        nullptr, callbacks, mCache, mOcclusionSet.get(), mGenerateOptions);
+		busyTime += CookReport::Clock::now() - batchBegin;
+
+		if (status != prt::STATUS_OK) {
+			LOG_WRN << "occlusion pipeline batch failed with status: '" << prt::getStatusDescription(status) << "' ("
+			        << status << ")";
+		}
+	}
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "CookReport.h"
+#include "Utils.h"
+
+#include "prt/Callbacks.h"
+#include "prt/OcclusionSet.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * runs the occlusion pass while the initial shapes are still being created: the producer pushes the initial shapes,
+ * full batches go through a bounded queue to one consumer thread per callbacks instance, which generates their
+ * occluders into the shared occlusion set. the generation pass can only start after finish, because the occlusion
+ * queries need the occluders of all initial shapes.
+ */
+class PLD_TEST_EXPORTS_API OcclusionPipeline {
+public:
+	static constexpr size_t DEFAULT_BATCH_SIZE = 64;
+
+	// prt requires one callbacks instance per concurrent generate call, i.e. per consumer thread (at least one)
+	OcclusionPipeline(const std::vector<prt::Callbacks*>& callbacks, prt::Cache* cache,
+	                  const prt::AttributeMap* generateOptions, size_t batchSize = DEFAULT_BATCH_SIZE);
+	OcclusionPipeline(const OcclusionPipeline&) = delete;
+	OcclusionPipeline& operator=(const OcclusionPipeline&) = delete;
+	~OcclusionPipeline();
+
+	// blocks while the queue is full, i.e. the consumers limit the memory of the pending batches
+	void push(const prt::InitialShape* initialShape);
+
+	/**
+	 * waits for the occluders of all pushed initial shapes and adds the pass to the cook report. returns the occlusion
+	 * handles in push order, they belong to getOcclusionSet.
+	 */
+	std::vector<prt::OcclusionSet::Handle> finish(CookReport& cookReport);
+
+	OcclusionSetUPtr& getOcclusionSet() {
+		return mOcclusionSet;
+	}
+
+private:
+	struct Batch {
+		InitialShapeNOPtrVector initialShapes;
+		std::vector<prt::OcclusionSet::Handle> occlusionHandles;
+	};
+
+	void consume(prt::Callbacks* callbacks, CookReport::Duration& busyTime);
+	void enqueue();
+
+	prt::Cache* mCache;
+	const prt::AttributeMap* mGenerateOptions;
+	const size_t mBatchSize;
+	OcclusionSetUPtr mOcclusionSet;
+
+	std::vector<std::unique_ptr<Batch>> mBatches; // in push order, only touched by the producer
+	std::mutex mQueueMutex;
+	std::condition_variable mQueueChanged;
+	std::deque<Batch*> mQueue;
+	size_t mQueueCapacity;
+	bool mClosed = false;
+
+	std::vector<std::thread> mConsumers;
+	std::vector<CookReport::Duration> mBusyTimes;
+	CookReport::Clock::time_point mBegin;
+};
@@ -31,7 +31,6 @@
 #endif
 
 #include <algorithm>
-#include <mutex>
 #include <thread>
 
 #ifdef PLD_LINUX
@@ -136,7 +135,7 @@ std::filesystem::path getProcessTempDir() {
 PRTContext::PRTContext(const std::vector<std::filesystem::path>& addExtDirs)
     : mLogHandler(new logging::LogHandler(PLD_LOG_PREFIX)), mPRTHandle{nullptr},
       mPRTCache{prt::CacheObject::create(prt::CacheObject::CACHE_TYPE_DEFAULT)}, mCores{getNumCores()},
-      mResolveMapCache{new ResolveMapCache(getProcessTempDir())} {
+      mResolveMapCache{new ResolveMapCache(getProcessTempDir(), mPRTCache.get())} {
 	const prt::LogLevel defaultLogLevel = logging::getDefaultLogLevel();
 	prt::setLogLevel(defaultLogLevel);
 	prt::addLogHandler(mLogHandler.get());
@@ -187,6 +186,22 @@ PRTContext::PRTContext(const std::vector<std::filesystem::path>& addExtDirs)
 }
 
 PRTContext::~PRTContext() {
+	std::vector<std::future<void>> preloads;
+	{
+		std::lock_guard<std::mutex> lock(mPreloadMutex);
+		preloads.swap(mPreloads);
+	}
+	for (auto& f : preloads) // the preloads lock mPreloadMutex themselves
+		f.wait();
+
+	const ResolveMapCache::Statistics rmcStats = mResolveMapCache->getStatistics();
+	LOG_INF << "RPK Cache statistics: entries = " << rmcStats.entries << ", hits = " << rmcStats.hits
+	        << ", misses = " << rmcStats.misses << ", reloads = " << rmcStats.reloads
+	        << ", coalesced loads = " << rmcStats.coalescedLoads << ", validations = " << rmcStats.validations
+	        << ", load time = " << rmcStats.loadTime.count()
+	        << "s, flushed PRT cache entries = " << rmcStats.flushedPRTEntries << ", evictions = " << rmcStats.evictions
+	        << ", resident size = " << rmcStats.residentSize << " bytes";
+
 	mResolveMapCache.reset();
 	LOG_INF << "Released RPK Cache";
 
@@ -199,19 +214,55 @@ PRTContext::~PRTContext() {
 	prt::removeLogHandler(mLogHandler.get());
 }
 
-namespace {
-std::mutex mResolveMapCacheMutex;
-}
-
-ResolveMapSPtr PRTContext::getResolveMap(const std::filesystem::path& rpk) {
-	std::lock_guard<std::mutex> lock(mResolveMapCacheMutex);
-
-	auto lookupResult = mResolveMapCache->get(rpk.string());
-	if (lookupResult.second == ResolveMapCache::CacheStatus::MISS) {
-		mPRTCache->flushAll();
+ResolveMapSPtr PRTContext::getResolveMap(const std::filesystem::path& rpk, ResolveMapCache::Validation validation) {
+	auto lookupResult = mResolveMapCache->get(rpk.string(), validation);
+	if (lookupResult.second == ResolveMapCache::CacheStatus::MISS || takePreloadedMiss(rpk)) {
+		// note: the resolve map cache takes care of flushing the PRT cache entries of a changed RPK
 #ifndef PLD_TEST_EXPORTS
 		scheduleRecook(rpk);
 #endif
 	}
 	return lookupResult.first;
 }
+
+void PRTContext::preloadResolveMap(const std::filesystem::path& rpk) {
+	if (!isAlive() || rpk.empty())
+		return;
+
+	// reading a HDA needs Houdini, the first getResolveMap loads embedded RPKs on the main thread instead
+	if (ResolveMapCache::isEmbedded(rpk))
+		return;
+
+	std::lock_guard<std::mutex> lock(mPreloadMutex);
+
+	const auto isFinished = [](const std::future<void>& f) {
+		return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	};
+	mPreloads.erase(std::remove_if(mPreloads.begin(), mPreloads.end(), isFinished), mPreloads.end());
+
+	mPreloads.emplace_back(std::async(std::launch::async, [this, rpk]() {
+		// note: we must not touch any Houdini nodes from this thread, recooks are scheduled by the next getResolveMap
+		const ResolveMapCache::LookupResult lookupResult = mResolveMapCache->get(rpk);
+		if (!lookupResult.first)
+			return;
+		if (lookupResult.second == ResolveMapCache::CacheStatus::MISS) {
+			std::lock_guard<std::mutex> lock(mPreloadMutex);
+			mPreloadedMisses.emplace(ResolveMapCache::getKey(rpk));
+		}
+
+		// compile the rule file into the PRT cache, it is needed for the default attribute evaluation of the first cook
+		const auto cgb = getCGB(lookupResult.first);
+		if (!cgb)
+			return;
+		prt::Status status = prt::STATUS_UNSPECIFIED_ERROR;
+		const RuleFileInfoUPtr ruleFileInfo(prt::createRuleFileInfo(cgb->second.c_str(), mPRTCache.get(), &status));
+		LOG_DBG << "preloaded RPK " << rpk << ": " << prt::getStatusDescription(status);
+	}));
+}
+
+bool PRTContext::takePreloadedMiss(const std::filesystem::path& rpk) {
+	std::lock_guard<std::mutex> lock(mPreloadMutex);
+	if (mPreloadedMisses.empty())
+		return false;
+	return mPreloadedMisses.erase(ResolveMapCache::getKey(rpk)) > 0;
+}
@@ -23,7 +23,10 @@
 #include "prt/Object.h"
 
 #include <filesystem>
+#include <future>
 #include <map>
+#include <mutex>
+#include <set>
 
 namespace logging {
 class LogHandler;
@@ -41,7 +44,15 @@ struct PLD_TEST_EXPORTS_API PRTContext final {
 	PRTContext& operator=(PRTContext&&) = delete;
 	~PRTContext();
 
-	ResolveMapSPtr getResolveMap(const std::filesystem::path& rpk);
+	ResolveMapSPtr getResolveMap(const std::filesystem::path& rpk,
+	                             ResolveMapCache::Validation validation = ResolveMapCache::Validation::THROTTLED);
+
+	/**
+	 * loads the resolve map and compiles the rule file of a RPK into the PRT cache in the background.
+	 * a subsequent getResolveMap only waits for the part of the loading which has not yet finished.
+	 */
+	void preloadResolveMap(const std::filesystem::path& rpk);
+
 	bool isAlive() const {
 		return mPRTHandle.operator bool();
 	}
@@ -51,6 +62,13 @@ struct PLD_TEST_EXPORTS_API PRTContext final {
 	CacheObjectUPtr mPRTCache;
 	const uint32_t mCores;
 	ResolveMapCacheUPtr mResolveMapCache;
+
+private:
+	bool takePreloadedMiss(const std::filesystem::path& rpk);
+
+	std::mutex mPreloadMutex;
+	std::vector<std::future<void>> mPreloads;
+	std::set<ResolveMapCache::KeyType> mPreloadedMisses; // RPKs loaded by a preload, the recook is still pending
 };
 
 using PRTContextUPtr = std::unique_ptr<PRTContext>;
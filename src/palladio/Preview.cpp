@@ -0,0 +1,189 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Preview.h"
+
+#include "prt/InitialShape.h"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t HOLE_DELIMITER = std::numeric_limits<uint32_t>::max(); // ends the faces of a polygon in the holes
+
+using Ring = std::vector<uint32_t>; // point indices
+
+// y component of the (unnormalized) newell normal, positive if the ring is counter-clockwise seen from above
+double getUpwardness(const Ring& ring, const double* vtx) {
+	double ny = 0.0;
+	for (size_t i = 0; i < ring.size(); i++) {
+		const double* a = &vtx[ring[i] * 3];
+		const double* b = &vtx[ring[(i + 1) % ring.size()] * 3];
+		ny += (a[2] - b[2]) * (a[0] + b[0]);
+	}
+	return ny;
+}
+
+// the outer ring followed by its holes, per polygon of the initial shape
+std::vector<std::vector<Ring>> getPolygons(const prt::InitialShape* initialShape) {
+	const uint32_t* indices = initialShape->getIndices();
+	const uint32_t* faceCounts = initialShape->getFaceCounts();
+	const size_t faceCount = initialShape->getFaceCountsCount();
+
+	std::vector<Ring> faces(faceCount);
+	size_t index = 0;
+	for (size_t fi = 0; fi < faceCount; fi++) {
+		faces[fi].assign(indices + index, indices + index + faceCounts[fi]);
+		index += faceCounts[fi];
+	}
+
+	std::vector<std::vector<Ring>> polygons;
+	const uint32_t* holes = initialShape->getHoles();
+	const size_t holesCount = initialShape->getHolesCount();
+	if (holesCount == 0) {
+		for (Ring& face : faces)
+			polygons.push_back({std::move(face)});
+		return polygons;
+	}
+
+	std::vector<Ring> polygon;
+	for (size_t hi = 0; hi < holesCount; hi++) {
+		if (holes[hi] == HOLE_DELIMITER) {
+			if (!polygon.empty())
+				polygons.push_back(std::move(polygon));
+			polygon.clear();
+		}
+		else if (holes[hi] < faces.size())
+			polygon.push_back(faces[holes[hi]]);
+	}
+	return polygons;
+}
+
+class MeshBuilder {
+public:
+	void addFace(const Ring& ring, uint32_t offset, bool reversed) {
+		counts.push_back(static_cast<uint32_t>(ring.size()));
+		holeCounts.push_back(0);
+		if (reversed)
+			std::transform(ring.rbegin(), ring.rend(), std::back_inserter(vertexIndices),
+			               [offset](uint32_t i) { return i + offset; });
+		else
+			std::transform(ring.begin(), ring.end(), std::back_inserter(vertexIndices),
+			               [offset](uint32_t i) { return i + offset; });
+	}
+
+	// the first ring is the face, the others its holes
+	void addFaceWithHoles(const std::vector<Ring>& rings, uint32_t offset, bool reversed) {
+		const size_t faceIndex = counts.size();
+		for (const Ring& ring : rings)
+			addFace(ring, offset, reversed);
+		holeCounts[faceIndex] = static_cast<uint32_t>(rings.size() - 1);
+		for (size_t hi = 1; hi < rings.size(); hi++)
+			holeIndices.push_back(static_cast<uint32_t>(faceIndex + hi));
+	}
+
+	std::vector<uint32_t> counts;
+	std::vector<uint32_t> vertexIndices;
+	std::vector<uint32_t> holeCounts; // per face
+	std::vector<uint32_t> holeIndices;
+};
+
+} // namespace
+
+namespace Preview {
+
+double getHeight(const prt::InitialShape* initialShape, const std::wstring& attribute, double defaultHeight) {
+	const prt::AttributeMap* attributes = initialShape->getAttributeMap();
+	if (attributes == nullptr)
+		return defaultHeight;
+
+	const std::wstring styledSuffix = L'$' + attribute;
+	size_t keyCount = 0;
+	const wchar_t* const* keys = attributes->getKeys(&keyCount);
+	for (size_t k = 0; k < keyCount; k++) {
+		const std::wstring key = keys[k];
+		const bool matches = (key == attribute) || (key.size() > styledSuffix.size() &&
+		                                            key.compare(key.size() - styledSuffix.size(), styledSuffix.size(),
+		                                                        styledSuffix) == 0);
+		if (!matches)
+			continue;
+		switch (attributes->getType(keys[k])) {
+			case prt::Attributable::PT_FLOAT:
+				return attributes->getFloat(keys[k]);
+			case prt::Attributable::PT_INT:
+				return attributes->getInt(keys[k]);
+			default:
+				break;
+		}
+	}
+	return defaultHeight;
+}
+
+void addExtrudedFootprint(HoudiniCallbacks& callbacks, const prt::InitialShape* initialShape, double height) {
+	const double* footprint = initialShape->getVertices();
+	const size_t footprintSize = initialShape->getVertexCount();
+	const auto pointCount = static_cast<uint32_t>(footprintSize / 3);
+	if (pointCount == 0)
+		return;
+
+	std::vector<double> vtx(footprint, footprint + footprintSize);
+	const bool extrude = (height > 0.0);
+	if (extrude) {
+		for (size_t i = 0; i < footprintSize; i += 3) {
+			vtx.push_back(footprint[i]);
+			vtx.push_back(footprint[i + 1] + height);
+			vtx.push_back(footprint[i + 2]);
+		}
+	}
+	const uint32_t top = extrude ? pointCount : 0;
+
+	// houdini expects clockwise faces, the outer rings are made counter-clockwise and the holes clockwise (seen from
+	// above), so the walls of all rings can be built the same way
+	MeshBuilder mb;
+	for (std::vector<Ring>& rings : getPolygons(initialShape)) {
+		for (size_t ri = 0; ri < rings.size(); ri++) {
+			const double upwardness = getUpwardness(rings[ri], footprint);
+			if ((ri == 0) ? (upwardness < 0.0) : (upwardness > 0.0))
+				std::reverse(rings[ri].begin(), rings[ri].end());
+		}
+
+		mb.addFaceWithHoles(rings, top, true);
+		if (!extrude)
+			continue;
+		mb.addFaceWithHoles(rings, 0, false);
+		for (const Ring& ring : rings) {
+			for (size_t i = 0; i < ring.size(); i++) {
+				const uint32_t a = ring[i];
+				const uint32_t b = ring[(i + 1) % ring.size()];
+				mb.addFace({a + top, b + top, b, a}, 0, false);
+			}
+		}
+	}
+	if (mb.holeIndices.empty())
+		mb.holeCounts.clear();
+
+	const uint32_t faceRanges[] = {0, static_cast<uint32_t>(mb.counts.size())};
+	const int32_t shapeIDs[] = {0};
+	callbacks.add(initialShape->getName(), vtx.data(), vtx.size(), nullptr, 0, mb.counts.data(), mb.counts.size(),
+	              mb.holeCounts.data(), mb.holeCounts.size(), mb.holeIndices.data(), mb.holeIndices.size(),
+	              mb.vertexIndices.data(), mb.vertexIndices.size(), nullptr, 0, nullptr, nullptr, nullptr, nullptr,
+	              nullptr, nullptr, 0, faceRanges, 2, nullptr, nullptr, shapeIDs);
+}
+
+} // namespace Preview
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Utils.h"
+#include "encoder/HoudiniCallbacks.h"
+
+#include <string>
+
+/**
+ * cheap proxies of the generated models to keep the viewport responsive on whole cities, generate renders with
+ * Mode::FULL
+ */
+namespace Preview {
+
+enum class Mode {
+	FULL,       // runs the rules
+	FOOTPRINTS, // extrudes the initial shapes to a height attribute, without running the rules
+	START_RULE  // runs the rules from a lightweight start rule instead, e.g. one creating bounding boxes
+};
+
+struct Settings {
+	Mode mode = Mode::FULL;
+	std::wstring heightAttribute = L"height"; // FOOTPRINTS, primitive attribute of the initial shapes
+	double defaultHeight = 10.0;              // FOOTPRINTS, if the attribute is missing
+	std::wstring startRule = L"Preview";      // START_RULE, without style the style of the initial shape is used
+};
+
+// the value of the (rule) attribute of the initial shape, the style prefix of the attribute name is ignored
+PLD_TEST_EXPORTS_API double getHeight(const prt::InitialShape* initialShape, const std::wstring& attribute,
+                                      double defaultHeight);
+
+/**
+ * adds the initial shape extruded along the y axis to the callbacks, like the encoder adds a generated model: the
+ * top and bottom faces (with the holes of the initial shape) and a wall per edge. the faces are oriented to point
+ * outwards regardless of the orientation of the initial shape. without height only the faces of the initial shape
+ * are added.
+ */
+PLD_TEST_EXPORTS_API void addExtrudedFootprint(HoudiniCallbacks& callbacks, const prt::InitialShape* initialShape,
+                                               double height);
+
+} // namespace Preview
@@ -17,15 +17,18 @@
 #include "PrimitivePartition.h"
 #include "LogHandler.h"
 #include "PrimitiveClassifier.h"
+#include "Tracing.h"
 
 namespace {
 
 constexpr bool DBG = false;
-constexpr int32 INVALID_CLS_VALUE = -1;
+constexpr int32 INVALID_CLS_VALUE = PrimitivePartition::INVALID_CLS_VALUE;
 
 } // namespace
 
 PrimitivePartition::PrimitivePartition(const GA_Detail* detail, const PrimitiveClassifier& primCls) {
+	PLD_TRACE_SCOPE("partitioning");
+
 	const GA_Primitive* prim = nullptr;
 	GA_FOR_ALL_PRIMITIVES(detail, prim) {
 		add(detail, primCls, prim);
@@ -34,6 +34,8 @@ public:
 	using PrimitiveVector = std::vector<const GA_Primitive*>;
 	using PartitionMap = std::map<ClassifierValueType, PrimitiveVector>;
 
+	static constexpr int32 INVALID_CLS_VALUE = -1; // partition of all primitives without classifier value
+
 	PartitionMap mPrimitives;
 
 	PrimitivePartition(const GA_Detail* detail, const PrimitiveClassifier& primCls);
@@ -0,0 +1,415 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "RPKDiskCache.h"
+#include "LogHandler.h"
+
+#include "prt/API.h"
+
+#ifdef _WIN32
+#	include <Windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/file.h>
+#	include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+constexpr const char* MANIFEST_FILE = "resolvemap.txt";
+constexpr char MANIFEST_HEADER_PREFIX = '#'; // the first line of the manifest: #<digest>\t<size>
+constexpr const char* MANIFEST_TMP_SUFFIX = ".tmp";
+constexpr const char* LOCKS_DIR = "locks";
+constexpr const char* LOCK_FILE_SUFFIX = ".lock";
+constexpr const char* PRUNE_LOCK_NAME = "prune";
+constexpr size_t MAX_LOOKUP_ATTEMPTS = 3;
+constexpr size_t READ_CHUNK_SIZE = 1 << 16;
+
+enum class LockMode { SHARED, EXCLUSIVE };
+enum class LockWait { BLOCK, TRY };
+
+/**
+ * advisory inter-process lock on a file, held until destruction
+ */
+class FileLock {
+public:
+	FileLock(const std::filesystem::path& p, LockMode mode, LockWait wait) {
+#ifdef _WIN32
+		mHandle = ::CreateFileW(p.wstring().c_str(), GENERIC_READ | GENERIC_WRITE,
+		                        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_ALWAYS,
+		                        FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (mHandle == INVALID_HANDLE_VALUE)
+			return;
+		DWORD flags = (mode == LockMode::EXCLUSIVE) ? LOCKFILE_EXCLUSIVE_LOCK : 0;
+		if (wait == LockWait::TRY)
+			flags |= LOCKFILE_FAIL_IMMEDIATELY;
+		OVERLAPPED overlapped = {};
+		mLocked = (::LockFileEx(mHandle, flags, 0, MAXDWORD, MAXDWORD, &overlapped) != 0);
+#else
+		mFD = ::open(p.c_str(), O_RDWR | O_CREAT, 0666);
+		if (mFD < 0)
+			return;
+		int operation = (mode == LockMode::EXCLUSIVE) ? LOCK_EX : LOCK_SH;
+		if (wait == LockWait::TRY)
+			operation |= LOCK_NB;
+		mLocked = (::flock(mFD, operation) == 0);
+#endif
+	}
+
+	FileLock(const FileLock&) = delete;
+	FileLock& operator=(const FileLock&) = delete;
+
+	~FileLock() { // closing the file releases the lock
+#ifdef _WIN32
+		if (mHandle != INVALID_HANDLE_VALUE)
+			::CloseHandle(mHandle);
+#else
+		if (mFD >= 0)
+			::close(mFD);
+#endif
+	}
+
+	bool isLocked() const {
+		return mLocked;
+	}
+
+private:
+#ifdef _WIN32
+	HANDLE mHandle = INVALID_HANDLE_VALUE;
+#else
+	int mFD = -1;
+#endif
+	bool mLocked = false;
+};
+
+using FileLockSPtr = std::shared_ptr<FileLock>;
+
+/**
+ * SHA-256 (FIPS 180-4), the content keys are shared between processes and machines and must not depend on the
+ * standard library implementation like std::hash does
+ */
+class SHA256 {
+public:
+	void add(const void* data, size_t size) {
+		const auto* bytes = static_cast<const uint8_t*>(data);
+		mLength += size;
+		while (size > 0) {
+			const size_t n = std::min(size, mBlock.size() - mBlockSize);
+			std::copy(bytes, bytes + n, mBlock.begin() + mBlockSize);
+			mBlockSize += n;
+			bytes += n;
+			size -= n;
+			if (mBlockSize == mBlock.size()) {
+				processBlock();
+				mBlockSize = 0;
+			}
+		}
+	}
+
+	// lowercase hex, the object must not be used anymore afterwards
+	std::string finish() {
+		const uint64_t bitLength = mLength * 8;
+		const uint8_t one = 0x80;
+		add(&one, 1);
+		const uint8_t zero = 0;
+		while (mBlockSize != 56)
+			add(&zero, 1);
+		for (int i = 7; i >= 0; i--) {
+			const auto b = static_cast<uint8_t>(bitLength >> (i * 8));
+			add(&b, 1);
+		}
+
+		std::ostringstream out;
+		for (uint32_t h : mState)
+			out << std::hex << std::setw(8) << std::setfill('0') << h;
+		return out.str();
+	}
+
+private:
+	static uint32_t rotr(uint32_t x, int n) {
+		return (x >> n) | (x << (32 - n));
+	}
+
+	void processBlock() {
+		static constexpr std::array<uint32_t, 64> K = {
+		        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+		        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+		        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+		        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+		        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+		        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+		        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+		        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+		std::array<uint32_t, 64> w;
+		for (size_t i = 0; i < 16; i++)
+			w[i] = (uint32_t(mBlock[4 * i]) << 24) | (uint32_t(mBlock[4 * i + 1]) << 16) |
+			       (uint32_t(mBlock[4 * i + 2]) << 8) | uint32_t(mBlock[4 * i + 3]);
+		for (size_t i = 16; i < 64; i++) {
+			const uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+			const uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+			w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+		}
+
+		auto [a, b, c, d, e, f, g, h] = mState;
+		for (size_t i = 0; i < 64; i++) {
+			const uint32_t s1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+			const uint32_t ch = (e & f) ^ (~e & g);
+			const uint32_t t1 = h + s1 + ch + K[i] + w[i];
+			const uint32_t s0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+			const uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+			const uint32_t t2 = s0 + maj;
+			h = g;
+			g = f;
+			f = e;
+			e = d + t1;
+			d = c;
+			c = b;
+			b = a;
+			a = t1 + t2;
+		}
+
+		const std::array<uint32_t, 8> result = {a, b, c, d, e, f, g, h};
+		for (size_t i = 0; i < mState.size(); i++)
+			mState[i] += result[i];
+	}
+
+	std::array<uint32_t, 8> mState = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+	                                  0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+	std::array<uint8_t, 64> mBlock{};
+	size_t mBlockSize = 0;
+	uint64_t mLength = 0; // bytes
+};
+
+std::string getManifestHeader(const RPKDiskCache::ContentKey& contentKey) {
+	return MANIFEST_HEADER_PREFIX + contentKey.digest + '\t' + std::to_string(contentKey.size);
+}
+
+std::filesystem::path getLockFile(const std::filesystem::path& cacheDir, const std::string& name) {
+	return cacheDir / LOCKS_DIR / (name + LOCK_FILE_SUFFIX);
+}
+
+uintmax_t getDirectorySize(const std::filesystem::path& dir) {
+	uintmax_t size = 0;
+	std::error_code ec;
+	for (const auto& de : std::filesystem::recursive_directory_iterator(dir, ec)) {
+		if (de.is_regular_file(ec))
+			size += de.file_size(ec);
+	}
+	return size;
+}
+
+// a manifest of another rule package (e.g. a corrupt or foreign entry) is never trusted
+bool hasValidManifest(const std::filesystem::path& manifest, const RPKDiskCache::ContentKey& contentKey) {
+	std::ifstream in(manifest, std::ifstream::binary);
+	std::string header;
+	return in && std::getline(in, header) && header == getManifestHeader(contentKey);
+}
+
+/**
+ * the resolve map keeps the shared lock on its entry alive, i.e. the unpacked files are not pruned while in use
+ */
+ResolveMapSPtr readManifest(const std::filesystem::path& manifest, const RPKDiskCache::ContentKey& contentKey,
+                            const FileLockSPtr& lock) {
+	std::ifstream in(manifest, std::ifstream::binary);
+	std::string line;
+	if (!in || !std::getline(in, line) || line != getManifestHeader(contentKey))
+		return {};
+
+	const ResolveMapBuilderUPtr builder(prt::ResolveMapBuilder::create());
+	while (std::getline(in, line)) {
+		const auto [key, uri] = tokenizeFirst(toUTF16FromUTF8(line), L'\t');
+		if (!key.empty() && !uri.empty())
+			builder->addEntry(key.c_str(), uri.c_str());
+	}
+
+	prt::Status status = prt::STATUS_UNSPECIFIED_ERROR;
+	const prt::ResolveMap* resolveMap = builder->createResolveMap(&status);
+	if (status != prt::STATUS_OK) {
+		PRTDestroyer()(resolveMap);
+		return {};
+	}
+	return ResolveMapSPtr(resolveMap, [lock](const prt::ResolveMap* rm) { PRTDestroyer()(rm); });
+}
+
+bool unpack(const std::wstring& rpkURI, const RPKDiskCache::ContentKey& contentKey,
+            const std::filesystem::path& entryDir, const std::filesystem::path& manifest) {
+	std::error_code ec;
+	std::filesystem::remove_all(entryDir, ec); // leftovers of an interrupted unpack
+	std::filesystem::create_directories(entryDir, ec);
+	if (ec)
+		return false;
+
+	prt::Status status = prt::STATUS_UNSPECIFIED_ERROR;
+	const ResolveMapUPtr resolveMap(prt::createResolveMap(rpkURI.c_str(), entryDir.wstring().c_str(), &status));
+	if (!resolveMap || status != prt::STATUS_OK) {
+		LOG_WRN << "Failed to unpack " << rpkURI << " into " << entryDir << ": " << prt::getStatusDescription(status);
+		return false;
+	}
+
+	// the manifest marks the entry as complete, so it must appear atomically
+	std::filesystem::path tmpManifest = manifest;
+	tmpManifest += MANIFEST_TMP_SUFFIX;
+	{
+		std::ofstream out(tmpManifest, std::ofstream::binary);
+		out << getManifestHeader(contentKey) << '\n';
+		size_t keyCount = 0;
+		const wchar_t* const* keys = resolveMap->getKeys(&keyCount);
+		for (size_t ki = 0; ki < keyCount; ki++) {
+			const wchar_t* uri = resolveMap->getString(keys[ki]);
+			if (uri != nullptr)
+				out << toUTF8FromUTF16(keys[ki]) << '\t' << toUTF8FromUTF16(uri) << '\n';
+		}
+		if (!out)
+			return false;
+	}
+	std::filesystem::rename(tmpManifest, manifest, ec);
+
+	LOG_INF << "Unpacked " << rpkURI << " into RPK disk cache " << entryDir;
+	return !ec;
+}
+
+} // namespace
+
+RPKDiskCache::RPKDiskCache(const std::filesystem::path& cacheDir, uintmax_t maxSize)
+    : mCacheDir{cacheDir}, mMaxSize{maxSize} {
+	LOG_DBG << "RPK disk cache: dir = " << mCacheDir << ", max size = " << mMaxSize << " bytes";
+}
+
+ResolveMapSPtr RPKDiskCache::get(const std::wstring& rpkURI, const ContentKey& contentKey) {
+	if (!contentKey.isValid())
+		return {};
+
+	const std::string& key = contentKey.digest;
+	const std::filesystem::path entryDir = mCacheDir / key;
+	const std::filesystem::path manifest = entryDir / MANIFEST_FILE;
+	const std::filesystem::path lockFile = getLockFile(mCacheDir, key);
+
+	std::error_code ec;
+	std::filesystem::create_directories(lockFile.parent_path(), ec);
+	if (ec) {
+		LOG_WRN << "Cannot create RPK disk cache in " << mCacheDir << ": " << ec.message();
+		return {};
+	}
+
+	// only take the exclusive lock if the entry is missing, a shared lock is held by every resolve map in use
+	bool isNewEntry = false;
+	for (size_t attempt = 0; attempt < MAX_LOOKUP_ATTEMPTS; attempt++) {
+		auto sharedLock = std::make_shared<FileLock>(lockFile, LockMode::SHARED, LockWait::BLOCK);
+		if (!sharedLock->isLocked())
+			break;
+
+		if (std::filesystem::exists(manifest, ec)) {
+			ResolveMapSPtr resolveMap = readManifest(manifest, contentKey, sharedLock);
+			if (resolveMap) {
+				std::filesystem::last_write_time(manifest, std::filesystem::file_time_type::clock::now(), ec);
+				if (isNewEntry)
+					prune();
+				return resolveMap;
+			}
+			LOG_WRN << "Ignoring invalid RPK disk cache entry " << entryDir;
+		}
+		sharedLock.reset();
+
+		// note: another process might have been faster
+		const FileLock exclusiveLock(lockFile, LockMode::EXCLUSIVE, LockWait::BLOCK);
+		if (exclusiveLock.isLocked() && !hasValidManifest(manifest, contentKey))
+			isNewEntry = unpack(rpkURI, contentKey, entryDir, manifest);
+	}
+
+	LOG_WRN << "Failed to get " << rpkURI << " from RPK disk cache";
+	return {};
+}
+
+RPKDiskCache::ContentKey RPKDiskCache::getContentKey(const std::filesystem::path& rpk) {
+	std::ifstream in(rpk, std::ifstream::binary);
+	if (!in)
+		return {};
+
+	SHA256 sha;
+	ContentKey contentKey;
+	std::vector<char> chunk(READ_CHUNK_SIZE);
+	while (in) {
+		in.read(chunk.data(), chunk.size());
+		const auto n = static_cast<size_t>(in.gcount());
+		sha.add(chunk.data(), n);
+		contentKey.size += n;
+	}
+	if (in.bad())
+		return {};
+	contentKey.digest = sha.finish();
+	return contentKey;
+}
+
+RPKDiskCache::ContentKey RPKDiskCache::getContentKey(const void* data, size_t size) {
+	SHA256 sha;
+	sha.add(data, size);
+	return {sha.finish(), size};
+}
+
+void RPKDiskCache::prune() {
+	if (mMaxSize == 0)
+		return;
+
+	const FileLock pruneLock(getLockFile(mCacheDir, PRUNE_LOCK_NAME), LockMode::EXCLUSIVE, LockWait::TRY);
+	if (!pruneLock.isLocked())
+		return; // another process is already pruning
+
+	struct Entry {
+		std::filesystem::path dir;
+		std::filesystem::file_time_type lastUse;
+		uintmax_t size;
+	};
+	std::vector<Entry> entries;
+	uintmax_t totalSize = 0;
+
+	std::error_code ec;
+	for (const auto& de : std::filesystem::directory_iterator(mCacheDir, ec)) {
+		if (!de.is_directory(ec) || de.path().filename() == LOCKS_DIR)
+			continue;
+		const std::filesystem::path manifest = de.path() / MANIFEST_FILE;
+		const auto lastUse = std::filesystem::exists(manifest, ec) ? std::filesystem::last_write_time(manifest, ec)
+		                                                           : std::filesystem::file_time_type::min();
+		entries.push_back({de.path(), lastUse, getDirectorySize(de.path())});
+		totalSize += entries.back().size;
+	}
+
+	std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.lastUse < b.lastUse; });
+
+	for (const Entry& e : entries) {
+		if (totalSize <= mMaxSize)
+			break;
+
+		const FileLock entryLock(getLockFile(mCacheDir, e.dir.filename().string()), LockMode::EXCLUSIVE,
+		                         LockWait::TRY);
+		if (!entryLock.isLocked())
+			continue; // in use by this or another process
+
+		std::filesystem::remove_all(e.dir, ec);
+		if (!ec) {
+			totalSize -= e.size;
+			LOG_DBG << "Pruned " << e.dir << " from RPK disk cache";
+		}
+	}
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Utils.h"
+
+#include <filesystem>
+#include <memory>
+#include <string>
+
+/**
+ * persistent cache of unpacked rule packages, shared between sessions and between concurrent processes on a host.
+ * entries are keyed by the SHA-256 digest of the rule package. each entry directory contains the files unpacked by PRT
+ * and a manifest with the digest, the size and the resolve map. the manifest is written last and marks an entry as
+ * complete, a hit is only trusted if the digest and the size in the manifest match.
+ *
+ * processes synchronize via lock files: unpacking takes an exclusive lock on the entry, a resolve map holds a shared
+ * lock for its whole lifetime, so entries in use by any process are never pruned.
+ */
+class PLD_TEST_EXPORTS_API RPKDiskCache {
+public:
+	RPKDiskCache(const std::filesystem::path& cacheDir, uintmax_t maxSize);
+	RPKDiskCache(const RPKDiskCache&) = delete;
+	RPKDiskCache(RPKDiskCache&&) = delete;
+	RPKDiskCache& operator=(RPKDiskCache const&) = delete;
+	RPKDiskCache& operator=(RPKDiskCache&&) = delete;
+	~RPKDiskCache() = default;
+
+	// identifies the content of a rule package, the same on all platforms and builds
+	struct ContentKey {
+		std::string digest; // SHA-256 as lowercase hex, empty if the content could not be read
+		uintmax_t size = 0;
+
+		bool isValid() const {
+			return !digest.empty();
+		}
+		bool operator==(const ContentKey& other) const {
+			return digest == other.digest && size == other.size;
+		}
+		bool operator!=(const ContentKey& other) const {
+			return !(*this == other);
+		}
+	};
+
+	/**
+	 * returns a resolve map pointing to the unpacked files of the rule package, unpacks it on the first access
+	 */
+	ResolveMapSPtr get(const std::wstring& rpkURI, const ContentKey& contentKey);
+
+	static ContentKey getContentKey(const std::filesystem::path& rpk); // streams the file
+	static ContentKey getContentKey(const void* data, size_t size);
+
+	/**
+	 * removes the least recently used entries which are not in use until the cache fits into maxSize (0: unbounded)
+	 */
+	void prune();
+
+private:
+	const std::filesystem::path mCacheDir;
+	const uintmax_t mMaxSize;
+};
+
+using RPKDiskCacheUPtr = std::unique_ptr<RPKDiskCache>;
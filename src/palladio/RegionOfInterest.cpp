@@ -0,0 +1,156 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "RegionOfInterest.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace {
+
+using Vector = std::array<double, 3>;
+
+std::vector<size_t> getAllIndices(size_t count) {
+	std::vector<size_t> indices(count);
+	std::iota(indices.begin(), indices.end(), 0);
+	return indices;
+}
+
+void sortUnique(std::vector<size_t>& indices) {
+	std::sort(indices.begin(), indices.end());
+	indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+}
+
+Vector transform(const Vector& p, const std::array<double, 16>& m) {
+	Vector r;
+	for (int j = 0; j < 3; j++)
+		r[j] = p[0] * m[j] + p[1] * m[4 + j] + p[2] * m[8 + j] + m[12 + j];
+	return r;
+}
+
+Vector sub(const Vector& a, const Vector& b) {
+	return {a[0] - b[0], a[1] - b[1], a[2] - b[2]};
+}
+
+Vector cross(const Vector& a, const Vector& b) {
+	return {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+}
+
+double dot(const Vector& a, const Vector& b) {
+	return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+// plane through three corners, oriented to have the inside point on the positive side
+std::array<double, 4> getPlane(const Vector& a, const Vector& b, const Vector& c, const Vector& inside) {
+	const Vector n = cross(sub(b, a), sub(c, a));
+	const double d = -dot(n, a);
+	if (dot(n, inside) + d < 0.0)
+		return {-n[0], -n[1], -n[2], -d};
+	return {n[0], n[1], n[2], d};
+}
+
+} // namespace
+
+namespace RegionOfInterest {
+
+Frustum getFrustum(const std::array<double, 16>& cameraToWorld, double focal, double aperture, double aspectRatio,
+                   double nearClip, double farClip) {
+	const double halfWidth = aperture / (2.0 * focal); // at distance 1
+	const double halfHeight = halfWidth * aspectRatio;
+
+	// corner index bits: 0 right, 1 top, 2 far
+	std::array<Vector, 8> corners;
+	for (size_t ci = 0; ci < corners.size(); ci++) {
+		const double depth = (ci & 4) ? farClip : nearClip;
+		const double x = ((ci & 1) ? halfWidth : -halfWidth) * depth;
+		const double y = ((ci & 2) ? halfHeight : -halfHeight) * depth;
+		corners[ci] = transform({x, y, -depth}, cameraToWorld);
+	}
+
+	Vector center{0.0, 0.0, 0.0};
+	for (const Vector& c : corners) {
+		for (int axis = 0; axis < 3; axis++)
+			center[axis] += c[axis] / corners.size();
+	}
+
+	Frustum frustum;
+	frustum.planes = {getPlane(corners[0], corners[1], corners[2], center),  // near
+	                  getPlane(corners[4], corners[5], corners[6], center),  // far
+	                  getPlane(corners[0], corners[2], corners[4], center),  // left
+	                  getPlane(corners[1], corners[3], corners[5], center),  // right
+	                  getPlane(corners[0], corners[1], corners[4], center),  // bottom
+	                  getPlane(corners[2], corners[3], corners[6], center)}; // top
+
+	constexpr double inf = std::numeric_limits<double>::infinity();
+	frustum.bounds = {{inf, inf, inf}, {-inf, -inf, -inf}};
+	for (const Vector& c : corners) {
+		for (int axis = 0; axis < 3; axis++) {
+			frustum.bounds.min[axis] = std::min(frustum.bounds.min[axis], c[axis]);
+			frustum.bounds.max[axis] = std::max(frustum.bounds.max[axis], c[axis]);
+		}
+	}
+	return frustum;
+}
+
+bool intersects(const Bounds& a, const Bounds& b) {
+	for (int axis = 0; axis < 3; axis++) {
+		if (a.min[axis] > b.max[axis] || b.min[axis] > a.max[axis])
+			return false;
+	}
+	return true;
+}
+
+bool intersects(const Frustum& frustum, const Bounds& bounds) {
+	if (!intersects(frustum.bounds, bounds))
+		return false;
+	for (const auto& plane : frustum.planes) {
+		// the corner of the bounds furthest inside must not be outside
+		double distance = plane[3];
+		for (int axis = 0; axis < 3; axis++)
+			distance += plane[axis] * ((plane[axis] >= 0.0) ? bounds.max[axis] : bounds.min[axis]);
+		if (distance < 0.0)
+			return false;
+	}
+	return true;
+}
+
+SpatialIndex::SpatialIndex(std::vector<Bounds>&& bounds)
+    : mBounds(std::move(bounds)), mGrid(mBounds, getAllIndices(mBounds.size())) {}
+
+std::vector<size_t> SpatialIndex::query(const Bounds& region) const {
+	std::vector<size_t> result;
+	mGrid.forEachCandidate(region, 0.0, [&](size_t i) {
+		if (intersects(region, mBounds[i]))
+			result.push_back(i);
+		return true;
+	});
+	sortUnique(result);
+	return result;
+}
+
+std::vector<size_t> SpatialIndex::query(const Frustum& region) const {
+	std::vector<size_t> result;
+	mGrid.forEachCandidate(region.bounds, 0.0, [&](size_t i) {
+		if (intersects(region, mBounds[i]))
+			result.push_back(i);
+		return true;
+	});
+	sortUnique(result);
+	return result;
+}
+
+} // namespace RegionOfInterest
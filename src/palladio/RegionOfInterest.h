@@ -0,0 +1,85 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Sharding.h"
+#include "Utils.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * restricts generation to the initial shapes intersecting a region of interest (a box, a camera frustum or a primitive
+ * group), e.g. to iterate on one district of a city. the initial shapes outside are skipped or passed through
+ * unchanged.
+ */
+namespace RegionOfInterest {
+
+enum class Mode { NONE, BOUNDING_BOX, CAMERA_FRUSTUM, PRIMITIVE_GROUP };
+enum class Outside { SKIP, PASS_THROUGH };
+
+using Bounds = Sharding::Bounds;
+
+struct Selection {
+	Mode mode = Mode::NONE;
+	Outside outside = Outside::SKIP;
+	Bounds box{};       // BOUNDING_BOX
+	std::string camera; // CAMERA_FRUSTUM, path of the camera object
+	std::string group;  // PRIMITIVE_GROUP, name of a primitive group of the input
+};
+
+struct Frustum {
+	std::array<std::array<double, 4>, 6> planes; // (a, b, c, d) with a*x + b*y + c*z + d >= 0 inside
+	Bounds bounds;                               // of the corners
+};
+
+/**
+ * frustum of a perspective camera looking down its negative z axis. cameraToWorld is row major and transforms row
+ * vectors (the houdini convention), aspectRatio is the image height divided by the image width.
+ */
+PLD_TEST_EXPORTS_API Frustum getFrustum(const std::array<double, 16>& cameraToWorld, double focal, double aperture,
+                                        double aspectRatio, double nearClip, double farClip);
+
+PLD_TEST_EXPORTS_API bool intersects(const Bounds& a, const Bounds& b);
+
+// conservative, bounds close to the frustum edges might be reported as intersecting
+PLD_TEST_EXPORTS_API bool intersects(const Frustum& frustum, const Bounds& bounds);
+
+/**
+ * the initial shape bounds in a grid (see Sharding::GridIndex), meant to be built once per input geometry and queried
+ * on every cook
+ */
+class PLD_TEST_EXPORTS_API SpatialIndex {
+public:
+	explicit SpatialIndex(std::vector<Bounds>&& bounds);
+
+	// the indices of the shapes intersecting the region, in increasing order
+	std::vector<size_t> query(const Bounds& region) const;
+	std::vector<size_t> query(const Frustum& region) const;
+
+	size_t size() const {
+		return mBounds.size();
+	}
+
+private:
+	std::vector<Bounds> mBounds;
+	Sharding::GridIndex mGrid;
+};
+
+} // namespace RegionOfInterest
@@ -20,14 +20,32 @@
 #ifndef PLD_TEST_EXPORTS
 #	include "FS/FS_Reader.h"
 #	include "UT/UT_IStream.h"
+#	include "UT/UT_WorkBuffer.h"
 #endif
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
-#include <string_view>
+#include <vector>
 
 namespace {
 
-constexpr bool UNPACK_RULE_PACKAGES = false;
+constexpr const char* RPK_VALIDATION_INTERVAL_ENV_VAR = "CITYENGINE_RPK_VALIDATION_INTERVAL";
+constexpr size_t RPK_VALIDATION_INTERVAL_DEFAULT = 1000; // ms
+
+constexpr const char* RPK_CACHE_MAX_ENTRIES_ENV_VAR = "CITYENGINE_RPK_CACHE_MAX_ENTRIES";
+constexpr size_t RPK_CACHE_MAX_ENTRIES_DEFAULT = 32;
+
+constexpr const char* RPK_CACHE_MAX_SIZE_ENV_VAR = "CITYENGINE_RPK_CACHE_MAX_SIZE";
+constexpr size_t RPK_CACHE_MAX_SIZE_DEFAULT = 0; // MB
+
+constexpr const char* RPK_DISK_CACHE_ENV_VAR = "CITYENGINE_RPK_DISK_CACHE";
+constexpr const char* RPK_DISK_CACHE_MAX_SIZE_ENV_VAR = "CITYENGINE_RPK_DISK_CACHE_MAX_SIZE";
+constexpr size_t RPK_DISK_CACHE_MAX_SIZE_DEFAULT = 4096; // MB
+
+constexpr const char* RPK_CACHE_SHARE_IDENTICAL_ENV_VAR = "CITYENGINE_RPK_CACHE_SHARE_IDENTICAL";
+constexpr size_t RPK_CACHE_SHARE_IDENTICAL_DEFAULT = 1;
 
 const ResolveMapSPtr RESOLVE_MAP_NONE;
 const ResolveMapCache::LookupResult LOOKUP_FAILURE = {RESOLVE_MAP_NONE, ResolveMapCache::CacheStatus::MISS};
@@ -37,6 +55,63 @@ constexpr const char* SCHEMA_OPDEF = "opdef:";
 constexpr const char* SCHEMA_OPLIB = "oplib:";
 const std::vector<std::string> EMBEDDED_SCHEMAS = {SCHEMA_OPDEF, SCHEMA_OPLIB};
 
+size_t getUnsignedEnvVar(const char* name, size_t defaultValue) {
+	const char* e = std::getenv(name);
+	if (e == nullptr || std::strlen(e) == 0)
+		return defaultValue;
+	char* end = nullptr;
+	const long long v = std::strtoll(e, &end, 10);
+	if (end == e || *end != '\0' || v < 0) {
+		LOG_WRN << "Ignoring invalid value '" << e << "' of " << name;
+		return defaultValue;
+	}
+	return static_cast<size_t>(v);
+}
+
+/**
+ * the minimal time between two file system checks of the same RPK, 0 means to check on every lookup
+ */
+std::chrono::milliseconds getValidationInterval() {
+	const size_t interval = getUnsignedEnvVar(RPK_VALIDATION_INTERVAL_ENV_VAR, RPK_VALIDATION_INTERVAL_DEFAULT);
+	return std::chrono::milliseconds(interval);
+}
+
+bool getShareIdenticalRPKs() {
+	return getUnsignedEnvVar(RPK_CACHE_SHARE_IDENTICAL_ENV_VAR, RPK_CACHE_SHARE_IDENTICAL_DEFAULT) != 0;
+}
+
+/**
+ * the persistent disk cache is only enabled if a cache directory is configured
+ */
+RPKDiskCacheUPtr createDiskCache() {
+	const char* e = std::getenv(RPK_DISK_CACHE_ENV_VAR);
+	if (e == nullptr || std::strlen(e) == 0)
+		return {};
+	const uintmax_t maxSize = getUnsignedEnvVar(RPK_DISK_CACHE_MAX_SIZE_ENV_VAR, RPK_DISK_CACHE_MAX_SIZE_DEFAULT);
+	return std::make_unique<RPKDiskCache>(e, maxSize << 20);
+}
+
+/**
+ * compares the file byte by byte with the buffer, a matching content key alone is not trusted for sharing
+ */
+bool hasContent(const std::filesystem::path& p, const void* data, size_t size) {
+	std::error_code ec;
+	if (p.empty() || std::filesystem::file_size(p, ec) != size || ec)
+		return false;
+
+	std::ifstream in(p, std::ifstream::binary);
+	std::vector<char> chunk(1 << 16);
+	const char* expected = static_cast<const char*>(data);
+	for (size_t offset = 0; offset < size;) {
+		const size_t n = std::min(chunk.size(), size - offset);
+		if (!in.read(chunk.data(), static_cast<std::streamsize>(n)) ||
+		    std::memcmp(chunk.data(), expected + offset, n) != 0)
+			return false;
+		offset += n;
+	}
+	return true;
+}
+
 bool isEmbedded(const std::filesystem::path& p) {
 	return startsWithAnyOf(p.string(), EMBEDDED_SCHEMAS);
 }
@@ -65,104 +140,396 @@ std::filesystem::file_time_type getFileModificationTime(const std::filesystem::p
 		return INVALID_TIMESTAMP;
 }
 
+/**
+ * the same RPK file reached via relative paths, symlinks, ".." etc. maps to the same key
+ * embedded RPKs are kept as they are, identical copies are detected by their content (see mShareIdenticalRPKs)
+ */
 ResolveMapCache::KeyType createCacheKey(const std::filesystem::path& rpk) {
-	return rpk.string(); // TODO: try FS_Reader::splitIndexFileSectionPath for embedded resources
+	if (isEmbedded(rpk))
+		return rpk.string();
+
+	std::error_code ec;
+	const std::filesystem::path canonicalPath = std::filesystem::weakly_canonical(rpk, ec);
+	return ec ? rpk.string() : canonicalPath.string();
 }
 
 #ifndef PLD_TEST_EXPORTS
-std::filesystem::path resolveFromHDA(const std::filesystem::path& p, const std::filesystem::path& unpackPath) {
+/**
+ * reads an embedded resource (e.g. a RPK inside a HDA) into memory
+ */
+std::shared_ptr<const UT_WorkBuffer> readFromHDA(const std::filesystem::path& p) {
 	LOG_DBG << "detected embedded resource in HDA: " << p;
 
 	FS_Reader fsr(p.string().c_str()); // is able to resolve opdef/oplib URIs
-	UT_StringHolder container = getFSReaderFilename(fsr);
-	LOG_DBG << "resource container: " << container;
-
-	std::filesystem::path extractedResource = unpackPath / p.filename();
-	ensureNonExistingFile(extractedResource);
+	if (!fsr.isGood())
+		return {};
+	LOG_DBG << "resource container: " << getFSReaderFilename(fsr);
 
-	if (fsr.isGood()) {
-		std::filesystem::create_directories(unpackPath);
-
-		UT_WorkBuffer wb;
-		fsr.getStream()->getAll(wb);
+	auto buffer = std::make_shared<UT_WorkBuffer>();
+	fsr.getStream()->getAll(*buffer);
+	LOG_DBG << "Read embedded resource into memory (" << buffer->length() << " bytes)";
+	return buffer;
+}
+#endif
 
-		std::ofstream out(extractedResource.string(), std::ofstream::binary);
-		out.write(wb.buffer(), wb.length());
-		out.close();
+/**
+ * collects the URIs of all resources of a rule package (as used by PRT for its cache keys) and the package itself
+ */
+std::vector<std::wstring> getResolveMapURIs(const ResolveMapSPtr& resolveMap, const std::wstring& rpkURI) {
+	std::vector<std::wstring> uris = {rpkURI};
+	if (!resolveMap)
+		return uris;
 
-		LOG_DBG << "Extracted embedded resource into " << extractedResource;
+	size_t keyCount = 0;
+	const wchar_t* const* keys = resolveMap->getKeys(&keyCount);
+	uris.reserve(keyCount + 1);
+	for (size_t ki = 0; ki < keyCount; ki++) {
+		const wchar_t* uri = resolveMap->getString(keys[ki]);
+		if (uri != nullptr)
+			uris.emplace_back(uri);
 	}
-	return extractedResource;
+	return uris;
 }
-#endif
 
 } // namespace
 
+ResolveMapCache::Limits ResolveMapCache::Limits::fromEnvironment() {
+	Limits limits;
+	limits.maxEntries = getUnsignedEnvVar(RPK_CACHE_MAX_ENTRIES_ENV_VAR, RPK_CACHE_MAX_ENTRIES_DEFAULT);
+	limits.maxSize = static_cast<uintmax_t>(getUnsignedEnvVar(RPK_CACHE_MAX_SIZE_ENV_VAR, RPK_CACHE_MAX_SIZE_DEFAULT))
+	                 << 20;
+	return limits;
+}
+
+ResolveMapCache::ResolveMapCache(const std::filesystem::path& unpackPath, prt::CacheObject* prtCache,
+                                 const Limits& limits)
+    : mRPKUnpackPath{unpackPath}, mPRTCache{prtCache}, mValidationInterval{getValidationInterval()},
+      mLimits{limits},
+      mShareIdenticalRPKs{getShareIdenticalRPKs()}, mDiskCache{createDiskCache()} {
+	LOG_DBG << "RPK validation interval: " << mValidationInterval.count() << "ms";
+	LOG_DBG << "RPK cache limits: max entries = " << mLimits.maxEntries << ", max size = " << mLimits.maxSize
+	        << " bytes";
+}
+
 ResolveMapCache::~ResolveMapCache() {
 	std::filesystem::remove_all(mRPKUnpackPath);
 	LOG_INF << "Removed RPK unpack directory";
 }
 
-ResolveMapCache::LookupResult ResolveMapCache::get(const std::filesystem::path& rpk) {
+ResolveMapCache::KeyType ResolveMapCache::getKey(const std::filesystem::path& rpk) {
+	return createCacheKey(rpk);
+}
+
+bool ResolveMapCache::isEmbedded(const std::filesystem::path& rpk) {
+	return ::isEmbedded(rpk);
+}
+
+ResolveMapCache::LookupResult ResolveMapCache::get(const std::filesystem::path& rpk, Validation validation) {
 	const auto cacheKey = createCacheKey(rpk);
+	const Clock::time_point now = Clock::now();
 
-	const auto timeStamp = getFileModificationTime(rpk);
-	LOG_DBG << "rpk: current timestamp: "
-	        << std::chrono::duration_cast<std::chrono::nanoseconds>(timeStamp.time_since_epoch()).count() << "ns";
+	// fastest path: entry has been validated recently, no file system access at all
+	ResolveMapCacheEntrySPtr entry;
+	if (validation == Validation::THROTTLED) {
+		std::shared_lock<std::shared_mutex> lock(mCacheMutex);
+		auto it = mCache.find(cacheKey);
+		if (it != mCache.end() && isRecentlyValidated(*it->second, now))
+			entry = it->second;
+	}
 
-	// verify timestamp
-	if (timeStamp == INVALID_TIMESTAMP)
-		return LOOKUP_FAILURE;
+	// fast path: check timestamp, shared lock only
+	std::filesystem::file_time_type timeStamp = INVALID_TIMESTAMP;
+	if (!entry) {
+		timeStamp = getFileModificationTime(rpk);
+		mValidations++;
+		LOG_DBG << "rpk: current timestamp: "
+		        << std::chrono::duration_cast<std::chrono::nanoseconds>(timeStamp.time_since_epoch()).count() << "ns";
 
-	CacheStatus cs = CacheStatus::HIT;
-	auto it = mCache.find(cacheKey);
-	if (it != mCache.end()) {
-		LOG_DBG << "rpk: cache timestamp: "
-		        << std::chrono::duration_cast<std::chrono::nanoseconds>(it->second.mTimeStamp.time_since_epoch())
-		                   .count()
-		        << "ns";
-		if (it->second.mTimeStamp != timeStamp) {
-			mCache.erase(it);
-			const auto cnt = std::filesystem::remove_all(mRPKUnpackPath / rpk.filename());
-			LOG_INF << "RPK change detected, forcing reload and clearing cache for " << rpk << " (removed " << cnt
-			        << " files)";
-			cs = CacheStatus::MISS;
+		// verify timestamp
+		if (timeStamp == INVALID_TIMESTAMP)
+			return LOOKUP_FAILURE;
+
+		std::shared_lock<std::shared_mutex> lock(mCacheMutex);
+		auto it = mCache.find(cacheKey);
+		if (it != mCache.end() && it->second->mTimeStamp == timeStamp) {
+			entry = it->second;
+			entry->mLastValidation = now.time_since_epoch().count();
 		}
 	}
-	else
-		cs = CacheStatus::MISS;
 
-	if (cs == CacheStatus::MISS) {
-		std::filesystem::path extractedPath; // if set, will resolve the extracted RPK from HDA
-		const auto actualRPK = [&extractedPath](const std::filesystem::path& p,
-		                                        const std::filesystem::path& mRPKUnpackPath) {
-			if (isEmbedded(p)) {
+	// slow path: insert a new (not yet loaded) entry, the actual loading happens outside of the cache lock
+	ResolveMapCacheEntrySPtr staleEntry;
+	if (!entry) {
+		std::unique_lock<std::shared_mutex> lock(mCacheMutex);
+		auto it = mCache.find(cacheKey);
+		if (it != mCache.end()) {
+			LOG_DBG << "rpk: cache timestamp: "
+			        << std::chrono::duration_cast<std::chrono::nanoseconds>(it->second->mTimeStamp.time_since_epoch())
+			                   .count()
+			        << "ns";
+			if (it->second->mTimeStamp == timeStamp)
+				entry = it->second; // another thread was faster
+			else {
+				staleEntry = std::move(it->second);
+				mCache.erase(it);
+			}
+		}
+		if (!entry) {
+			entry = std::make_shared<ResolveMapCacheEntry>();
+			entry->mTimeStamp = timeStamp;
+			entry->mLastValidation = now.time_since_epoch().count();
+			mCache.emplace(cacheKey, entry);
+		}
+	}
+
+	if (staleEntry) {
+		invalidate(*staleEntry);
+		LOG_INF << "RPK change detected, forcing reload and clearing cache for " << rpk;
+		mReloads++;
+	}
+	entry->mLastAccess = now.time_since_epoch().count();
+
+	const bool wasLoaded = entry->mLoaded;
+	bool isLoader = false;
+	std::call_once(entry->mLoadFlag, [this, &rpk, &entry, &isLoader]() {
+		isLoader = true;
+		load(rpk, *entry);
+	});
+
+	if (!entry->mResolveMap) {
+		// drop the failed entry (unless it has already been replaced) to retry on next lookup
+		std::unique_lock<std::shared_mutex> lock(mCacheMutex);
+		auto it = mCache.find(cacheKey);
+		if (it != mCache.end() && it->second == entry)
+			mCache.erase(it);
+		return LOOKUP_FAILURE;
+	}
+
+	if (isLoader) {
+		mMisses++;
+		evict(entry);
+		return {entry->mResolveMap, CacheStatus::MISS};
+	}
+
+	mHits++;
+	if (!wasLoaded)
+		mCoalescedLoads++;
+	return {entry->mResolveMap, CacheStatus::HIT};
+}
+
+void ResolveMapCache::load(const std::filesystem::path& rpk, ResolveMapCacheEntry& entry) {
+	const auto loadStart = std::chrono::steady_clock::now();
+
+	std::wstring rpkURI;
+	uintmax_t rpkSize = 0;
+	std::shared_ptr<const char> rpkData; // the in-memory copy of an embedded RPK
+	if (isEmbedded(rpk)) {
 #ifndef PLD_TEST_EXPORTS
-				extractedPath = resolveFromHDA(p, mRPKUnpackPath);
+		// serve the embedded RPK to PRT straight from memory instead of extracting it to a temp file
+		const std::shared_ptr<const UT_WorkBuffer> buffer = readFromHDA(rpk);
+		if (buffer) {
+			entry.mContentKey = RPKDiskCache::getContentKey(buffer->buffer(), buffer->length());
+			rpkData = retainEmbeddedRPK(std::shared_ptr<const char>(buffer, buffer->buffer()), buffer->length(),
+			                            entry.mContentKey);
+			rpkURI = toMemoryURI(rpkData.get(), buffer->length(), L".rpk");
+			rpkSize = buffer->length();
+			if (mShareIdenticalRPKs && share(entry, rpkURI, rpkData.get(), rpkSize))
+				LOG_DBG << "sharing resolve map of identical RPK " << entry.mRPKURI;
+		}
 #endif
-				return extractedPath;
+	}
+	else {
+		rpkURI = toFileURI(rpk);
+		std::error_code ec;
+		const uintmax_t size = std::filesystem::file_size(rpk, ec);
+		rpkSize = ec ? 0 : size;
+		if (mDiskCache) {
+			entry.mContentKey = RPKDiskCache::getContentKey(rpk);
+			entry.mContentPath = rpk;
+		}
+	}
+
+	if (!entry.mResolveMap && !rpkURI.empty()) { // not shared with an identical RPK
+		entry.mRPKURI = rpkURI;
+
+		// the unpacked files in the disk cache never change, i.e. the resolve map may be shared by content
+		if (mDiskCache)
+			entry.mResolveMap = mDiskCache->get(rpkURI, entry.mContentKey);
+
+		if (!entry.mResolveMap) {
+			if (!isEmbedded(rpk)) { // the RPK file could change under a shared resolve map
+				entry.mContentKey = {};
+				entry.mContentPath.clear();
 			}
-			else
-				return p;
-		}(rpk, mRPKUnpackPath);
 
-		const auto rpkURI = toFileURI(actualRPK);
+			prt::Status status = prt::STATUS_UNSPECIFIED_ERROR;
+			LOG_DBG << "createResolveMap from " << rpkURI;
+			ResolveMapSPtr resolveMap(prt::createResolveMap(rpkURI.c_str(), nullptr, &status),
+			                          [rpkData](const prt::ResolveMap* rm) { PRTDestroyer()(rm); });
+			if (status == prt::STATUS_OK)
+				entry.mResolveMap = std::move(resolveMap);
+		}
 
-		ResolveMapCacheEntry rmce;
-		rmce.mTimeStamp = timeStamp;
+		if (entry.mResolveMap) {
+			entry.mSize = rpkSize;
+			mResidentSize += entry.mSize;
+		}
+	}
 
-		prt::Status status = prt::STATUS_UNSPECIFIED_ERROR;
-		LOG_DBG << "createResolveMap from " << rpkURI;
-		const wchar_t* extractionPathPtr = UNPACK_RULE_PACKAGES ? mRPKUnpackPath.wstring().c_str() : nullptr;
-		rmce.mResolveMap.reset(prt::createResolveMap(rpkURI.c_str(), extractionPathPtr, &status), PRTDestroyer());
-		if (status != prt::STATUS_OK)
-			return LOOKUP_FAILURE;
+	const auto loadTime = std::chrono::steady_clock::now() - loadStart;
+	mLoadTimeNs += std::chrono::duration_cast<std::chrono::nanoseconds>(loadTime).count();
+	{
+		std::lock_guard<std::mutex> lock(entry.mLoadedMutex);
+		entry.mLoaded = true;
+	}
+	entry.mLoadedCondition.notify_all();
+}
 
-		it = mCache.emplace(cacheKey, std::move(rmce)).first;
+std::shared_ptr<const char> ResolveMapCache::retainEmbeddedRPK(std::shared_ptr<const char> data, size_t size,
+                                                               const RPKDiskCache::ContentKey& contentKey) {
+	std::lock_guard<std::mutex> lock(mEmbeddedRPKsMutex);
+	const auto candidates = mEmbeddedRPKs.equal_range(contentKey.digest);
+	for (auto it = candidates.first; it != candidates.second; ++it) {
+		const EmbeddedRPK& e = it->second;
+		if (e.size == size && (size == 0 || std::memcmp(e.data.get(), data.get(), size) == 0))
+			return e.data; // identical embedded RPK, e.g. in a copy of the HDA
+	}
+	mEmbeddedRPKs.emplace(contentKey.digest, EmbeddedRPK{data, size});
+	return data;
+}
+
+ResolveMapCache::Statistics ResolveMapCache::getStatistics() const {
+	Statistics s;
+	s.hits = mHits;
+	s.misses = mMisses;
+	s.reloads = mReloads;
+	s.coalescedLoads = mCoalescedLoads;
+	s.validations = mValidations;
+	s.flushedPRTEntries = mFlushedPRTEntries;
+	s.evictions = mEvictions;
+	s.residentSize = mResidentSize;
+	s.loadTime = std::chrono::nanoseconds(mLoadTimeNs.load());
+	{
+		std::shared_lock<std::shared_mutex> lock(mCacheMutex);
+		s.entries = mCache.size();
+	}
+	return s;
+}
+
+bool ResolveMapCache::isRecentlyValidated(const ResolveMapCacheEntry& entry, Clock::time_point now) const {
+	if (mValidationInterval.count() == 0)
+		return false;
+	const Clock::time_point lastValidation{Clock::duration(entry.mLastValidation.load())};
+	return (now - lastValidation) < mValidationInterval;
+}
 
-		if constexpr (UNPACK_RULE_PACKAGES)
-			LOG_INF << "Unpacked RPK " << actualRPK << " to " << mRPKUnpackPath;
+void ResolveMapCache::invalidate(ResolveMapCacheEntry& entry) {
+	// wait for a potentially ongoing load of the outdated entry, the lookup which inserted an entry always loads it
+	{
+		std::unique_lock<std::mutex> lock(entry.mLoadedMutex);
+		entry.mLoadedCondition.wait(lock, [&entry]() { return entry.mLoaded.load(); });
 	}
 
-	return {it->second.mResolveMap, cs};
+	mResidentSize -= entry.mSize;
+
+	if (mPRTCache == nullptr)
+		return;
+
+	if (isShared(entry)) {
+		LOG_DBG << "keeping PRT cache entries of " << entry.mRPKURI << ", its resolve map is shared";
+		return;
+	}
+
+	// only drop the PRT cache entries (CGBs, assets, textures, ...) of the changed rule package,
+	// the entries of all other rule packages stay valid
+	const std::vector<std::wstring> uris = getResolveMapURIs(entry.mResolveMap, entry.mRPKURI);
+	for (const std::wstring& uri : uris)
+		mPRTCache->flushEntry(uri.c_str());
+	mFlushedPRTEntries += uris.size();
+
+	LOG_DBG << "flushed " << uris.size() << " PRT cache entries of " << entry.mRPKURI;
+}
+
+void ResolveMapCache::evict(const ResolveMapCacheEntrySPtr& keep) {
+	if (mLimits.maxEntries == 0 && mLimits.maxSize == 0)
+		return;
+
+	std::vector<ResolveMapCacheEntrySPtr> evicted;
+	{
+		std::unique_lock<std::shared_mutex> lock(mCacheMutex);
+
+		uintmax_t residentSize = mResidentSize;
+		const auto isOverLimits = [this, &residentSize]() {
+			return (mLimits.maxEntries > 0 && mCache.size() > mLimits.maxEntries) ||
+			       (mLimits.maxSize > 0 && residentSize > mLimits.maxSize);
+		};
+
+		while (isOverLimits()) {
+			// resolve maps of identical RPKs are shared between cache entries
+			std::map<const prt::ResolveMap*, long> cacheReferences;
+			// entries which are still loading are skipped, their resolve map is only published by mLoaded
+			for (const auto& [key, e] : mCache) {
+				if (e->mLoaded)
+					cacheReferences[e->mResolveMap.get()]++;
+			}
+
+			// an entry is in use if a lookup is still running on it or if anybody outside holds its resolve map
+			// note: both can only be acquired via the cache, which is locked
+			auto lru = mCache.end();
+			for (auto it = mCache.begin(); it != mCache.end(); ++it) {
+				const ResolveMapCacheEntrySPtr& e = it->second;
+				if (e == keep || !e->mLoaded || e.use_count() > 1 ||
+				    e->mResolveMap.use_count() > cacheReferences[e->mResolveMap.get()])
+					continue;
+				if (lru == mCache.end() || e->mLastAccess < lru->second->mLastAccess)
+					lru = it;
+			}
+			if (lru == mCache.end()) {
+				LOG_DBG << "RPK cache exceeds its limits, but all remaining resolve maps are in use";
+				break;
+			}
+
+			LOG_DBG << "evicting RPK " << lru->first << " from the cache";
+			residentSize -= lru->second->mSize;
+			evicted.emplace_back(std::move(lru->second));
+			mCache.erase(lru);
+		}
+	}
+
+	// release the PRT cache entries outside of the cache lock
+	for (const ResolveMapCacheEntrySPtr& e : evicted)
+		invalidate(*e);
+	mEvictions += evicted.size();
+}
+
+bool ResolveMapCache::share(ResolveMapCacheEntry& entry, const std::wstring& rpkURI, const void* data, size_t size) {
+	std::vector<ResolveMapCacheEntrySPtr> candidates;
+	{
+		std::shared_lock<std::shared_mutex> lock(mCacheMutex);
+		for (const auto& [key, e] : mCache) {
+			if (e.get() != &entry && e->mLoaded && e->mResolveMap && e->mContentKey == entry.mContentKey)
+				candidates.push_back(e);
+		}
+	}
+
+	// the memory URI is the same for identical embedded RPKs (see retainEmbeddedRPK), RPK files from the disk cache are
+	// compared byte by byte outside of the cache lock
+	for (const ResolveMapCacheEntrySPtr& e : candidates) {
+		if (e->mRPKURI != rpkURI && !hasContent(e->mContentPath, data, size))
+			continue;
+		entry.mResolveMap = e->mResolveMap;
+		entry.mRPKURI = e->mRPKURI;
+		entry.mContentPath = e->mContentPath;
+		return true;
+	}
+	return false;
+}
+
+bool ResolveMapCache::isShared(const ResolveMapCacheEntry& entry) const {
+	if (!entry.mResolveMap)
+		return false;
+	std::shared_lock<std::shared_mutex> lock(mCacheMutex);
+	return std::any_of(mCache.begin(), mCache.end(), [&entry](const auto& p) {
+		return p.second.get() != &entry && p.second->mLoaded && p.second->mResolveMap == entry.mResolveMap;
+	});
 }
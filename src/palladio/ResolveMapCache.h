@@ -16,17 +16,33 @@
 
 #pragma once
 
+#include "RPKDiskCache.h"
 #include "Utils.h"
 
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <filesystem>
 #include <map>
+#include <mutex>
+#include <shared_mutex>
 
 class ResolveMapCache {
 public:
 	using KeyType = std::string;
 
-	explicit ResolveMapCache(const std::filesystem::path& unpackPath) : mRPKUnpackPath{unpackPath} {}
+	/**
+	 * bounds for the number of cached resolve maps and the accumulated size of their rule packages, 0 means unbounded.
+	 * the least recently used entries are evicted first, resolve maps which are still in use are never evicted.
+	 */
+	struct Limits {
+		size_t maxEntries = 0;
+		uintmax_t maxSize = 0; // bytes
+		static Limits fromEnvironment();
+	};
+
+	ResolveMapCache(const std::filesystem::path& unpackPath, prt::CacheObject* prtCache,
+	                const Limits& limits = Limits::fromEnvironment());
 	ResolveMapCache(const ResolveMapCache&) = delete;
 	ResolveMapCache(ResolveMapCache&&) = delete;
 	ResolveMapCache& operator=(ResolveMapCache const&) = delete;
@@ -35,17 +51,103 @@ public:
 
 	enum class CacheStatus { HIT, MISS };
 	using LookupResult = std::pair<ResolveMapSPtr, CacheStatus>;
-	LookupResult get(const std::filesystem::path& rpk);
+
+	/**
+	 * THROTTLED: the RPK timestamp is checked at most once per validation interval
+	 *            (see env var CITYENGINE_RPK_VALIDATION_INTERVAL)
+	 * FORCED:    the RPK timestamp is always checked, e.g. for an explicit reload by the user
+	 */
+	enum class Validation { THROTTLED, FORCED };
+
+	/**
+	 * thread-safe: hits only take a shared lock, different RPKs are loaded concurrently and concurrent lookups of an
+	 * RPK which is currently being loaded wait for that single load
+	 */
+	LookupResult get(const std::filesystem::path& rpk, Validation validation = Validation::THROTTLED);
+
+	// the same RPK file reached via relative paths, symlinks, ".." etc. maps to the same key
+	static KeyType getKey(const std::filesystem::path& rpk);
+
+	// RPKs embedded in a HDA (opdef: and oplib: paths) can only be read by Houdini, i.e. on the main thread
+	static bool isEmbedded(const std::filesystem::path& rpk);
+
+	struct Statistics {
+		size_t hits = 0;
+		size_t misses = 0;
+		size_t reloads = 0;           // misses caused by a changed RPK
+		size_t coalescedLoads = 0;    // hits which had to wait for a load in progress
+		size_t validations = 0;       // RPK timestamp checks (file system accesses)
+		size_t flushedPRTEntries = 0; // PRT cache entries flushed because their RPK changed or got evicted
+		size_t evictions = 0;
+		size_t entries = 0;
+		uintmax_t residentSize = 0; // accumulated size of the cached rule packages in bytes
+		std::chrono::duration<double> loadTime{0.0}; // accumulated time spent creating resolve maps
+	};
+	Statistics getStatistics() const;
+
+	/**
+	 * keeps an embedded RPK (e.g. read from a HDA) in memory until the cache is destroyed and returns the copy to serve
+	 * to PRT via a memory URI, identical embedded RPKs share one copy. the copies outlive the eviction of their resolve
+	 * maps, because the asset URIs reported by PRT (e.g. textures in the material attributes) point into them and are
+	 * resolved later by palladio_fs.
+	 */
+	std::shared_ptr<const char> retainEmbeddedRPK(std::shared_ptr<const char> data, size_t size,
+	                                              const RPKDiskCache::ContentKey& contentKey);
 
 private:
+	using Clock = std::chrono::steady_clock;
+
 	struct ResolveMapCacheEntry {
-		ResolveMapSPtr mResolveMap;
 		std::filesystem::file_time_type mTimeStamp;
+		std::atomic<Clock::rep> mLastValidation = 0; // when mTimeStamp was last confirmed against the file system
+		std::atomic<Clock::rep> mLastAccess = 0;
+		std::once_flag mLoadFlag; // the first lookup loads the resolve map, all others wait for it
+		std::atomic<bool> mLoaded = false;
+		std::mutex mLoadedMutex; // lets threads outside of the lookup (e.g. invalidation) wait for mLoaded
+		std::condition_variable mLoadedCondition;
+		ResolveMapSPtr mResolveMap; // only valid after mLoadFlag has been passed
+		std::wstring mRPKURI;
+		uintmax_t mSize = 0; // of the RPK file or of the in-memory copy for RPKs embedded in a HDA
+		RPKDiskCache::ContentKey mContentKey; // only set for embedded RPKs and RPKs from the disk cache
+		std::filesystem::path mContentPath;   // the RPK file described by mContentKey, compared before sharing
+	};
+	using ResolveMapCacheEntrySPtr = std::shared_ptr<ResolveMapCacheEntry>;
+	using Cache = std::map<KeyType, ResolveMapCacheEntrySPtr>;
+
+	struct EmbeddedRPK {
+		std::shared_ptr<const char> data;
+		size_t size = 0;
 	};
-	using Cache = std::map<KeyType, ResolveMapCacheEntry>;
+	std::multimap<std::string, EmbeddedRPK> mEmbeddedRPKs; // by content digest, destroyed after the resolve maps
+	std::mutex mEmbeddedRPKsMutex;
+
 	Cache mCache;
+	mutable std::shared_mutex mCacheMutex;
+
+	void load(const std::filesystem::path& rpk, ResolveMapCacheEntry& entry);
+	void invalidate(ResolveMapCacheEntry& entry);
+	void evict(const ResolveMapCacheEntrySPtr& keep);
+	bool share(ResolveMapCacheEntry& entry, const std::wstring& rpkURI, const void* data, size_t size);
+	bool isShared(const ResolveMapCacheEntry& entry) const;
+
+	bool isRecentlyValidated(const ResolveMapCacheEntry& entry, Clock::time_point now) const;
 
 	const std::filesystem::path mRPKUnpackPath;
+	prt::CacheObject* mPRTCache;
+	const std::chrono::milliseconds mValidationInterval;
+	const Limits mLimits;
+	const bool mShareIdenticalRPKs; // identical embedded RPKs (e.g. in copies of a HDA) share one resolve map
+	const RPKDiskCacheUPtr mDiskCache; // optional, persistent across sessions and shared between processes
+
+	std::atomic<size_t> mHits = 0;
+	std::atomic<size_t> mMisses = 0;
+	std::atomic<size_t> mReloads = 0;
+	std::atomic<size_t> mCoalescedLoads = 0;
+	std::atomic<size_t> mValidations = 0;
+	std::atomic<size_t> mFlushedPRTEntries = 0;
+	std::atomic<size_t> mEvictions = 0;
+	std::atomic<uintmax_t> mResidentSize = 0;
+	std::atomic<int64_t> mLoadTimeNs = 0;
 };
 
 using ResolveMapCacheUPtr = std::unique_ptr<ResolveMapCache>;
\ No newline at end of file
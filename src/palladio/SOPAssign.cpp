@@ -20,12 +20,13 @@
 #include "AttributeConversion.h"
 #include "LogHandler.h"
 #include "ModelConverter.h"
-#include "MultiWatch.h"
 #include "NodeParameter.h"
 #include "NodeSpareParameter.h"
 #include "PrimitiveClassifier.h"
+#include "SceneCapture.h"
 #include "ShapeData.h"
 #include "ShapeGenerator.h"
+#include "Tracing.h"
 
 #include "prt/API.h"
 
@@ -33,6 +34,7 @@
 
 #include "CH/CH_Manager.h"
 #include "GEO/GEO_AttributeHandle.h"
+#include "OP/OP_NodeInfoParms.h"
 #include "UT/UT_Interrupt.h"
 
 namespace {
@@ -653,7 +655,7 @@ AttributeMapUPtr generateAttributeMapFromParameterValues(SOPAssign* node, const
 bool evaluateDefaultRuleAttributes(SOPAssign* node, const GU_Detail* detail, ShapeData& shapeData,
                                    const ShapeConverterUPtr& shapeConverter, const PRTContextUPtr& prtCtx,
                                    std::string& errors) {
-	WA("all");
+	PLD_TRACE_SCOPE("default rule attributes");
 
 	assert(shapeData.isValid());
 
@@ -717,7 +719,7 @@ bool evaluateDefaultRuleAttributes(SOPAssign* node, const GU_Detail* detail, Sha
 		prt::Status status = prt::STATUS_UNSPECIFIED_ERROR;
 		const prt::InitialShape* initialShape = isb->createInitialShapeAndReset(&status);
 		if (status == prt::STATUS_OK && initialShape != nullptr) {
-			shapeData.addShape(initialShape, std::move(amb), std::move(ruleAttr));
+			shapeData.addShape(isIdx, initialShape, std::move(amb), std::move(ruleAttr), ma.mRPK);
 		}
 		else
 			LOG_WRN << "failed to create initial shape " << shapeName << ": " << prt::getStatusDescription(status);
@@ -727,6 +729,14 @@ bool evaluateDefaultRuleAttributes(SOPAssign* node, const GU_Detail* detail, Sha
 	// run generate to evaluate default rule attributes
 	AttrEvalCallbacks aec(shapeData.getRuleAttributeMapBuilders(), ruleFileInfos);
 	const InitialShapeNOPtrVector& is = shapeData.getInitialShapes();
+
+	// optionally capture the initial shapes to rerun the evaluation without houdini
+	const std::filesystem::path captureFile = getSceneCaptureFile(node->getName().toStdString());
+	if (!captureFile.empty() && captureScene(captureFile, is, shapeData.getRulePackages(), false,
+	                                         {std::begin(encs), std::end(encs)},
+	                                         {std::begin(encsOpts), std::end(encsOpts)}, nullptr))
+		LOG_INF << node->getName() << ": captured initial shapes to " << captureFile;
+
 	const prt::Status stat = prt::generate(is.data(), is.size(), nullptr, encs, encsCount, encsOpts, &aec,
 	                                       prtCtx->mPRTCache.get(), nullptr, nullptr, nullptr);
 	if (stat != prt::STATUS_OK) {
@@ -1207,8 +1217,10 @@ void SOPAssign::buildUI(const RuleAttributeSet& ruleAttributes, const RuleFileIn
 }
 
 OP_ERROR SOPAssign::cookMySop(OP_Context& context) {
-	WA_NEW_LAP
-	WA("all");
+	PLD_TRACE_COOK(getName().toStdString());
+
+	mCookReport = {};
+	const ResolveMapCache::Statistics rmcStatsBefore = mPRTCtx->mResolveMapCache->getStatistics();
 
 	logging::ScopedLogLevelModifier scopedLogLevel(CommonNodeParams::getLogLevel(this, context.getTime()));
 
@@ -1225,10 +1237,19 @@ OP_ERROR SOPAssign::cookMySop(OP_Context& context) {
 		mShapeConverter->getMainAttributes(this, context);
 
 		ShapeData shapeData;
-		mShapeConverter->get(gdp, primCls, shapeData, mPRTCtx);
+		{
+			CookReport::StageTimer stageTimer(mCookReport, "initial shapes");
+			mShapeConverter->get(gdp, primCls, shapeData, mPRTCtx);
+		}
+		mCookReport.initialShapes = shapeData.getInitialShapeBuilders().size();
+
 		std::string evalAttrErrorMessage;
-		const bool canContinue =
-		        evaluateDefaultRuleAttributes(this, gdp, shapeData, mShapeConverter, mPRTCtx, evalAttrErrorMessage);
+		bool canContinue = false;
+		{
+			CookReport::StageTimer stageTimer(mCookReport, "default rule attributes");
+			canContinue = evaluateDefaultRuleAttributes(this, gdp, shapeData, mShapeConverter, mPRTCtx,
+			                                            evalAttrErrorMessage);
+		}
 		if (!canContinue) {
 			const std::string errMsg =
 			        "Could not successfully evaluate default rule attributes:\n" + evalAttrErrorMessage;
@@ -1256,7 +1277,17 @@ OP_ERROR SOPAssign::cookMySop(OP_Context& context) {
 		updateUIDefaultValues(this, getStyle(), mDefaultCGAAttributes);
 		updatePrimitiveAttributes(gdp);
 
-		mShapeConverter->put(gdp, primCls, shapeData);
+		{
+			CookReport::StageTimer stageTimer(mCookReport, "detail write");
+			mShapeConverter->put(gdp, primCls, shapeData);
+		}
+
+		mCookReport.primitives = gdp->getNumPrimitives();
+		mCookReport.points = gdp->getNumPoints();
+		mCookReport.memoryUsage = gdp->getMemoryUsage(true);
+		mCookReport.setResolveMapCacheStatistics(rmcStatsBefore, mPRTCtx->mResolveMapCache->getStatistics());
+		mCookReport.finish();
+		mCookReport.write(getName().toStdString());
 	}
 
 	unlockInputs();
@@ -1297,3 +1328,16 @@ void SOPAssign::opChanged(OP_EventType reason, void* data) {
 		}
 	}
 }
+
+void SOPAssign::finishedLoadingNetwork(bool isChildCall) {
+	SOP_Node::finishedLoadingNetwork(isChildCall);
+
+	// start loading the RPK while the rest of the scene is still loading
+	mPRTCtx->preloadResolveMap(AssignNodeParams::getRPK(this, CHgetEvalTime()));
+}
+
+void SOPAssign::getNodeSpecificInfoText(OP_Context& context, OP_NodeInfoParms& iparms) {
+	SOP_Node::getNodeSpecificInfoText(context, iparms);
+	if (mCookReport.cookTime.count() > 0.0)
+		iparms.append(mCookReport.toText().c_str());
+}
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include "CookReport.h"
 #include "PRTContext.h"
 #include "RuleAttributes.h"
 #include "ShapeConverter.h"
@@ -43,6 +44,8 @@ public:
 	void updatePrimitiveAttributes(GU_Detail* detail);
 	void buildUI(const RuleAttributeSet& ruleAttributes, const RuleFileInfoUPtr& ruleFileInfo);
 	void opChanged(OP_EventType reason, void* data = nullptr) override;
+	void finishedLoadingNetwork(bool isChildCall = false) override;
+	void getNodeSpecificInfoText(OP_Context& context, OP_NodeInfoParms& iparms) override;
 
 protected:
 	OP_ERROR cookMySop(OP_Context& context) override;
@@ -50,6 +53,7 @@ protected:
 private:
 	const PRTContextUPtr& mPRTCtx;
 	ShapeConverterUPtr mShapeConverter;
+	CookReport mCookReport;
 
 public:
 	using CGAAttributeValueType = std::variant<std::monostate, std::wstring, double, bool, std::vector<std::wstring>,
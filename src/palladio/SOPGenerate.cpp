@@ -15,18 +15,32 @@
  */
 
 #include "SOPGenerate.h"
+#include "CallbackRecording.h"
+#include "Deduplication.h"
 #include "ModelConverter.h"
-#include "MultiWatch.h"
 #include "NodeParameter.h"
+#include "OcclusionPipeline.h"
+#include "Preview.h"
 #include "PrimitiveClassifier.h"
+#include "SceneCapture.h"
 #include "ShapeData.h"
 #include "ShapeGenerator.h"
-
+#include "Sharding.h"
+#include "Tracing.h"
+#include "WorkerGenerate.h"
+
+#include "GA/GA_ElementGroup.h"
+#include "GA/GA_Iterator.h"
+#include "OBJ/OBJ_Camera.h"
+#include "OP/OP_NodeInfoParms.h"
 #include "UT/UT_Interrupt.h"
 
 #include <algorithm>
+#include <array>
 #include <future>
+#include <iterator>
 #include <memory>
+#include <numeric>
 
 namespace {
 
@@ -84,16 +98,47 @@ bool SOPGenerate::handleParams(OP_Context& context) {
 namespace {
 
 enum class BatchMode { OCCLUSION, GENERATION };
-const std::vector<std::string> BATCH_MODE_NAMES = {"occlusion", "generation"};
+constexpr const char* BATCH_MODE_NAMES[] = {"occlusion", "generation"};
+
+// generates each initial shape separately to measure it, this is slower and only meant for diagnostics
+prt::Status generateWithStatistics(const InitialShapeNOPtrVector& is, size_t isStartPos, size_t isPastEndPos,
+                                   const std::vector<prt::OcclusionSet::Handle>& occlusionHandles,
+                                   const std::vector<const wchar_t*>& allEncoders,
+                                   const AttributeMapNOPtrVector& allEncoderOptions, ModelConverter& modelConverter,
+                                   prt::Callbacks* callbacks, prt::Cache* prtCache, prt::OcclusionSet* occlusionSet,
+                                   const prt::AttributeMap* genOpts,
+                                   std::vector<InitialShapeStatistics>& shapeStatistics) {
+	prt::Status batchStatus = prt::STATUS_OK;
+	for (size_t isIdx = isStartPos; isIdx < isPastEndPos; isIdx++) {
+		InitialShapeStatistics& iss = shapeStatistics[isIdx];
+		modelConverter.setShapeStatistics(&iss);
+
+		const auto begin = CookReport::Clock::now();
+		const prt::Status status =
+		        prt::generate(&is[isIdx], 1, &occlusionHandles[isIdx], allEncoders.data(), allEncoders.size(),
+		                      allEncoderOptions.data(), callbacks, prtCache, occlusionSet, genOpts);
+		iss.generateTime = CookReport::Duration(CookReport::Clock::now() - begin).count();
+
+		if (status != prt::STATUS_OK)
+			batchStatus = status;
+	}
+	modelConverter.setShapeStatistics(nullptr);
+	return batchStatus;
+}
 
+// callbacks holds the callbacks of each thread, hg the model converters at the end of the callback chains
 std::vector<prt::Status> batchGenerate(BatchMode mode, uint16_t nThreads, std::vector<ModelConverterUPtr>& hg,
-                                       size_t isRangeSize, const InitialShapeNOPtrVector& is,
+                                       const std::vector<prt::Callbacks*>& callbacks, const InitialShapeNOPtrVector& is,
                                        const std::vector<const wchar_t*>& allEncoders,
                                        const AttributeMapNOPtrVector& allEncoderOptions,
                                        std::vector<prt::OcclusionSet::Handle>& occlusionHandles,
                                        OcclusionSetUPtr& occlusionSet, CacheObjectUPtr& prtCache,
-                                       const AttributeMapUPtr& genOpts) {
+                                       const AttributeMapUPtr& genOpts, CookReport& cookReport,
+                                       std::vector<InitialShapeStatistics>& shapeStatistics) {
+	const size_t isRangeSize = is.size() / nThreads; // the last thread takes the remainder
 	std::vector<prt::Status> batchStatus(nThreads, prt::STATUS_UNSPECIFIED_ERROR);
+	std::vector<CookReport::Duration> busyTimes(nThreads, CookReport::Duration(0.0));
+	const auto batchBegin = CookReport::Clock::now();
 
 	std::vector<std::future<void>> futures;
 	futures.reserve(nThreads);
@@ -107,20 +152,31 @@ std::vector<prt::Status> batchGenerate(BatchMode mode, uint16_t nThreads, std::v
 
 			LOG_DBG << "thread " << ti << ": #is = " << isActualRangeSize;
 
+			PLD_TRACE_SCOPE(BATCH_MODE_NAMES[(int)mode]);
+			const auto threadBegin = CookReport::Clock::now();
+
 			switch (mode) {
 				case BatchMode::OCCLUSION: {
 					batchStatus[ti] = prt::generateOccluders(isRangeStart, isActualRangeSize, isOcclRangeStart, nullptr,
-					                                         0, nullptr, hg[ti].get(), prtCache.get(),
+					                                         0, nullptr, callbacks[ti], prtCache.get(),
 					                                         occlusionSet.get(), genOpts.get());
 					break;
 				}
 				case BatchMode::GENERATION: {
+					if (!shapeStatistics.empty()) {
+						batchStatus[ti] = generateWithStatistics(is, isStartPos, isPastEndPos, occlusionHandles,
+						                                         allEncoders, allEncoderOptions, *hg[ti], callbacks[ti],
+						                                         prtCache.get(), occlusionSet.get(), genOpts.get(),
+						                                         shapeStatistics);
+						break;
+					}
 					batchStatus[ti] = prt::generate(isRangeStart, isActualRangeSize, isOcclRangeStart,
 					                                allEncoders.data(), allEncoders.size(), allEncoderOptions.data(),
-					                                hg[ti].get(), prtCache.get(), occlusionSet.get(), genOpts.get());
+					                                callbacks[ti], prtCache.get(), occlusionSet.get(), genOpts.get());
 					break;
 				}
 			}
+			busyTimes[ti] = CookReport::Clock::now() - threadBegin;
 
 			if (batchStatus[ti] != prt::STATUS_OK) {
 				LOG_WRN << "batch mode " << BATCH_MODE_NAMES[(int)mode] << " failed with status: '"
@@ -132,19 +188,119 @@ std::vector<prt::Status> batchGenerate(BatchMode mode, uint16_t nThreads, std::v
 	}
 	std::for_each(futures.begin(), futures.end(), [](std::future<void>& f) { f.wait(); });
 
+	const CookReport::Duration batchTime = CookReport::Clock::now() - batchBegin;
+	cookReport.addStage(BATCH_MODE_NAMES[(int)mode], batchTime);
+	cookReport.threadWallTime += batchTime;
+	for (const auto& t : busyTimes)
+		cookReport.threadBusyTime += t;
+
 	return batchStatus;
 }
 
+void writeShapeStatistics(GU_Detail* detail, ShapeStatistics mode, const ShapeData& shapeData,
+                          const std::vector<size_t>& shapeIndices,
+                          const std::vector<InitialShapeStatistics>& shapeStatistics) {
+	GA_RWHandleD generateTime(detail->addFloatTuple(GA_ATTRIB_PRIMITIVE, PLD_GENERATE_TIME, 1));
+	GA_RWHandleI leafShapes(detail->addIntTuple(GA_ATTRIB_PRIMITIVE, PLD_LEAF_SHAPES, 1));
+	GA_RWHandleI faces(detail->addIntTuple(GA_ATTRIB_PRIMITIVE, PLD_FACES, 1));
+	GA_RWHandleI vertices(detail->addIntTuple(GA_ATTRIB_PRIMITIVE, PLD_VERTICES, 1));
+
+	auto setValues = [&](GA_Offset primOffset, const InitialShapeStatistics& iss) {
+		generateTime.set(primOffset, iss.generateTime);
+		leafShapes.set(primOffset, static_cast<int32>(iss.leafShapes));
+		faces.set(primOffset, static_cast<int32>(iss.faces));
+		vertices.set(primOffset, static_cast<int32>(iss.vertices));
+	};
+
+	for (size_t isIdx = 0; isIdx < shapeStatistics.size(); isIdx++) {
+		const InitialShapeStatistics& iss = shapeStatistics[isIdx];
+		if (mode == ShapeStatistics::INITIAL_SHAPES) {
+			for (const GA_Primitive* prim : shapeData.getInitialShapePrimitives(shapeIndices[isIdx]))
+				setValues(prim->getMapOffset(), iss);
+		}
+		else {
+			for (const auto& [start, size] : iss.primitiveRanges) {
+				for (GA_Offset primOffset = start; primOffset < start + size; primOffset++)
+					setValues(primOffset, iss);
+			}
+		}
+	}
+}
+
+// the generated initial shapes are followed by the neighbour occluders of other shards
+// inRegion restricts the generated initial shapes (if not empty), the shard shapes outside end up in outsideIndices
+void selectShard(const ShapeData& shapeData, const Sharding::Selection& selection, const std::vector<bool>& inRegion,
+                 InitialShapeNOPtrVector& occluders, std::vector<size_t>& shapeIndices,
+                 std::vector<size_t>& outsideIndices, std::vector<std::filesystem::path>& rulePackages) {
+	const InitialShapeNOPtrVector& allShapes = shapeData.getInitialShapes();
+
+	Sharding::Split split;
+	if (selection.count > 1) {
+		std::vector<uint64_t> keys(allShapes.size());
+		for (size_t isIdx = 0; isIdx < allShapes.size(); isIdx++)
+			keys[isIdx] = shapeData.getShardKey(isIdx);
+		split = Sharding::split(allShapes, keys, selection);
+	}
+	else {
+		split.shapes.resize(allShapes.size());
+		std::iota(split.shapes.begin(), split.shapes.end(), 0);
+	}
+
+	if (!inRegion.empty()) {
+		const auto outsideBegin =
+		        std::stable_partition(split.shapes.begin(), split.shapes.end(), [&](size_t i) { return inRegion[i]; });
+		outsideIndices.assign(outsideBegin, split.shapes.end());
+		split.shapes.erase(outsideBegin, split.shapes.end());
+	}
+
+	for (size_t isIdx : split.shapes) {
+		occluders.push_back(allShapes[isIdx]);
+		rulePackages.push_back(shapeData.getRulePackages()[isIdx]);
+	}
+	for (size_t isIdx : split.occluders)
+		occluders.push_back(allShapes[isIdx]);
+	shapeIndices = std::move(split.shapes);
+}
+
+// replaces the initial shapes in the detail by the primitives of the given initial shapes
+void keepInitialShapes(GU_Detail* detail, const ShapeData& shapeData, const std::vector<size_t>& shapeIndices) {
+	std::vector<bool> kept(detail->getNumPrimitiveOffsets(), false);
+	for (size_t isIdx : shapeIndices) {
+		for (const GA_Primitive* prim : shapeData.getInitialShapePrimitives(isIdx))
+			kept[static_cast<size_t>(prim->getMapOffset())] = true;
+	}
+
+	GA_PrimitiveGroupUPtr deleted = detail->createDetachedPrimitiveGroup();
+	for (GA_Iterator it(detail->getPrimitiveRange()); !it.atEnd(); ++it) {
+		if (!kept[static_cast<size_t>(*it)])
+			deleted->addOffset(*it);
+	}
+	detail->deletePrimitives(*deleted, true);
+}
+
 } // namespace
 
 OP_ERROR SOPGenerate::cookMySop(OP_Context& context) {
-	WA("all");
+	PLD_TRACE_COOK(getName().toStdString());
+
+	mCookReport = {};
+	const ResolveMapCache::Statistics rmcStatsBefore = mPRTCtx->mResolveMapCache->getStatistics();
 
 	logging::ScopedLogLevelModifier scopedLogLevel(CommonNodeParams::getLogLevel(this, context.getTime()));
 
 	if (!handleParams(context))
 		return UT_ERROR_ABORT;
 
+	// optionally only generate one shard of the initial shapes, e.g. to distribute a city over a farm
+	// (validated before the inputs are locked, the abort does not need to unlock them)
+	const Sharding::Selection shardSelection = GenerateNodeParams::getShardSelection(this, context.getTime());
+	if (shardSelection.index >= shardSelection.count) {
+		LOG_ERR << getName() << ": shard index " << shardSelection.index << " is out of range, the shard count is "
+		        << shardSelection.count;
+		addError(SOP_MESSAGE, "Shard index must be smaller than the shard count.");
+		return UT_ERROR_ABORT;
+	}
+
 	if (lockInputs(context) >= UT_ERROR_ABORT)
 		return error();
 
@@ -156,65 +312,293 @@ OP_ERROR SOPGenerate::cookMySop(OP_Context& context) {
 	UT_AutoInterrupt progress("Generating CityEngine geometry...");
 
 	const auto groupCreation = GenerateNodeParams::getGroupCreation(this, context.getTime());
+	const auto shapeStatisticsMode = GenerateNodeParams::getShapeStatistics(this, context.getTime());
 	ShapeData shapeData(groupCreation, toUTF16FromOSNarrow(getName().toStdString()));
 
-	ShapeGenerator shapeGen;
-	shapeGen.get(gdp, DEFAULT_PRIMITIVE_CLASSIFIER, shapeData, mPRTCtx);
+	// optionally emit cheap proxies instead of the full models, the extruded footprints do not run the rules at all
+	const Preview::Settings preview = GenerateNodeParams::getPreview(this, context.getTime());
+	const bool extrudeFootprints = (preview.mode == Preview::Mode::FOOTPRINTS);
+
+	// optionally generate in local worker processes, a crashing worker does not take houdini down
+	std::filesystem::path workerExecutable;
+	const size_t workerProcesses = GenerateNodeParams::getWorkerProcesses(this, context.getTime());
+	if (workerProcesses > 0 && !extrudeFootprints) {
+		if (shapeStatisticsMode != ShapeStatistics::NONE)
+			LOG_WRN << getName() << ": shape statistics are not supported in worker processes, generating in-process";
+		else {
+			workerExecutable = getWorkerExecutable();
+			if (workerExecutable.empty())
+				LOG_WRN << getName() << ": worker executable not found, generating in-process";
+		}
+	}
+	const bool useWorkers = !workerExecutable.empty();
+
+	// optionally generate identical initial shapes only once, this needs one add callback per generated initial shape
+	bool deduplicate = GenerateNodeParams::getDeduplicateShapes(this, context.getTime()) && !extrudeFootprints;
+	if (deduplicate && (shapeStatisticsMode != ShapeStatistics::NONE || useWorkers)) {
+		LOG_WRN << getName() << ": deduplication is not supported with shape statistics or worker processes, "
+		        << "generating all initial shapes";
+		deduplicate = false;
+	}
 
-	const InitialShapeNOPtrVector& is = shapeData.getInitialShapes();
-	if (is.empty()) {
+	// optionally only generate the initial shapes in a region of interest
+	const RegionOfInterest::Selection regionSelection =
+	        GenerateNodeParams::getRegionOfInterest(this, context.getTime());
+
+	// without shards, regions and workers all initial shapes are occluders in creation order, so the occlusion pass
+	// can already run while the remaining initial shapes are created
+	std::vector<std::vector<prt::Status>> occlusionStatuses;
+	std::vector<ModelConverterUPtr> occlusionConverters;
+	std::unique_ptr<OcclusionPipeline> occlusionPipeline;
+	if (shardSelection.count == 1 && regionSelection.mode == RegionOfInterest::Mode::NONE && !useWorkers &&
+	    !extrudeFootprints) {
+		// the generation pass reports the errors of the initial shapes again, the statuses of the batches are dropped
+		occlusionStatuses.resize(mPRTCtx->mCores, std::vector<prt::Status>(OcclusionPipeline::DEFAULT_BATCH_SIZE));
+		std::vector<prt::Callbacks*> callbacks;
+		for (auto& statuses : occlusionStatuses) {
+			occlusionConverters.emplace_back(std::make_unique<ModelConverter>(gdp, groupCreation, statuses, &progress));
+			callbacks.push_back(occlusionConverters.back().get());
+		}
+		occlusionPipeline = std::make_unique<OcclusionPipeline>(callbacks, mPRTCtx->mPRTCache.get(),
+		                                                        mGenerateOptions.get());
+	}
+
+	{
+		CookReport::StageTimer stageTimer(mCookReport, "initial shapes");
+		ShapeGenerator shapeGen;
+		if (occlusionPipeline)
+			shapeGen.mInitialShapeReceiver = [&](const prt::InitialShape* s) { occlusionPipeline->push(s); };
+		if (preview.mode == Preview::Mode::START_RULE)
+			shapeGen.mStartRuleOverride = preview.startRule;
+		shapeGen.get(gdp, DEFAULT_PRIMITIVE_CLASSIFIER, shapeData, mPRTCtx);
+	}
+
+	if (shapeData.getInitialShapes().empty()) {
 		LOG_ERR << getName() << ": could not extract any initial shapes from detail!";
 		return UT_ERROR_ABORT;
 	}
 
-	// establish threads
-	const size_t nThreads = std::min<size_t>(mPRTCtx->mCores, is.size());
-	const size_t isRangeSize = std::ceil(is.size() / nThreads);
+	std::vector<bool> inRegion; // per initial shape of shapeData
+	if (regionSelection.mode != RegionOfInterest::Mode::NONE &&
+	    !selectRegion(context, regionSelection, shapeData, inRegion)) {
+		unlockInputs(); // the region selection reads the locked input
+		return UT_ERROR_ABORT;
+	}
+
+	InitialShapeNOPtrVector occluders;
+	std::vector<size_t> shapeIndices;   // index into shapeData per generated initial shape
+	std::vector<size_t> outsideIndices; // index into shapeData per initial shape of the shard outside of the region
+	std::vector<std::filesystem::path> rulePackages;
+	selectShard(shapeData, shardSelection, inRegion, occluders, shapeIndices, outsideIndices, rulePackages);
+	const InitialShapeNOPtrVector is(occluders.begin(), occluders.begin() + shapeIndices.size());
+	if (shardSelection.count > 1) {
+		LOG_INF << getName() << ": shard " << shardSelection.index << " of " << shardSelection.count << ": "
+		        << is.size() + outsideIndices.size() << " of " << shapeData.getInitialShapes().size()
+		        << " initial shapes, " << occluders.size() - is.size() << " neighbour occluders";
+	}
+	if (regionSelection.mode != RegionOfInterest::Mode::NONE) {
+		LOG_INF << getName() << ": region of interest: " << is.size() << " of " << is.size() + outsideIndices.size()
+		        << " initial shapes";
+	}
+
+	// the initial shapes outside of the region optionally stay in the output
+	auto clearOutput = [&]() {
+		if (regionSelection.outside == RegionOfInterest::Outside::PASS_THROUGH && !outsideIndices.empty())
+			keepInitialShapes(gdp, shapeData, outsideIndices);
+		else
+			gdp->clearAndDestroy();
+	};
 
-	// prepare generate status receivers
-	std::vector<prt::Status> initialShapeStatus(is.size(), prt::STATUS_OK);
+	if (is.empty()) {
+		addWarning(SOP_MESSAGE, "The shard or region of interest does not contain any initial shapes.");
+		clearOutput();
+		unlockInputs();
+		return error();
+	}
+
+	// optionally capture the initial shapes to rerun the generate workload without houdini
+	const std::filesystem::path captureFile = getSceneCaptureFile(getName().toStdString());
+	if (!captureFile.empty() && captureScene(captureFile, is, rulePackages, true, mAllEncoders, mAllEncoderOptions,
+	                                         mGenerateOptions.get()))
+		LOG_INF << getName() << ": captured initial shapes to " << captureFile;
+
+	// optionally only generate one representative of each class of identical initial shapes
+	Deduplication::Classes duplicateClasses;
+	InitialShapeNOPtrVector representatives;
+	if (deduplicate) {
+		CookReport::StageTimer stageTimer(mCookReport, "deduplication");
+		duplicateClasses = Deduplication::classify(is);
+		for (const size_t isIdx : duplicateClasses.representatives)
+			representatives.push_back(is[isIdx]);
+		LOG_INF << getName() << ": deduplication: generating " << representatives.size() << " of " << is.size()
+		        << " initial shapes, " << duplicateClasses.getDuplicateCount() << " are copies";
+	}
+	const InitialShapeNOPtrVector& generated = deduplicate ? representatives : is;
+
+	// establish threads (or worker processes)
+	const size_t nThreads = std::min<size_t>(useWorkers ? workerProcesses : mPRTCtx->mCores, generated.size());
+	const size_t isRangeSize = std::ceil(generated.size() / nThreads);
+
+	// prepare generate status receivers, the occlusion pass also reports the neighbour occluders
+	std::vector<prt::Status> initialShapeStatus(occluders.size(), prt::STATUS_OK);
+
+	// prepare per initial shape statistics
+	std::vector<InitialShapeStatistics> shapeStatistics;
+	if (shapeStatisticsMode != ShapeStatistics::NONE)
+		shapeStatistics.resize(is.size());
 
 	if (!progress.wasInterrupted()) {
-		gdp->clearAndDestroy();
+		// in diagnostic mode the initial shapes are kept to carry the statistics, the generated geometry is discarded
+		GU_Detail discardedDetail;
+		GU_Detail* outputDetail = gdp;
+		if (shapeStatisticsMode == ShapeStatistics::INITIAL_SHAPES)
+			outputDetail = &discardedDetail;
+		else
+			clearOutput();
 		{
-			WA("generate");
+			PLD_TRACE_SCOPE("generate");
+
+			// the generate threads hand their meshes to one writer thread instead of waiting for the detail
+			DetailWriter detailWriter;
 
 			// prt requires one callback instance per generate call
 			std::vector<ModelConverterUPtr> modelConverters(nThreads);
 			std::generate(modelConverters.begin(), modelConverters.end(),
-			              [this, &groupCreation, &initialShapeStatus, &progress]() -> ModelConverterUPtr {
-				              return std::make_unique<ModelConverter>(gdp, groupCreation, initialShapeStatus,
-				                                                      &progress);
+			              [outputDetail, &groupCreation, &initialShapeStatus, &progress,
+			               &detailWriter]() -> ModelConverterUPtr {
+				              return std::make_unique<ModelConverter>(outputDetail, groupCreation,
+				                                                      initialShapeStatus, &progress, &detailWriter);
 			              });
 
-			std::vector<prt::OcclusionSet::Handle> occlusionHandles(is.size());
-			OcclusionSetUPtr occlusionSet{prt::OcclusionSet::create()};
+			// optionally record the geometry and attribute callbacks for offline replay
+			CallbackRecordingUPtr callbackRecording;
+			std::vector<CallbackRecorderUPtr> callbackRecorders;
+			const std::filesystem::path recordingFile = CallbackRecording::getRecordingFile(getName().toStdString());
+			if (!recordingFile.empty()) {
+				callbackRecording = std::make_unique<CallbackRecording>(recordingFile);
+				if (callbackRecording->isOpen()) {
+					// the recorders number their streams in this order, i.e. stream i is generate thread i
+					for (const auto& modelConverter : modelConverters)
+						callbackRecorders.emplace_back(
+						        std::make_unique<CallbackRecorder>(*callbackRecording, *modelConverter));
+					LOG_INF << getName() << ": recording callbacks to " << recordingFile;
+				}
+			}
+
+			std::vector<HoudiniCallbacks*> sinks;
+			for (size_t ti = 0; ti < nThreads; ti++) {
+				if (callbackRecorders.empty())
+					sinks.push_back(modelConverters[ti].get());
+				else
+					sinks.push_back(callbackRecorders[ti].get());
+			}
+
+			if (extrudeFootprints) {
+				LOG_INF << getName() << ": extruding footprints: #initial shapes = " << is.size();
+
+				CookReport::StageTimer stageTimer(mCookReport, "footprints");
+				for (size_t isIdx = 0; isIdx < is.size(); isIdx++) {
+					if (!shapeStatistics.empty())
+						modelConverters[0]->setShapeStatistics(&shapeStatistics[isIdx]);
+					const double height = Preview::getHeight(is[isIdx], preview.heightAttribute, preview.defaultHeight);
+					Preview::addExtrudedFootprint(*sinks[0], is[isIdx], height);
+				}
+				modelConverters[0]->setShapeStatistics(nullptr);
+			}
+			else if (useWorkers) {
+				// the workers only see their own shapes, the neighbour occluders of the shard are not used
+				LOG_INF << getName() << ": calling generate: #initial shapes = " << is.size()
+				        << ", #worker processes = " << nThreads << ", initial shapes per worker = " << isRangeSize;
+
+				const auto threadsPerWorker = static_cast<uint32_t>(std::max<size_t>(mPRTCtx->mCores / nThreads, 1));
+				CookReport::StageTimer stageTimer(mCookReport, "workers");
+				const size_t failedWorkers =
+				        generateInWorkers(workerExecutable, getName().toStdString(), is, rulePackages, mAllEncoders,
+				                          mAllEncoderOptions, threadsPerWorker, sinks, initialShapeStatus);
+				if (failedWorkers > 0)
+					LOG_WRN << getName() << ": " << failedWorkers << " of " << nThreads << " worker processes failed";
+			}
+			else {
+				std::vector<prt::OcclusionSet::Handle> occlusionHandles; // is comes first
+				OcclusionSetUPtr batchOcclusionSet;
+				if (occlusionPipeline) {
+					PLD_TRACE_SCOPE("wait for occlusion");
+					occlusionHandles = occlusionPipeline->finish(mCookReport);
+				}
+				else {
+					occlusionHandles.resize(occluders.size());
+					batchOcclusionSet.reset(prt::OcclusionSet::create());
+				}
+				OcclusionSetUPtr& occlusionSet =
+				        occlusionPipeline ? occlusionPipeline->getOcclusionSet() : batchOcclusionSet;
+
+				LOG_INF << getName() << ": calling generate: #initial shapes = " << generated.size()
+				        << ", #threads = " << nThreads << ", initial shapes per thread = " << isRangeSize;
+
+				const std::vector<prt::Callbacks*> callbacks(sinks.begin(), sinks.end());
+				if (!occlusionPipeline)
+					batchGenerate(BatchMode::OCCLUSION, nThreads, modelConverters, callbacks, occluders,
+					              mAllEncoders, mAllEncoderOptions, occlusionHandles, occlusionSet,
+					              mPRTCtx->mPRTCache, mGenerateOptions, mCookReport, shapeStatistics);
+
+				// the duplicates are still occluders, only their generation is replaced by copies
+				std::vector<prt::Callbacks*> generateCallbacks = callbacks;
+				std::vector<std::unique_ptr<Deduplication::DuplicateEmitter>> duplicateEmitters;
+				std::vector<prt::OcclusionSet::Handle> representativeHandles;
+				if (deduplicate) {
+					for (size_t ti = 0; ti < nThreads; ti++) {
+						duplicateEmitters.emplace_back(std::make_unique<Deduplication::DuplicateEmitter>(
+						        *sinks[ti], duplicateClasses, is, ti * isRangeSize));
+						generateCallbacks[ti] = duplicateEmitters.back().get();
+					}
+					for (const size_t isIdx : duplicateClasses.representatives)
+						representativeHandles.push_back(occlusionHandles[isIdx]);
+				}
 
-			LOG_INF << getName() << ": calling generate: #initial shapes = " << is.size() << ", #threads = " << nThreads
-			        << ", initial shapes per thread = " << isRangeSize;
+				batchGenerate(BatchMode::GENERATION, nThreads, modelConverters, generateCallbacks, generated,
+				              mAllEncoders, mAllEncoderOptions, deduplicate ? representativeHandles : occlusionHandles,
+				              occlusionSet, mPRTCtx->mPRTCache, mGenerateOptions, mCookReport, shapeStatistics);
 
-			batchGenerate(BatchMode::OCCLUSION, nThreads, modelConverters, isRangeSize, is, mAllEncoders,
-			              mAllEncoderOptions, occlusionHandles, occlusionSet, mPRTCtx->mPRTCache, mGenerateOptions);
+				occlusionSet->dispose(occlusionHandles.data(), occlusionHandles.size());
+			}
 
-			batchGenerate(BatchMode::GENERATION, nThreads, modelConverters, isRangeSize, is, mAllEncoders,
-			              mAllEncoderOptions, occlusionHandles, occlusionSet, mPRTCtx->mPRTCache, mGenerateOptions);
+			{
+				PLD_TRACE_SCOPE("wait for detail writes");
+				CookReport::StageTimer stageTimer(mCookReport, "detail writes");
+				detailWriter.finish();
+				mCookReport.detailWriteTime = detailWriter.getBusyTime();
+			}
 
-			occlusionSet->dispose(occlusionHandles.data(), occlusionHandles.size());
+			// the generated primitive ranges are only valid before buildHoles
+			if (!shapeStatistics.empty())
+				writeShapeStatistics(gdp, shapeStatisticsMode, shapeData, shapeIndices, shapeStatistics);
 
 			// all modification of gdb is done, now it is safe to run buildHoles on the
 			// collected primitive groups
-			for (auto& modelConverter : modelConverters)
+			PLD_TRACE_SCOPE("build holes");
+			CookReport::StageTimer stageTimer(mCookReport, "build holes");
+			for (auto& modelConverter : modelConverters) {
 				modelConverter->buildHoles();
+				mCookReport.lockWaitTime += modelConverter->getLockWaitTime();
+			}
 		}
 		select();
 	}
 
-	WA_PRINT_TIMINGS
+	mCookReport.initialShapes = is.size();
+	mCookReport.threads = nThreads;
+	mCookReport.primitives = gdp->getNumPrimitives();
+	mCookReport.points = gdp->getNumPoints();
+	mCookReport.memoryUsage = gdp->getMemoryUsage(true);
+	mCookReport.setResolveMapCacheStatistics(rmcStatsBefore, mPRTCtx->mResolveMapCache->getStatistics());
+	mCookReport.finish();
+	mCookReport.write(getName().toStdString());
 
 	unlockInputs();
 
 	// generate status check: if all shapes fail, we abort cooking (failure of individual shapes is sometimes expected)
-	const size_t isSuccesses = std::count(initialShapeStatus.begin(), initialShapeStatus.end(), prt::STATUS_OK);
+	const size_t isSuccesses =
+	        std::count(initialShapeStatus.begin(), initialShapeStatus.begin() + is.size(), prt::STATUS_OK);
 	if (isSuccesses == 0) {
 		LOG_ERR << getName() << ": All initial shapes failed to generate, cooking aborted.";
 		addError(SOP_MESSAGE, "All initial shapes failed to generate.");
@@ -225,6 +609,84 @@ OP_ERROR SOPGenerate::cookMySop(OP_Context& context) {
 	return error();
 }
 
+bool SOPGenerate::selectRegion(OP_Context& context, const RegionOfInterest::Selection& selection,
+                               const ShapeData& shapeData, std::vector<bool>& inRegion) {
+	PLD_TRACE_SCOPE("region of interest");
+	const InitialShapeNOPtrVector& shapes = shapeData.getInitialShapes();
+	inRegion.assign(shapes.size(), false);
+
+	if (selection.mode == RegionOfInterest::Mode::PRIMITIVE_GROUP) {
+		const GA_PrimitiveGroup* group = gdp->findPrimitiveGroup(selection.group.c_str());
+		if (group == nullptr) {
+			LOG_ERR << getName() << ": region of interest: primitive group '" << selection.group << "' not found";
+			addError(SOP_MESSAGE, "The primitive group of the region of interest does not exist.");
+			return false;
+		}
+		for (size_t isIdx = 0; isIdx < shapes.size(); isIdx++) {
+			const PrimitiveNOPtrVector& prims = shapeData.getInitialShapePrimitives(isIdx);
+			inRegion[isIdx] = std::any_of(prims.begin(), prims.end(), [group](const GA_Primitive* p) {
+				return group->containsOffset(p->getMapOffset());
+			});
+		}
+		return true;
+	}
+
+	// the initial shapes of an unchanged input have the same order and bounds, the index is reused
+	const GU_Detail* input = inputGeo(0, context);
+	const std::pair<exint, int64> inputVersion(input->getUniqueId(), input->getMetaCacheCount());
+	if (!mSpatialIndex || mSpatialIndexInput != inputVersion || mSpatialIndex->size() != shapes.size()) {
+		CookReport::StageTimer stageTimer(mCookReport, "spatial index");
+		std::vector<RegionOfInterest::Bounds> bounds;
+		bounds.reserve(shapes.size());
+		std::transform(shapes.begin(), shapes.end(), std::back_inserter(bounds), Sharding::getBounds);
+		mSpatialIndex = std::make_unique<RegionOfInterest::SpatialIndex>(std::move(bounds));
+		mSpatialIndexInput = inputVersion;
+	}
+
+	std::vector<size_t> selected;
+	if (selection.mode == RegionOfInterest::Mode::BOUNDING_BOX)
+		selected = mSpatialIndex->query(selection.box);
+	else {
+		OBJ_Node* cameraNode = findOBJNode(selection.camera.c_str());
+		OBJ_Camera* camera = (cameraNode != nullptr) ? cameraNode->castToOBJCamera() : nullptr;
+		if (camera == nullptr) {
+			LOG_ERR << getName() << ": region of interest: camera '" << selection.camera << "' not found";
+			addError(SOP_MESSAGE, "The camera of the region of interest does not exist.");
+			return false;
+		}
+		addExtraInput(camera, OP_INTEREST_DATA); // recook when the camera changes
+
+		const fpreal t = context.getTime();
+		UT_DMatrix4 cameraToWorld;
+		camera->getLocalToWorldTransform(context, cameraToWorld);
+
+		// the initial shape bounds are in the space of the object containing this SOP, the camera is in world space
+		UT_DMatrix4 cameraToSOP = cameraToWorld;
+		OBJ_Node* creator = (getCreator() != nullptr) ? getCreator()->castToOBJNode() : nullptr;
+		if (creator != nullptr) {
+			addExtraInput(creator, OP_INTEREST_DATA); // recook when the object moves
+			UT_DMatrix4 worldToSOP;
+			creator->getLocalToWorldTransform(context, worldToSOP);
+			if (worldToSOP.invert() == 0) // houdini transforms row vectors, i.e. the camera transform comes first
+				cameraToSOP = cameraToWorld * worldToSOP;
+		}
+
+		std::array<double, 16> cameraMatrix;
+		for (int r = 0; r < 4; r++) {
+			for (int c = 0; c < 4; c++)
+				cameraMatrix[r * 4 + c] = cameraToSOP(r, c);
+		}
+		const double aspectRatio = static_cast<double>(camera->RESY(t)) / (camera->RESX(t) * camera->ASPECT(t));
+		const RegionOfInterest::Frustum frustum =
+		        RegionOfInterest::getFrustum(cameraMatrix, camera->FOCAL(t), camera->APERTURE(t), aspectRatio,
+		                                     camera->getNEAR(t), camera->getFAR(t));
+		selected = mSpatialIndex->query(frustum);
+	}
+	for (size_t isIdx : selected)
+		inRegion[isIdx] = true;
+	return true;
+}
+
 void SOPGenerate::opChanged(OP_EventType reason, void* data) {
 	SOP_Node::opChanged(reason, data);
 
@@ -232,3 +694,9 @@ void SOPGenerate::opChanged(OP_EventType reason, void* data) {
 	if (reason == OP_NAME_CHANGED)
 		forceRecook();
 }
+
+void SOPGenerate::getNodeSpecificInfoText(OP_Context& context, OP_NodeInfoParms& iparms) {
+	SOP_Node::getNodeSpecificInfoText(context, iparms);
+	if (mCookReport.cookTime.count() > 0.0)
+		iparms.append(mCookReport.toText().c_str());
+}
@@ -16,25 +16,36 @@
 
 #pragma once
 
+#include "CookReport.h"
 #include "LogHandler.h"
 #include "PRTContext.h"
+#include "RegionOfInterest.h"
 #include "ShapeConverter.h"
 #include "Utils.h"
 
 #include "SOP/SOP_Node.h"
 
+#include <memory>
+#include <utility>
+#include <vector>
+
+class ShapeData;
+
 class SOPGenerate : public SOP_Node {
 public:
 	SOPGenerate(const PRTContextUPtr& pCtx, OP_Network* net, const char* name, OP_Operator* op);
 	~SOPGenerate() override = default;
 
 	void opChanged(OP_EventType reason, void* data) override;
+	void getNodeSpecificInfoText(OP_Context& context, OP_NodeInfoParms& iparms) override;
 
 protected:
 	OP_ERROR cookMySop(OP_Context& context) override;
 
 private:
 	bool handleParams(OP_Context& context);
+	bool selectRegion(OP_Context& context, const RegionOfInterest::Selection& selection, const ShapeData& shapeData,
+	                  std::vector<bool>& inRegion);
 
 private:
 	const PRTContextUPtr& mPRTCtx;
@@ -45,4 +56,10 @@ private:
 	std::vector<const wchar_t*> mAllEncoders;
 	AttributeMapNOPtrVector mAllEncoderOptions;
 	AttributeMapUPtr mGenerateOptions;
+
+	CookReport mCookReport;
+
+	// bounds of the initial shapes for the region of interest, rebuilt when the input geometry changes
+	std::unique_ptr<RegionOfInterest::SpatialIndex> mSpatialIndex;
+	std::pair<exint, int64> mSpatialIndexInput{-1, -1}; // unique id and meta cache count of the input detail
 };
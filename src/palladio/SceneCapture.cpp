@@ -0,0 +1,195 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SceneCapture.h"
+#include "BinaryStream.h"
+#include "LogHandler.h"
+
+#include "prt/API.h"
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+using namespace BinaryStream;
+
+constexpr const char* CAPTURE_SCENE_DIR_ENV_VAR = "CITYENGINE_CAPTURE_SCENE_DIR";
+constexpr const char* SCENE_FILE_EXT = ".pldscene";
+constexpr Magic SCENE_MAGIC = {'P', 'L', 'D', 'S', 'C', 'E', 'N', 'E'};
+constexpr uint32_t SCENE_VERSION = 1;
+constexpr const char* SCENE_FILE_KIND = "scene capture";
+
+void writeOptionalAttributeMap(std::ostream& out, const prt::AttributeMap* am) {
+	write<uint8_t>(out, (am != nullptr) ? 1 : 0);
+	if (am != nullptr)
+		writeAttributeMap(out, am);
+}
+
+void writeShape(std::ostream& out, const prt::InitialShape& is, const std::filesystem::path& rulePackage) {
+	writeString(out, rulePackage.wstring().c_str());
+	writeString(out, is.getRuleFile());
+	writeString(out, is.getStartRule());
+	writeString(out, is.getName());
+	write<int32_t>(out, is.getRandomSeed());
+
+	writeArray(out, is.getVertices(), is.getVertexCount());
+	writeArray(out, is.getIndices(), is.getIndexCount());
+	writeArray(out, is.getFaceCounts(), is.getFaceCountsCount());
+	writeArray(out, is.getHoles(), is.getHolesCount());
+
+	const uint32_t uvSets = is.getUVSetsCount();
+	write<uint32_t>(out, uvSets);
+	for (uint32_t u = 0; u < uvSets; u++) {
+		writeArray(out, is.getUVs(u), is.getUVsCount(u));
+		writeArray(out, is.getUVIndices(u), is.getUVIndicesCount(u));
+		writeArray(out, is.getFaceUVCounts(u), is.getFaceUVCountsCount(u));
+	}
+
+	writeOptionalAttributeMap(out, is.getAttributeMap());
+}
+
+AttributeMapUPtr readOptionalAttributeMap(Reader& reader) {
+	if (reader.read<uint8_t>() == 0)
+		return {};
+	return reader.readAttributeMap();
+}
+
+CapturedShape readShape(Reader& reader) {
+	CapturedShape shape;
+	shape.rulePackage = reader.readString();
+	shape.ruleFile = reader.readString();
+	shape.startRule = reader.readString();
+	shape.name = reader.readString();
+	shape.randomSeed = reader.read<int32_t>();
+
+	shape.vertices = reader.readArray<double>();
+	shape.indices = reader.readArray<uint32_t>();
+	shape.faceCounts = reader.readArray<uint32_t>();
+	shape.holes = reader.readArray<uint32_t>();
+
+	shape.uvSets.resize(reader.read<uint32_t>());
+	for (auto& uvSet : shape.uvSets) {
+		uvSet.uvs = reader.readArray<double>();
+		uvSet.indices = reader.readArray<uint32_t>();
+		uvSet.faceCounts = reader.readArray<uint32_t>();
+	}
+
+	shape.attributes = readOptionalAttributeMap(reader);
+	if (!shape.attributes) { // setAttributes requires a map
+		const AttributeMapBuilderUPtr amb(prt::AttributeMapBuilder::create());
+		shape.attributes.reset(amb->createAttributeMap());
+	}
+	return shape;
+}
+
+} // namespace
+
+std::filesystem::path getSceneCaptureFile(const std::string& nodeName) {
+	const char* e = std::getenv(CAPTURE_SCENE_DIR_ENV_VAR);
+	if (e == nullptr || std::strlen(e) == 0)
+		return {};
+
+	const std::filesystem::path captureDir = e;
+	std::error_code ec;
+	std::filesystem::create_directories(captureDir, ec);
+	std::filesystem::path captureFile = captureDir / (nodeName + SCENE_FILE_EXT);
+	ensureNonExistingFile(captureFile);
+	return captureFile;
+}
+
+bool captureScene(const std::filesystem::path& file, const InitialShapeNOPtrVector& initialShapes,
+                  const std::vector<std::filesystem::path>& rulePackages, bool occlusion,
+                  const std::vector<const wchar_t*>& encoders, const AttributeMapNOPtrVector& encoderOptions,
+                  const prt::AttributeMap* generateOptions) {
+	assert(initialShapes.size() == rulePackages.size());
+	assert(encoders.size() == encoderOptions.size());
+
+	std::ofstream out(file, std::ofstream::binary);
+	if (!out) {
+		LOG_WRN << "Cannot write scene capture " << file;
+		return false;
+	}
+
+	writeHeader(out, SCENE_MAGIC, SCENE_VERSION);
+	write<uint8_t>(out, occlusion ? 1 : 0);
+
+	write<uint64_t>(out, encoders.size());
+	for (size_t e = 0; e < encoders.size(); e++) {
+		writeString(out, encoders[e]);
+		writeOptionalAttributeMap(out, encoderOptions[e]);
+	}
+	writeOptionalAttributeMap(out, generateOptions);
+
+	write<uint64_t>(out, initialShapes.size());
+	for (size_t isIdx = 0; isIdx < initialShapes.size(); isIdx++)
+		writeShape(out, *initialShapes[isIdx], rulePackages[isIdx]);
+
+	return out.good();
+}
+
+CapturedScene readScene(const std::filesystem::path& file) {
+	Reader reader(file, SCENE_FILE_KIND);
+	reader.readHeader(SCENE_MAGIC, SCENE_VERSION);
+
+	CapturedScene scene;
+	scene.occlusion = (reader.read<uint8_t>() != 0);
+
+	const auto encoderCount = reader.read<uint64_t>();
+	for (uint64_t e = 0; e < encoderCount; e++) {
+		std::wstring id = reader.readString();
+		scene.encoders.push_back({std::move(id), readOptionalAttributeMap(reader)});
+	}
+	scene.generateOptions = readOptionalAttributeMap(reader);
+
+	const auto shapeCount = reader.read<uint64_t>();
+	for (uint64_t s = 0; s < shapeCount; s++)
+		scene.shapes.emplace_back(readShape(reader));
+
+	if (!reader.atEnd())
+		reader.fail("trailing data in");
+	return scene;
+}
+
+InitialShapeUPtr createInitialShape(const CapturedShape& shape, const prt::ResolveMap* resolveMap) {
+	const InitialShapeBuilderUPtr isb(prt::InitialShapeBuilder::create());
+
+	prt::Status status = isb->setGeometry(shape.vertices.data(), shape.vertices.size(), shape.indices.data(),
+	                                      shape.indices.size(), shape.faceCounts.data(), shape.faceCounts.size(),
+	                                      shape.holes.data(), shape.holes.size());
+	for (size_t u = 0; u < shape.uvSets.size() && status == prt::STATUS_OK; u++) {
+		const auto& uvSet = shape.uvSets[u];
+		if (!uvSet.uvs.empty()) {
+			status = isb->setUVs(uvSet.uvs.data(), uvSet.uvs.size(), uvSet.indices.data(), uvSet.indices.size(),
+			                     uvSet.faceCounts.data(), uvSet.faceCounts.size(), static_cast<uint32_t>(u));
+		}
+	}
+	if (status == prt::STATUS_OK) {
+		status = isb->setAttributes(shape.ruleFile.c_str(), shape.startRule.c_str(), shape.randomSeed,
+		                            shape.name.c_str(), shape.attributes.get(), resolveMap);
+	}
+
+	InitialShapeUPtr is;
+	if (status == prt::STATUS_OK)
+		is.reset(isb->createInitialShapeAndReset(&status));
+	if (status != prt::STATUS_OK || !is)
+		throw std::runtime_error("failed to create initial shape " + toOSNarrowFromUTF16(shape.name) + ": " +
+		                         prt::getStatusDescription(status));
+	return is;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "PalladioMain.h"
+#include "Utils.h"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/**
+ * a fully built initial shape as passed to prt::generate, independent of houdini
+ */
+struct CapturedShape {
+	struct UVSet {
+		std::vector<double> uvs;
+		std::vector<uint32_t> indices;
+		std::vector<uint32_t> faceCounts;
+	};
+
+	std::vector<double> vertices;
+	std::vector<uint32_t> indices;
+	std::vector<uint32_t> faceCounts;
+	std::vector<uint32_t> holes;
+	std::vector<UVSet> uvSets;
+
+	std::filesystem::path rulePackage;
+	std::wstring ruleFile;
+	std::wstring startRule;
+	std::wstring name;
+	int32_t randomSeed = 0;
+	AttributeMapUPtr attributes; // must outlive the initial shape
+};
+
+struct CapturedEncoder {
+	std::wstring id;
+	AttributeMapUPtr options;
+};
+
+/**
+ * self-contained input of a cook: the initial shapes and the generate setup of the node. it reruns the same
+ * prt::generate workload without houdini, e.g. to investigate performance on production data.
+ */
+struct CapturedScene {
+	bool occlusion = false; // the generate node runs an occlusion pass before generation
+	std::vector<CapturedEncoder> encoders;
+	AttributeMapUPtr generateOptions; // can be null
+	std::vector<CapturedShape> shapes;
+};
+
+/**
+ * returns the capture file for the node if the CITYENGINE_CAPTURE_SCENE_DIR environment variable is set
+ */
+std::filesystem::path getSceneCaptureFile(const std::string& nodeName);
+
+/**
+ * writes the initial shapes (created from the rule package with the same index) and the generate setup into file,
+ * returns false if the file cannot be written
+ */
+PLD_TEST_EXPORTS_API bool captureScene(const std::filesystem::path& file, const InitialShapeNOPtrVector& initialShapes,
+                                       const std::vector<std::filesystem::path>& rulePackages, bool occlusion,
+                                       const std::vector<const wchar_t*>& encoders,
+                                       const AttributeMapNOPtrVector& encoderOptions,
+                                       const prt::AttributeMap* generateOptions);
+
+/**
+ * throws std::runtime_error if the file cannot be read or is not a valid scene capture
+ */
+PLD_TEST_EXPORTS_API CapturedScene readScene(const std::filesystem::path& file);
+
+/**
+ * recreates the initial shape with the resolve map of its rule package, throws std::runtime_error on failure
+ */
+PLD_TEST_EXPORTS_API InitialShapeUPtr createInitialShape(const CapturedShape& shape, const prt::ResolveMap* resolveMap);
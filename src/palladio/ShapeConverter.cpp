@@ -17,9 +17,9 @@
 #include "ShapeConverter.h"
 #include "HoleConverter.h"
 #include "LogHandler.h"
-#include "MultiWatch.h"
 #include "PrimitiveClassifier.h"
 #include "ShapeData.h"
+#include "Tracing.h"
 #include "Utils.h"
 
 #include "GA/GA_PageHandle.h"
@@ -263,7 +263,7 @@ struct MainAttributeHandles {
 
 void ShapeConverter::get(const GU_Detail* detail, const PrimitiveClassifier& primCls, ShapeData& shapeData,
                          const PRTContextUPtr& prtCtx) {
-	WA("all");
+	PLD_TRACE_SCOPE("conversion");
 
 	// -- partition primitives into initial shapes by primitive classifier values
 	PrimitivePartition primPart(detail, primCls);
@@ -337,7 +337,7 @@ void ShapeConverter::get(const GU_Detail* detail, const PrimitiveClassifier& pri
 }
 
 void ShapeConverter::put(GU_Detail* detail, PrimitiveClassifier& primCls, const ShapeData& shapeData) const {
-	WA("all");
+	PLD_TRACE_SCOPE("detail write");
 
 	primCls.setupAttributeHandles(detail);
 
@@ -38,7 +38,13 @@ const UT_String PLD_START_RULE = "pldStartRule";
 const UT_String PLD_STYLE = "pldStyle";
 const UT_String PLD_RANDOM_SEED = "pldRandomSeed";
 
+const UT_String PLD_GENERATE_TIME = "pldGenerateTime";
+const UT_String PLD_LEAF_SHAPES = "pldLeafShapes";
+const UT_String PLD_FACES = "pldFaces";
+const UT_String PLD_VERTICES = "pldVertices";
+
 enum class GroupCreation { NONE, PRIMCLS };
+enum class ShapeStatistics { NONE, GENERATED, INITIAL_SHAPES };
 
 struct MainAttributes {
 	std::filesystem::path mRPK;
@@ -15,6 +15,7 @@
  */
 
 #include "ShapeData.h"
+#include "Sharding.h"
 
 namespace {
 
@@ -60,6 +61,7 @@ void ShapeData::addBuilder(InitialShapeBuilderUPtr&& isb, int32_t randomSeed, co
 	mInitialShapeBuilders.emplace_back(std::move(isb));
 	mRandomSeeds.push_back(randomSeed);
 	mPrimitiveMapping.emplace_back(primMappings);
+	mClassifierValues.emplace_back(clsVal);
 
 	if (mGroupCreation == GroupCreation::PRIMCLS) {
 		std::wstring name;
@@ -69,8 +71,11 @@ void ShapeData::addBuilder(InitialShapeBuilderUPtr&& isb, int32_t randomSeed, co
 	}
 }
 
-void ShapeData::addShape(const prt::InitialShape* is, AttributeMapBuilderUPtr&& amb, AttributeMapUPtr&& ruleAttr) {
+void ShapeData::addShape(size_t isbIdx, const prt::InitialShape* is, AttributeMapBuilderUPtr&& amb,
+                         AttributeMapUPtr&& ruleAttr, const std::filesystem::path& rulePackage) {
 	mInitialShapes.emplace_back(is);
+	mBuilderIndices.emplace_back(isbIdx);
+	mRulePackages.emplace_back(rulePackage);
 	mRuleAttributeBuilders.emplace_back(std::move(amb));
 	mRuleAttributes.emplace_back(std::move(ruleAttr));
 }
@@ -84,6 +89,16 @@ const std::wstring& ShapeData::getInitialShapeName(size_t isIdx) const {
 		return mInitialShapeNames[isIdx];
 }
 
+uint64_t ShapeData::getShardKey(size_t isIdx) const {
+	const auto& clsVal = mClassifierValues[mBuilderIndices[isIdx]];
+	if (const int32* i = std::get_if<int32>(&clsVal)) {
+		if (*i == PrimitivePartition::INVALID_CLS_VALUE)
+			return Sharding::getKey(mInitialShapes[isIdx]);
+		return Sharding::getKey(*i);
+	}
+	return Sharding::getKey(std::get<UT_String>(clsVal).toStdString());
+}
+
 bool ShapeData::isValid() const {
 	const size_t numISB = mInitialShapeBuilders.size();
 	const size_t numIS = mInitialShapes.size();
@@ -91,13 +106,17 @@ bool ShapeData::isValid() const {
 
 	const size_t numAMB = mRuleAttributeBuilders.size();
 	const size_t numAM = mRuleAttributes.size();
+	const size_t numRP = mRulePackages.size();
+	const size_t numBI = mBuilderIndices.size();
 
 	const size_t numPM = mPrimitiveMapping.size();
+	const size_t numCV = mClassifierValues.size();
 
-	if (numPM == 0 || numISB != numPM || (numISB != numISN && numISN > 0) || (numISB == 0 && numISN > 0))
+	if (numPM == 0 || numISB != numPM || numCV != numPM || (numISB != numISN && numISN > 0) ||
+	    (numISB == 0 && numISN > 0))
 		return false;
 
-	if (numIS != numAMB || numIS != numAM) // they are allowed to be all 0
+	if (numIS != numAMB || numIS != numAM || numIS != numRP || numIS != numBI) // they are allowed to be all 0
 		return false;
 
 	return true;
@@ -35,7 +35,8 @@ public:
 	void addBuilder(InitialShapeBuilderUPtr&& isb, int32_t randomSeed, const PrimitiveNOPtrVector& primMappings,
 	                const PrimitivePartition::ClassifierValueType& clsVal);
 
-	void addShape(const prt::InitialShape* is, AttributeMapBuilderUPtr&& amb, AttributeMapUPtr&& ruleAttr);
+	void addShape(size_t isbIdx, const prt::InitialShape* is, AttributeMapBuilderUPtr&& amb,
+	              AttributeMapUPtr&& ruleAttr, const std::filesystem::path& rulePackage);
 
 	InitialShapeBuilderVector& getInitialShapeBuilders() {
 		return mInitialShapeBuilders;
@@ -49,6 +50,10 @@ public:
 	const PrimitiveNOPtrVector& getPrimitiveMapping(size_t isIdx) const {
 		return mPrimitiveMapping[isIdx];
 	}
+	// the primitives of an initial shape (getPrimitiveMapping is indexed by initial shape builder)
+	const PrimitiveNOPtrVector& getInitialShapePrimitives(size_t isIdx) const {
+		return mPrimitiveMapping[mBuilderIndices[isIdx]];
+	}
 
 	AttributeMapBuilderVector& getRuleAttributeMapBuilders() {
 		return mRuleAttributeBuilders;
@@ -61,14 +66,23 @@ public:
 	const InitialShapeNOPtrVector& getInitialShapes() const {
 		return mInitialShapes;
 	}
+	const std::vector<std::filesystem::path>& getRulePackages() const {
+		return mRulePackages; // per initial shape
+	}
+
+	// stable key of the initial shape for sharding: from the classifier value, else from the geometry
+	uint64_t getShardKey(size_t isIdx) const;
 
 	bool isValid() const;
 
 private:
 	std::vector<PrimitiveNOPtrVector> mPrimitiveMapping;
+	std::vector<PrimitivePartition::ClassifierValueType> mClassifierValues;
 
 	InitialShapeBuilderVector mInitialShapeBuilders;
 	InitialShapeNOPtrVector mInitialShapes;
+	std::vector<std::filesystem::path> mRulePackages;
+	std::vector<size_t> mBuilderIndices; // per initial shape, builders without initial shape are skipped
 
 	AttributeMapBuilderVector mRuleAttributeBuilders;
 	AttributeMapVector mRuleAttributes;
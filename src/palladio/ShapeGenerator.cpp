@@ -17,9 +17,9 @@
 #include "ShapeGenerator.h"
 #include "AttributeConversion.h"
 #include "LogHandler.h"
-#include "MultiWatch.h"
 #include "PrimitiveClassifier.h"
 #include "ShapeData.h"
+#include "Tracing.h"
 
 #include "GEO/GEO_Primitive.h"
 #include "GA/GA_Primitive.h"
@@ -34,18 +34,19 @@ constexpr bool DBG = true;
 const std::set<UT_StringHolder> ATTRIBUTE_BLACKLIST = {PLD_PRIM_CLS_NAME, PLD_RPK,   PLD_RULE_FILE,
                                                        PLD_START_RULE,    PLD_STYLE, PLD_RANDOM_SEED};
 
-std::wstring getFullyQualifiedStartRule(const MainAttributes& ma) {
-	if (ma.mStartRule.find(L'$') != std::wstring::npos)
-		return ma.mStartRule;
+std::wstring getFullyQualifiedStartRule(const MainAttributes& ma, const std::wstring& startRuleOverride) {
+	const std::wstring& startRule = startRuleOverride.empty() ? ma.mStartRule : startRuleOverride;
+	if (startRule.find(L'$') != std::wstring::npos)
+		return startRule;
 	else
-		return ma.mStyle + L'$' + ma.mStartRule;
+		return ma.mStyle + L'$' + startRule;
 }
 
 } // namespace
 
 void ShapeGenerator::get(const GU_Detail* detail, const PrimitiveClassifier& primCls, ShapeData& shapeData,
                          const PRTContextUPtr& prtCtx) {
-	WA("all");
+	PLD_TRACE_SCOPE("initial shapes");
 
 	// extract initial shape geometry
 	ShapeConverter::get(detail, primCls, shapeData, prtCtx);
@@ -116,7 +117,7 @@ void ShapeGenerator::get(const GU_Detail* detail, const PrimitiveClassifier& pri
 		auto& isb = shapeData.getInitialShapeBuilder(isIdx);
 		const int32_t randomSeed = shapeData.getInitialShapeRandomSeed(isIdx);
 		const auto& shapeName = shapeData.getInitialShapeName(isIdx);
-		const auto fqStartRule = getFullyQualifiedStartRule(ma);
+		const auto fqStartRule = getFullyQualifiedStartRule(ma, mStartRuleOverride);
 
 		auto cgb = getCGB(assetsMap); // key -> uri
 		if (!cgb)
@@ -132,7 +133,9 @@ void ShapeGenerator::get(const GU_Detail* detail, const PrimitiveClassifier& pri
 		if (status == prt::STATUS_OK && initialShape != nullptr) {
 			if constexpr (DBG)
 				LOG_DBG << objectToXML(initialShape);
-			shapeData.addShape(initialShape, std::move(amb), std::move(ruleAttr));
+			shapeData.addShape(isIdx, initialShape, std::move(amb), std::move(ruleAttr), ma.mRPK);
+			if (mInitialShapeReceiver)
+				mInitialShapeReceiver(initialShape);
 		}
 		else
 			LOG_WRN << "failed to create initial shape " << shapeName << ": " << prt::getStatusDescription(status);
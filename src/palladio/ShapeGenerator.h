@@ -20,9 +20,19 @@
 #include "ShapeConverter.h"
 #include "Utils.h"
 
+#include <functional>
+
 class GU_Detail;
 
 struct ShapeGenerator final : ShapeConverter {
 	void get(const GU_Detail* detail, const PrimitiveClassifier& primCls, ShapeData& shapeData,
 	         const PRTContextUPtr& prtCtx) override;
+
+	// optional, receives each initial shape as soon as it is created (in the order of shapeData), e.g. to overlap
+	// the occlusion pass with the creation of the remaining initial shapes
+	std::function<void(const prt::InitialShape*)> mInitialShapeReceiver;
+
+	// optional, replaces the start rule of all initial shapes (e.g. a lightweight preview rule), without style the
+	// style of the initial shape is used
+	std::wstring mStartRuleOverride;
 };
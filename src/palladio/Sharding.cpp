@@ -0,0 +1,230 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Sharding.h"
+
+#include "prt/InitialShape.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+
+namespace {
+
+// FNV-1a, the bytes are fed in little endian order to get the same keys on all platforms
+constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+// distinguishes the key types, e.g. the string "1" from the int 1
+constexpr uint8_t KEY_TYPE_STRING = 1;
+constexpr uint8_t KEY_TYPE_INT = 2;
+constexpr uint8_t KEY_TYPE_GEOMETRY = 3;
+
+constexpr int X = 0;
+constexpr int Z = 2;
+
+constexpr size_t MAX_CELLS_PER_SHAPE = 256; // larger shapes are candidates of every query instead
+
+class KeyBuilder {
+public:
+	explicit KeyBuilder(uint8_t keyType) {
+		addByte(keyType);
+	}
+
+	void addByte(uint8_t b) {
+		mKey = (mKey ^ b) * FNV_PRIME;
+	}
+
+	void add(uint64_t v) {
+		for (int i = 0; i < 8; i++)
+			addByte(static_cast<uint8_t>(v >> (i * 8)));
+	}
+
+	void add(double v) {
+		if (v == 0.0)
+			v = 0.0; // negative zero
+		uint64_t bits;
+		std::memcpy(&bits, &v, sizeof(bits));
+		add(bits);
+	}
+
+	template <typename T>
+	void add(const T* values, size_t count) {
+		add(static_cast<uint64_t>(count));
+		for (size_t i = 0; i < count; i++)
+			add(static_cast<std::conditional_t<std::is_floating_point_v<T>, double, uint64_t>>(values[i]));
+	}
+
+	uint64_t get() const {
+		return mKey;
+	}
+
+private:
+	uint64_t mKey = FNV_OFFSET_BASIS;
+};
+
+// splitmix64 finalizer, spreads similar keys (e.g. consecutive int classifier values) over all shards
+uint64_t mix(uint64_t key) {
+	key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ull;
+	key = (key ^ (key >> 27)) * 0x94d049bb133111ebull;
+	return key ^ (key >> 31);
+}
+
+bool overlaps(const Sharding::Bounds& a, const Sharding::Bounds& b, double distance) {
+	for (int axis : {X, Z}) {
+		if (a.min[axis] - distance > b.max[axis] || b.min[axis] - distance > a.max[axis])
+			return false;
+	}
+	return true;
+}
+
+bool isEmpty(const Sharding::Bounds& b) {
+	return b.min[X] > b.max[X];
+}
+
+} // namespace
+
+namespace Sharding {
+
+GridIndex::GridIndex(const std::vector<Bounds>& bounds, const std::vector<size_t>& shapes, double minCellSize) {
+	double extentSum = 0.0;
+	size_t shapeCount = 0;
+	for (size_t i : shapes) {
+		const Bounds& b = bounds[i];
+		if (isEmpty(b))
+			continue;
+		extentSum += std::max(b.max[X] - b.min[X], b.max[Z] - b.min[Z]);
+		shapeCount++;
+	}
+	if (shapeCount == 0)
+		return;
+
+	// cells of about the typical shape size keep the candidates per query small
+	mCellSize = std::max({minCellSize, extentSum / shapeCount, 1e-6});
+	for (size_t i : shapes) {
+		const Bounds& b = bounds[i];
+		if (isEmpty(b))
+			continue;
+		const int64_t x0 = getCell(b.min[X]), x1 = getCell(b.max[X]);
+		const int64_t z0 = getCell(b.min[Z]), z1 = getCell(b.max[Z]);
+		if (static_cast<double>(x1 - x0 + 1) * static_cast<double>(z1 - z0 + 1) > MAX_CELLS_PER_SHAPE) {
+			mLargeShapes.push_back(i);
+			continue;
+		}
+		for (int64_t x = x0; x <= x1; x++) {
+			for (int64_t z = z0; z <= z1; z++)
+				mCells[getCellKey(x, z)].push_back(i);
+		}
+	}
+}
+
+int64_t GridIndex::getCell(double v) const {
+	const double cell = std::floor(v / mCellSize);
+	constexpr double limit = static_cast<double>(std::numeric_limits<int32_t>::max());
+	return static_cast<int64_t>(std::clamp(cell, -limit, limit)); // e.g. infinite regions
+}
+
+uint64_t GridIndex::getCellKey(int64_t x, int64_t z) {
+	return (static_cast<uint64_t>(x) << 32) ^ static_cast<uint32_t>(z); // colliding cells only cost time
+}
+
+uint64_t getKey(const std::string& classifierValue) {
+	KeyBuilder kb(KEY_TYPE_STRING);
+	for (char c : classifierValue)
+		kb.addByte(static_cast<uint8_t>(c));
+	return kb.get();
+}
+
+uint64_t getKey(int32_t classifierValue) {
+	KeyBuilder kb(KEY_TYPE_INT);
+	kb.add(static_cast<uint64_t>(static_cast<uint32_t>(classifierValue)));
+	return kb.get();
+}
+
+uint64_t getKey(const prt::InitialShape* initialShape) {
+	KeyBuilder kb(KEY_TYPE_GEOMETRY);
+	kb.add(initialShape->getVertices(), initialShape->getVertexCount());
+	kb.add(initialShape->getIndices(), initialShape->getIndexCount());
+	kb.add(initialShape->getFaceCounts(), initialShape->getFaceCountsCount());
+	return kb.get();
+}
+
+size_t getShard(uint64_t key, size_t shardCount) {
+	return (shardCount > 1) ? static_cast<size_t>(mix(key) % shardCount) : 0;
+}
+
+Bounds getBounds(const prt::InitialShape* initialShape) {
+	constexpr double inf = std::numeric_limits<double>::infinity();
+	Bounds b{{inf, inf, inf}, {-inf, -inf, -inf}};
+	const double* vtx = initialShape->getVertices();
+	for (size_t i = 0; i + 2 < initialShape->getVertexCount(); i += 3) {
+		for (int axis = 0; axis < 3; axis++) {
+			b.min[axis] = std::min(b.min[axis], vtx[i + axis]);
+			b.max[axis] = std::max(b.max[axis], vtx[i + axis]);
+		}
+	}
+	return b;
+}
+
+std::vector<size_t> getNeighbours(const std::vector<Bounds>& bounds, const std::vector<bool>& inShard,
+                                  double distance) {
+	std::vector<size_t> shardShapes;
+	for (size_t i = 0; i < bounds.size(); i++) {
+		if (inShard[i] && !isEmpty(bounds[i]))
+			shardShapes.push_back(i);
+	}
+	if (shardShapes.empty())
+		return {};
+
+	// cells of at least the distance keep the cells per query few
+	const GridIndex grid(bounds, shardShapes, distance);
+
+	std::vector<size_t> neighbours;
+	for (size_t i = 0; i < bounds.size(); i++) {
+		if (inShard[i] || isEmpty(bounds[i]))
+			continue;
+		const bool close = !grid.forEachCandidate(bounds[i], distance,
+		                                          [&](size_t s) { return !overlaps(bounds[i], bounds[s], distance); });
+		if (close)
+			neighbours.push_back(i);
+	}
+	return neighbours;
+}
+
+Split split(const InitialShapeNOPtrVector& initialShapes, const std::vector<uint64_t>& keys,
+            const Selection& selection) {
+	Split split;
+	std::vector<bool> inShard(initialShapes.size());
+	for (size_t i = 0; i < initialShapes.size(); i++) {
+		inShard[i] = (getShard(keys[i], selection.count) == selection.index);
+		if (inShard[i])
+			split.shapes.push_back(i);
+	}
+
+	if (selection.neighbourOccluders && !split.shapes.empty() && split.shapes.size() < initialShapes.size()) {
+		std::vector<Bounds> bounds;
+		bounds.reserve(initialShapes.size());
+		std::transform(initialShapes.begin(), initialShapes.end(), std::back_inserter(bounds), getBounds);
+		split.occluders = getNeighbours(bounds, inShard, selection.neighbourDistance);
+	}
+
+	return split;
+}
+
+} // namespace Sharding
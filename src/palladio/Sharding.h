@@ -0,0 +1,129 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Utils.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * assignment of initial shapes to shards for distributed generation. the keys only depend on the classifier value or
+ * the geometry of an initial shape, so every machine computes the same shards regardless of input order or threads.
+ */
+namespace Sharding {
+
+struct Bounds {
+	std::array<double, 3> min;
+	std::array<double, 3> max;
+};
+
+struct Selection {
+	size_t index = 0;
+	size_t count = 1; // a single shard contains all initial shapes
+	bool neighbourOccluders = false;
+	double neighbourDistance = 0.0;
+};
+
+struct Split {
+	std::vector<size_t> shapes;    // the initial shapes to generate
+	std::vector<size_t> occluders; // the neighbours of other shards, only used in the occlusion pass
+};
+
+/**
+ * grid of shape bounds on the ground plane (x and z) with cells of about the typical shape size, used to find the
+ * shapes close to a region without testing all of them
+ */
+class PLD_TEST_EXPORTS_API GridIndex {
+public:
+	// indexes the given shapes of bounds, empty bounds are skipped
+	GridIndex(const std::vector<Bounds>& bounds, const std::vector<size_t>& shapes, double minCellSize = 0.0);
+
+	/**
+	 * calls f with every shape which might be closer than distance to the region, possibly more than once.
+	 * f returns false to stop the iteration, which is then also returned.
+	 */
+	template <typename F>
+	bool forEachCandidate(const Bounds& region, double distance, F f) const {
+		if (region.min[0] > region.max[0])
+			return true;
+
+		for (size_t i : mLargeShapes) {
+			if (!f(i))
+				return false;
+		}
+
+		// a region larger than the indexed area is faster tested against all cells
+		const int64_t x0 = getCell(region.min[0] - distance), x1 = getCell(region.max[0] + distance);
+		const int64_t z0 = getCell(region.min[2] - distance), z1 = getCell(region.max[2] + distance);
+		if (static_cast<double>(x1 - x0 + 1) * static_cast<double>(z1 - z0 + 1) > static_cast<double>(mCells.size())) {
+			for (const auto& cell : mCells) {
+				for (size_t i : cell.second) {
+					if (!f(i))
+						return false;
+				}
+			}
+			return true;
+		}
+		for (int64_t x = x0; x <= x1; x++) {
+			for (int64_t z = z0; z <= z1; z++) {
+				const auto it = mCells.find(getCellKey(x, z));
+				if (it == mCells.end())
+					continue;
+				for (size_t i : it->second) {
+					if (!f(i))
+						return false;
+				}
+			}
+		}
+		return true;
+	}
+
+private:
+	int64_t getCell(double v) const;
+	static uint64_t getCellKey(int64_t x, int64_t z);
+
+	double mCellSize = 1.0;
+	std::unordered_map<uint64_t, std::vector<size_t>> mCells;
+	std::vector<size_t> mLargeShapes; // too many cells, candidates of every query
+};
+
+PLD_TEST_EXPORTS_API uint64_t getKey(const std::string& classifierValue);
+PLD_TEST_EXPORTS_API uint64_t getKey(int32_t classifierValue);
+PLD_TEST_EXPORTS_API uint64_t getKey(const prt::InitialShape* initialShape); // from the geometry
+
+PLD_TEST_EXPORTS_API size_t getShard(uint64_t key, size_t shardCount);
+
+PLD_TEST_EXPORTS_API Bounds getBounds(const prt::InitialShape* initialShape);
+
+/**
+ * returns the indices of all shapes outside of the shard whose bounds are closer than distance to a shape of the shard
+ * (on the ground plane, i.e. x and z), in increasing order
+ */
+PLD_TEST_EXPORTS_API std::vector<size_t> getNeighbours(const std::vector<Bounds>& bounds,
+                                                       const std::vector<bool>& inShard, double distance);
+
+/**
+ * selects the initial shapes of the shard by their keys, the indices of the split are in increasing order
+ */
+PLD_TEST_EXPORTS_API Split split(const InitialShapeNOPtrVector& initialShapes, const std::vector<uint64_t>& keys,
+                                 const Selection& selection);
+
+} // namespace Sharding
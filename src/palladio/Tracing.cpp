@@ -0,0 +1,239 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Tracing.h"
+#include "LogHandler.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+constexpr const char* TRACE_DIR_ENV_VAR = "CITYENGINE_TRACE_DIR";
+constexpr size_t RING_BUFFER_CAPACITY = 1 << 16; // per thread, the oldest events are overwritten
+constexpr const char* TRACE_FILE_EXT = ".json";
+
+using tracing::Clock;
+
+struct Event {
+	const char* name;
+	const char* context;
+	Clock::time_point begin;
+	Clock::time_point end;
+};
+
+/**
+ * only the owning thread records into its buffer, i.e. the mutex is contended only while a cook exports the events
+ */
+struct ThreadBuffer {
+	explicit ThreadBuffer(uint32_t id) : mThreadId(id), mEvents(RING_BUFFER_CAPACITY) {}
+
+	const uint32_t mThreadId;
+	std::mutex mMutex;
+	std::vector<Event> mEvents;
+	uint64_t mCount = 0; // total number of recorded events
+	std::atomic<bool> mRetired = false;
+};
+
+using ThreadBufferSPtr = std::shared_ptr<ThreadBuffer>;
+
+/**
+ * the buffers outlive their threads (e.g. the generate threads end before the cook is exported)
+ */
+class Registry {
+public:
+	ThreadBufferSPtr add() {
+		std::lock_guard<std::mutex> lock(mMutex);
+		mBuffers.push_back(std::make_shared<ThreadBuffer>(mNextThreadId++));
+		return mBuffers.back();
+	}
+
+	std::vector<ThreadBufferSPtr> get() const {
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mBuffers;
+	}
+
+	void removeRetired() {
+		std::lock_guard<std::mutex> lock(mMutex);
+		mBuffers.erase(std::remove_if(mBuffers.begin(), mBuffers.end(),
+		                              [](const ThreadBufferSPtr& b) { return b->mRetired.load(); }),
+		               mBuffers.end());
+	}
+
+private:
+	mutable std::mutex mMutex;
+	std::vector<ThreadBufferSPtr> mBuffers;
+	uint32_t mNextThreadId = 0;
+};
+
+Registry& getRegistry() {
+	static Registry registry;
+	return registry;
+}
+
+struct ThreadBufferHolder {
+	ThreadBufferSPtr mBuffer;
+	~ThreadBufferHolder() {
+		if (mBuffer)
+			mBuffer->mRetired = true;
+	}
+};
+
+ThreadBuffer& getThreadBuffer() {
+	thread_local ThreadBufferHolder holder;
+	if (!holder.mBuffer)
+		holder.mBuffer = getRegistry().add();
+	return *holder.mBuffer;
+}
+
+struct Settings {
+	Settings() {
+		const char* e = std::getenv(TRACE_DIR_ENV_VAR);
+		if (e != nullptr && std::strlen(e) > 0) {
+			mTraceDir = e;
+			mEnabled = true;
+		}
+	}
+
+	std::mutex mMutex;
+	std::filesystem::path mTraceDir;
+	std::atomic<bool> mEnabled = false;
+};
+
+Settings& getSettings() {
+	static Settings settings;
+	return settings;
+}
+
+std::filesystem::path getTraceDirectory() {
+	Settings& settings = getSettings();
+	std::lock_guard<std::mutex> lock(settings.mMutex);
+	return settings.mTraceDir;
+}
+
+void writeEscaped(std::ostream& out, const std::string& s) {
+	out << '"';
+	for (const char c : s) {
+		if (c == '"' || c == '\\')
+			out << '\\' << c;
+		else if (static_cast<unsigned char>(c) >= 0x20)
+			out << c;
+	}
+	out << '"';
+}
+
+double toMicroseconds(Clock::duration d) {
+	return std::chrono::duration<double, std::micro>(d).count();
+}
+
+} // namespace
+
+namespace tracing {
+
+void setTraceDirectory(const std::filesystem::path& dir) {
+	Settings& settings = getSettings();
+	std::lock_guard<std::mutex> lock(settings.mMutex);
+	settings.mTraceDir = dir;
+	settings.mEnabled = !dir.empty();
+}
+
+bool isEnabled() {
+	return getSettings().mEnabled.load(std::memory_order_relaxed);
+}
+
+void record(const char* name, const char* context, Clock::time_point begin, Clock::time_point end) {
+	ThreadBuffer& buffer = getThreadBuffer();
+	std::lock_guard<std::mutex> lock(buffer.mMutex);
+	buffer.mEvents[buffer.mCount % RING_BUFFER_CAPACITY] = {name, context, begin, end};
+	buffer.mCount++;
+}
+
+CookTrace::CookTrace(const std::string& name) : mName(name), mBegin(Clock::now()), mEnabled(isEnabled()) {}
+
+CookTrace::~CookTrace() {
+	if (mEnabled)
+		write();
+}
+
+void CookTrace::write() const {
+	const std::filesystem::path traceDir = getTraceDirectory();
+	if (traceDir.empty())
+		return;
+
+	std::error_code ec;
+	std::filesystem::create_directories(traceDir, ec);
+	std::filesystem::path traceFile = traceDir / (mName + TRACE_FILE_EXT);
+	ensureNonExistingFile(traceFile);
+
+	std::ofstream out(traceFile, std::ofstream::binary);
+	if (!out) {
+		LOG_WRN << "Cannot write trace file " << traceFile;
+		return;
+	}
+
+	out << std::fixed << std::setprecision(3); // timestamps and durations are in microseconds
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":";
+	writeEscaped(out, mName);
+	out << "}}";
+
+	size_t eventCount = 0;
+	bool overflow = false;
+	for (const ThreadBufferSPtr& buffer : getRegistry().get()) {
+		std::lock_guard<std::mutex> lock(buffer->mMutex);
+		const uint64_t first = (buffer->mCount > RING_BUFFER_CAPACITY) ? buffer->mCount - RING_BUFFER_CAPACITY : 0;
+		if (first > 0 && buffer->mEvents[first % RING_BUFFER_CAPACITY].begin > mBegin)
+			overflow = true;
+
+		bool hasEvents = false;
+		for (uint64_t i = first; i < buffer->mCount; i++) {
+			const Event& e = buffer->mEvents[i % RING_BUFFER_CAPACITY];
+			if (e.begin < mBegin)
+				continue;
+			out << ",\n{\"name\":";
+			writeEscaped(out, e.name);
+			out << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->mThreadId;
+			out << ",\"ts\":" << toMicroseconds(e.begin - mBegin) << ",\"dur\":" << toMicroseconds(e.end - e.begin);
+			out << ",\"args\":{\"function\":";
+			writeEscaped(out, e.context);
+			out << "}}";
+			hasEvents = true;
+			eventCount++;
+		}
+
+		if (hasEvents) {
+			out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer->mThreadId
+			    << ",\"args\":{\"name\":\"thread " << buffer->mThreadId << "\"}}";
+		}
+	}
+	out << "]}\n";
+
+	getRegistry().removeRetired();
+
+	if (overflow)
+		LOG_WRN << "Trace buffer overflow, the oldest events of " << mName << " are missing";
+	LOG_INF << "Wrote " << eventCount << " trace events to " << traceFile;
+}
+
+} // namespace tracing
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "PalladioMain.h"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+#define PLD_TRACE_CONCAT_IMPL(a, b) a##b
+#define PLD_TRACE_CONCAT(a, b) PLD_TRACE_CONCAT_IMPL(a, b)
+
+// records the enclosing scope, name must be a string literal (or have static storage duration)
+#define PLD_TRACE_SCOPE(name) const tracing::Scope PLD_TRACE_CONCAT(traceScope_, __LINE__)(name, __func__)
+
+// collects all scopes recorded during the enclosing cook and writes them to the trace directory
+#define PLD_TRACE_COOK(name) const tracing::CookTrace PLD_TRACE_CONCAT(cookTrace_, __LINE__)(name)
+
+/**
+ * low overhead tracing of the cook stages, disabled by default. each thread records its scopes into its own ring
+ * buffer, the cooks export the recorded scopes as Chrome trace JSON (viewable in chrome://tracing or Perfetto).
+ */
+namespace tracing {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * enables tracing and sets the directory for the trace files, an empty path disables tracing.
+ * the initial value is taken from the CITYENGINE_TRACE_DIR environment variable.
+ */
+PLD_TEST_EXPORTS_API void setTraceDirectory(const std::filesystem::path& dir);
+
+PLD_TEST_EXPORTS_API bool isEnabled();
+
+PLD_TEST_EXPORTS_API void record(const char* name, const char* context, Clock::time_point begin, Clock::time_point end);
+
+class Scope {
+public:
+	Scope(const char* name, const char* context) : mName(name), mContext(context) {
+		if (isEnabled())
+			mBegin = Clock::now();
+	}
+	Scope(const Scope&) = delete;
+	Scope& operator=(const Scope&) = delete;
+	~Scope() {
+		if (mBegin != Clock::time_point())
+			record(mName, mContext, mBegin, Clock::now());
+	}
+
+private:
+	const char* const mName;
+	const char* const mContext;
+	Clock::time_point mBegin;
+};
+
+class PLD_TEST_EXPORTS_API CookTrace {
+public:
+	explicit CookTrace(const std::string& name);
+	CookTrace(const CookTrace&) = delete;
+	CookTrace& operator=(const CookTrace&) = delete;
+	~CookTrace();
+
+private:
+	/**
+	 * writes the scopes recorded by all threads since construction into a new file in the trace directory
+	 */
+	void write() const;
+
+	const std::string mName;
+	const Clock::time_point mBegin;
+	const bool mEnabled;
+};
+
+} // namespace tracing
@@ -292,6 +292,11 @@ std::wstring toFileURI(const std::filesystem::path& p) {
 	return toFileURI(p.generic_string());
 }
 
+std::wstring toMemoryURI(const void* data, size_t size, const std::wstring& extension) {
+	const prtx::URIPtr uri = prtx::URIUtils::createMemoryURI(static_cast<const uint8_t*>(data), size, extension);
+	return uri->wstring();
+}
+
 std::wstring percentEncode(const std::string& utf8String) {
 	return toUTF16FromUTF8(callAPI<char, char>(prt::StringUtils::percentEncode, utf8String));
 }
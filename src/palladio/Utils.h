@@ -43,6 +43,7 @@ struct PRTDestroyer {
 };
 
 using ObjectUPtr = std::unique_ptr<const prt::Object, PRTDestroyer>;
+using InitialShapeUPtr = std::unique_ptr<const prt::InitialShape, PRTDestroyer>;
 using InitialShapeNOPtrVector = std::vector<const prt::InitialShape*>;
 using AttributeMapNOPtrVector = std::vector<const prt::AttributeMap*>;
 using CacheObjectUPtr = std::unique_ptr<prt::CacheObject, PRTDestroyer>;
@@ -79,6 +80,8 @@ std::string toUTF8FromUTF16(const std::wstring& utf16String);
 
 PLD_TEST_EXPORTS_API std::wstring toFileURI(const std::filesystem::path& p);
 std::wstring toFileURI(const std::string& p);
+// PRT reads memory URIs directly from the buffer, i.e. the buffer must outlive all users of the URI
+PLD_TEST_EXPORTS_API std::wstring toMemoryURI(const void* data, size_t size, const std::wstring& extension);
 PLD_TEST_EXPORTS_API std::wstring percentEncode(const std::string& utf8String);
 PLD_TEST_EXPORTS_API bool isRulePackageUri(const char* uri);
 PLD_TEST_EXPORTS_API std::string getBaseUriPath(const char* uri);
@@ -0,0 +1,172 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "WorkerGenerate.h"
+#include "CallbackRecording.h"
+#include "LogHandler.h"
+#include "SceneCapture.h"
+
+#include "prt/API.h"
+
+#include <algorithm>
+#include <future>
+
+#ifdef PLD_LINUX
+#	include <cerrno>
+#	include <spawn.h>
+#	include <sys/wait.h>
+#	include <unistd.h>
+extern char** environ;
+#elif defined(PLD_WINDOWS)
+#	include <process.h>
+#endif
+
+namespace {
+
+constexpr const char* WORKER_EXECUTABLE = "palladio_worker";
+constexpr const char* WORKER_TMP_PREFIX = "cityengine_for_houdini_worker_";
+
+// exit codes of the worker, see worker.cpp
+constexpr int WORKER_OK = 0;
+constexpr int WORKER_GENERATE_FAILED = 3; // the recording is valid but contains failed initial shapes
+constexpr int WORKER_NOT_STARTED = -1;
+
+std::filesystem::path getSharedMemoryDir() {
+#ifdef PLD_LINUX
+	const std::filesystem::path shm = "/dev/shm"; // the tmpfs backing POSIX shared memory, the files never hit disk
+	std::error_code ec;
+	if (std::filesystem::is_directory(shm, ec))
+		return shm;
+#endif
+	return std::filesystem::temp_directory_path();
+}
+
+// runs the worker to completion, returns its exit code or WORKER_NOT_STARTED if it could not run or crashed
+int runWorker(const std::filesystem::path& workerExecutable, const std::filesystem::path& sceneFile,
+              const std::filesystem::path& resultFile) {
+#ifdef PLD_LINUX
+	std::string exe = workerExecutable.string();
+	std::string scene = sceneFile.string();
+	std::string result = resultFile.string();
+	char* argv[] = {exe.data(), scene.data(), result.data(), nullptr};
+
+	pid_t pid = 0;
+	if (posix_spawn(&pid, exe.c_str(), nullptr, nullptr, argv, environ) != 0)
+		return WORKER_NOT_STARTED;
+
+	int status = 0;
+	while (waitpid(pid, &status, 0) == -1) {
+		if (errno != EINTR)
+			return WORKER_NOT_STARTED;
+	}
+	return WIFEXITED(status) ? WEXITSTATUS(status) : WORKER_NOT_STARTED;
+#elif defined(PLD_WINDOWS)
+	// the spawn functions join the arguments into one command line, paths with spaces need quotes
+	auto quote = [](const std::filesystem::path& p) { return L"\"" + p.wstring() + L"\""; };
+	const std::wstring exe = workerExecutable.wstring();
+	const std::wstring exeArg = quote(workerExecutable);
+	const std::wstring scene = quote(sceneFile);
+	const std::wstring result = quote(resultFile);
+	const wchar_t* argv[] = {exeArg.c_str(), scene.c_str(), result.c_str(), nullptr};
+	const intptr_t exitCode = _wspawnv(_P_WAIT, exe.c_str(), argv);
+	return (exitCode < 0) ? WORKER_NOT_STARTED : static_cast<int>(exitCode);
+#else
+	return WORKER_NOT_STARTED;
+#endif
+}
+
+} // namespace
+
+std::filesystem::path getWorkerExecutable() {
+	std::filesystem::path prtCorePath;
+	getLibraryPath(prtCorePath, reinterpret_cast<const void*>(prt::init));
+	std::filesystem::path worker = prtCorePath.parent_path() / WORKER_EXECUTABLE;
+#ifdef PLD_WINDOWS
+	worker.replace_extension(".exe");
+#endif
+	std::error_code ec;
+	return std::filesystem::is_regular_file(worker, ec) ? worker : std::filesystem::path();
+}
+
+size_t generateInWorkers(const std::filesystem::path& workerExecutable, const std::string& name,
+                         const InitialShapeNOPtrVector& initialShapes,
+                         const std::vector<std::filesystem::path>& rulePackages,
+                         const std::vector<const wchar_t*>& encoders, const AttributeMapNOPtrVector& encoderOptions,
+                         uint32_t threadsPerWorker, const std::vector<HoudiniCallbacks*>& sinks,
+                         std::vector<prt::Status>& statuses) {
+	const InitialShapeNOPtrVector& is = initialShapes;
+	const size_t nWorkers = sinks.size();
+	const size_t isRangeSize = is.size() / nWorkers; // the last worker takes the remainder
+
+	AttributeMapBuilderUPtr amb(prt::AttributeMapBuilder::create());
+	amb->setInt(L"numberWorkerThreads", static_cast<int32_t>(std::max<uint32_t>(threadsPerWorker, 1)));
+	const AttributeMapUPtr generateOptions(amb->createAttributeMap());
+
+	const std::filesystem::path filePrefix =
+	        getSharedMemoryDir() / (WORKER_TMP_PREFIX + std::to_string(::getpid()) + "_" + name + "_");
+
+	std::vector<std::future<bool>> futures;
+	futures.reserve(nWorkers);
+	for (size_t wi = 0; wi < nWorkers; wi++) {
+		futures.emplace_back(std::async(std::launch::async, [&, wi] {
+			const size_t isStartPos = wi * isRangeSize;
+			const size_t isPastEndPos = (wi < nWorkers - 1) ? (wi + 1) * isRangeSize : is.size();
+
+			std::filesystem::path sceneFile = filePrefix.string() + std::to_string(wi) + ".pldscene";
+			std::filesystem::path resultFile = filePrefix.string() + std::to_string(wi) + ".pldrec";
+			ensureNonExistingFile(sceneFile);
+			ensureNonExistingFile(resultFile);
+
+			const InitialShapeNOPtrVector workerShapes(is.begin() + isStartPos, is.begin() + isPastEndPos);
+			const std::vector<std::filesystem::path> workerRulePackages(rulePackages.begin() + isStartPos,
+			                                                            rulePackages.begin() + isPastEndPos);
+			int exitCode = WORKER_NOT_STARTED;
+			if (captureScene(sceneFile, workerShapes, workerRulePackages, true, encoders, encoderOptions,
+			                 generateOptions.get()))
+				exitCode = runWorker(workerExecutable, sceneFile, resultFile);
+
+			bool replayed = false;
+			if (exitCode == WORKER_OK || exitCode == WORKER_GENERATE_FAILED) {
+				try {
+					replayCallbacks(resultFile, *sinks[wi]);
+					replayed = true;
+				}
+				catch (const std::exception& e) {
+					LOG_ERR << "cannot read the result of worker " << wi << ": " << e.what();
+				}
+			}
+			else
+				LOG_ERR << "worker " << wi << " for initial shapes " << isStartPos << " to " << isPastEndPos
+				        << " failed with exit code " << exitCode;
+
+			if (!replayed)
+				std::fill(statuses.begin() + isStartPos, statuses.begin() + isPastEndPos,
+				          prt::STATUS_UNSPECIFIED_ERROR);
+
+			std::error_code ec;
+			std::filesystem::remove(sceneFile, ec);
+			std::filesystem::remove(resultFile, ec);
+			return replayed;
+		}));
+	}
+
+	size_t failedWorkers = 0;
+	for (auto& f : futures) {
+		if (!f.get())
+			failedWorkers++;
+	}
+	return failedWorkers;
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Utils.h"
+#include "encoder/HoudiniCallbacks.h"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/**
+ * the worker executable next to the PRT core library (i.e. in the palladio package), empty if it does not exist
+ */
+PLD_TEST_EXPORTS_API std::filesystem::path getWorkerExecutable();
+
+/**
+ * generates the initial shapes in one worker process per sink. each worker generates one contiguous range of the
+ * initial shapes with its own PRT instance and occlusion set, so occlusion queries only see the shapes of the same
+ * worker. the worker streams its callbacks into a recording in shared memory, which is replayed into the sink of the
+ * range as soon as the worker exits. the statuses of the ranges of crashed workers are set to an error.
+ * returns the number of failed workers.
+ */
+PLD_TEST_EXPORTS_API size_t generateInWorkers(const std::filesystem::path& workerExecutable, const std::string& name,
+                                              const InitialShapeNOPtrVector& initialShapes,
+                                              const std::vector<std::filesystem::path>& rulePackages,
+                                              const std::vector<const wchar_t*>& encoders,
+                                              const AttributeMapNOPtrVector& encoderOptions, uint32_t threadsPerWorker,
+                                              const std::vector<HoudiniCallbacks*>& sinks,
+                                              std::vector<prt::Status>& statuses);
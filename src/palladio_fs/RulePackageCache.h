@@ -0,0 +1,58 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "../palladio/LRUCache.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+
+/**
+ * values derived from rule packages (e.g. resolved entries), keyed by URI and modification time of the rule package,
+ * i.e. the values of a changed RPK are created again. free of HDK types, the modification time is passed in.
+ */
+template <typename T>
+class RulePackageCache {
+public:
+	using ValueSPtr = std::shared_ptr<const T>;
+	using ModificationTime = std::function<int64_t(const char* source)>;
+
+	RulePackageCache(size_t capacity, ModificationTime getModificationTime)
+	    : mGetModificationTime(std::move(getModificationTime)), mValues(capacity) {}
+
+	/**
+	 * returns the cached value of the key or the one returned by create, which is only cached if not empty
+	 */
+	template <typename F>
+	ValueSPtr get(const std::string& key, const char* source, F create) {
+		const auto cacheKey = std::make_pair(key, mGetModificationTime(source));
+		if (const std::optional<ValueSPtr> value = mValues.get(cacheKey))
+			return *value;
+
+		ValueSPtr value = create();
+		if (value)
+			mValues.insert(cacheKey, value);
+		return value;
+	}
+
+private:
+	const ModificationTime mGetModificationTime;
+	LockedLRUCache<std::pair<std::string, int64_t>, ValueSPtr> mValues;
+};
@@ -18,16 +18,20 @@
 
 #include "palladio/Utils.h"
 
+#include "prt/API.h"
 #include "prtx/DataBackend.h" // !!! use of PRTX requires palladio_fs to be built with the same compiler as PRT
 
 #include "FS/FS_ReaderStream.h"
 
 #include <cassert>
+#include <cstring>
 #include <iostream>
 #include <map>
 
 namespace {
 
+constexpr size_t INDEX_CACHE_CAPACITY = 16;
+
 prtx::BinaryVectorPtr resolveRulePackageFile(const char* source, prt::Cache* cache) {
 	assert(source != nullptr);
 	const std::wstring uri = toUTF16FromOSNarrow(source);
@@ -50,7 +54,7 @@ pld_time_t getFileModificationTime(const char* path) {
 	std::string actualPath(path);
 	if (isRulePackageUri(path))
 		actualPath = getBaseUriPath(path);
-	if (actualPath.empty())
+	if (actualPath.empty()) // e.g. rpk:memory: packages embedded in a HDA, their URI changes with their content
 		return {};
 	FS_Info info(actualPath.c_str());
 	return info.getModTime();
@@ -58,23 +62,44 @@ pld_time_t getFileModificationTime(const char* path) {
 
 } // namespace
 
-RulePackageReader::RulePackageReader(prt::Cache* cache) : mCache(cache) {
+RulePackageEntryCache::RulePackageEntryCache(prt::Cache* cache, size_t capacity)
+    : mCache(cache), mEntries(capacity, getFileModificationTime),
+      mIndices(INDEX_CACHE_CAPACITY, getFileModificationTime) {}
+
+RulePackageEntryCache::EntrySPtr RulePackageEntryCache::get(const char* source) {
+	return mEntries.get(source, source, [this, source]() -> EntrySPtr {
+		const prtx::BinaryVectorPtr buf = resolveRulePackageFile(source, mCache);
+		if (!buf)
+			return {};
+		return std::make_shared<const UT_WorkBuffer>(reinterpret_cast<const char*>(buf->data()), buf->size());
+	});
+}
+
+RulePackageEntryCache::IndexSPtr RulePackageEntryCache::getIndex(const char* source) {
+	const std::string packageURI = splitRulePackageUri(source).first;
+	if (packageURI.empty())
+		return {};
+
+	return mIndices.get(packageURI, source,
+	                    [&packageURI]() { return std::make_shared<const RulePackageIndex>(packageURI); });
+}
+
+RulePackageReader::RulePackageReader(RulePackageEntryCache* entryCache) : mEntryCache(entryCache) {
 	UTaddAbsolutePathPrefix(SCHEMA_RPK);
 }
 
 FS_ReaderStream* RulePackageReader::createStream(const char* source, const UT_Options*) {
 	if (isRulePackageUri(source)) {
-		const prtx::BinaryVectorPtr buf = resolveRulePackageFile(source, mCache);
-		if (!buf)
+		const RulePackageEntryCache::EntrySPtr entry = mEntryCache->get(source);
+		if (!entry)
 			return nullptr;
-		UT_WorkBuffer buffer((const char*)buf->data(), buf->size());
 		pld_time_t modTime = getFileModificationTime(source);
-		return new FS_ReaderStream(buffer, modTime); // freed by Houdini
+		return new FS_ReaderStream(*entry, modTime); // freed by Houdini
 	}
 	return nullptr;
 }
 
-RulePackageInfoHelper::RulePackageInfoHelper(prt::Cache* cache) : mCache(cache) {}
+RulePackageInfoHelper::RulePackageInfoHelper(RulePackageEntryCache* entryCache) : mEntryCache(entryCache) {}
 
 bool RulePackageInfoHelper::canHandle(const char* source) {
 	return isRulePackageUri(source);
@@ -82,15 +107,25 @@ bool RulePackageInfoHelper::canHandle(const char* source) {
 
 bool RulePackageInfoHelper::hasAccess(const char* source, int mode) {
 	std::string src(source);
-	if (isRulePackageUri(source))
+	if (isRulePackageUri(source)) {
+		// answer existence checks of package entries from the index instead of resolving the entry
+		const RulePackageEntryCache::IndexSPtr index = mEntryCache->getIndex(source);
+		const std::string path = splitRulePackageUri(source).second;
+		if (index && !index->isFile(path) && !index->isDirectory(path))
+			return false;
 		src = getBaseUriPath(source);
+		if (src.empty()) // in-memory package, there is no file to check
+			return static_cast<bool>(index);
+	}
 	FS_Info info(src.c_str());
 	return info.hasAccess(mode);
 }
 
 bool RulePackageInfoHelper::getIsDirectory(const char* source) {
-	if (isRulePackageUri(source))
-		return false;
+	if (isRulePackageUri(source)) {
+		const RulePackageEntryCache::IndexSPtr index = mEntryCache->getIndex(source);
+		return index && index->isDirectory(splitRulePackageUri(source).second);
+	}
 	FS_Info info(source);
 	return info.getIsDirectory();
 }
@@ -101,8 +136,8 @@ pld_time_t RulePackageInfoHelper::getModTime(const char* source) {
 
 int64 RulePackageInfoHelper::getSize(const char* source) {
 	if (isRulePackageUri(source)) {
-		const prtx::BinaryVectorPtr buf = resolveRulePackageFile(source, mCache);
-		return buf->size();
+		const RulePackageEntryCache::EntrySPtr entry = mEntryCache->get(source);
+		return entry ? entry->length() : 0;
 	}
 	FS_Info info(source);
 	return info.getFileDataSize();
@@ -118,8 +153,17 @@ UT_String RulePackageInfoHelper::getExtension(const char* source) {
 }
 
 bool RulePackageInfoHelper::getContents(const char* source, UT_StringArray& contents, UT_StringArray* dirs) {
-	if (isRulePackageUri(source))
-		return false; // we only support individual texture files atm
+	if (isRulePackageUri(source)) {
+		const RulePackageEntryCache::IndexSPtr index = mEntryCache->getIndex(source);
+		std::vector<std::string> files, directories;
+		if (!index || !index->getContents(splitRulePackageUri(source).second, files, directories))
+			return false;
+		for (const std::string& f : files)
+			contents.append(f);
+		for (const std::string& d : directories)
+			(dirs != nullptr ? *dirs : contents).append(d);
+		return true;
+	}
 	FS_Info info(source);
 	return info.getContents(contents, dirs);
 }
@@ -16,38 +16,65 @@
 
 #pragma once
 
+#include "RulePackageCache.h"
+#include "RulePackageIndex.h"
+
 #include "FS/FS_Info.h"
 #include "FS/FS_Reader.h"
+#include "UT/UT_StringArray.h"
+#include "UT/UT_WorkBuffer.h"
 
 #include "prt/Cache.h"
 
 #include <ctime>
+#include <memory>
+#include <string>
 
 /**
  * support for nested file RPK URIs:
  * rpk:file:/path/to/file.rpk!/nested/file.cgb
  */
 
+#if (HOUDINI_VERSION_MAJOR >= 20 || (HOUDINI_VERSION_MAJOR == 19 && HOUDINI_VERSION_MINOR == 5))
+using pld_time_t = std::time_t;
+#else
+using pld_time_t = int;
+#endif
+
+/**
+ * resolved (i.e. decompressed) rule package entries and package indices, shared between reader and info helper.
+ * both are keyed by URI and modification time of the rule package, i.e. a changed RPK is resolved again.
+ */
+class RulePackageEntryCache {
+public:
+	using EntrySPtr = std::shared_ptr<const UT_WorkBuffer>;
+	using IndexSPtr = std::shared_ptr<const RulePackageIndex>;
+
+	RulePackageEntryCache(prt::Cache* cache, size_t capacity);
+
+	EntrySPtr get(const char* source);
+	IndexSPtr getIndex(const char* source);
+
+private:
+	prt::Cache* mCache;
+	RulePackageCache<UT_WorkBuffer> mEntries;
+	RulePackageCache<RulePackageIndex> mIndices;
+};
+
 class RulePackageReader : public FS_ReaderHelper {
 public:
-	explicit RulePackageReader(prt::Cache* cache);
+	explicit RulePackageReader(RulePackageEntryCache* entryCache);
 	~RulePackageReader() override = default;
 
 	FS_ReaderStream* createStream(const char* source, const UT_Options* options) override;
 
 private:
-	prt::Cache* mCache;
+	RulePackageEntryCache* mEntryCache;
 };
 
-#if (HOUDINI_VERSION_MAJOR >= 20 || (HOUDINI_VERSION_MAJOR == 19 && HOUDINI_VERSION_MINOR == 5))
-using pld_time_t = std::time_t;
-#else
-using pld_time_t = int;
-#endif
-
 class RulePackageInfoHelper : public FS_InfoHelper {
 public:
-	explicit RulePackageInfoHelper(prt::Cache* cache);
+	explicit RulePackageInfoHelper(RulePackageEntryCache* entryCache);
 	~RulePackageInfoHelper() override = default;
 
 	bool canHandle(const char* source) override;
@@ -59,5 +86,5 @@ public:
 	bool getContents(const char* source, UT_StringArray& contents, UT_StringArray* dirs) override;
 
 private:
-	prt::Cache* mCache;
+	RulePackageEntryCache* mEntryCache;
 };
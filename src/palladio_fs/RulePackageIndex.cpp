@@ -0,0 +1,97 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "RulePackageIndex.h"
+
+#include "../palladio/Utils.h"
+
+#include <cstring>
+
+namespace {
+
+std::string getParentPath(const std::string& path) {
+	const size_t sep = path.rfind('/');
+	return (sep == std::string::npos) ? std::string() : path.substr(0, sep);
+}
+
+std::string getName(const std::string& path) {
+	const size_t sep = path.rfind('/');
+	return (sep == std::string::npos) ? path : path.substr(sep + 1);
+}
+
+} // namespace
+
+std::pair<std::string, std::string> splitRulePackageUri(const char* source) {
+	if (std::strncmp(source, SCHEMA_RPK, std::strlen(SCHEMA_RPK)) != 0)
+		return {};
+	const char* sep = std::strchr(source, '!');
+	if (sep == nullptr)
+		return {};
+
+	std::string packageURI(source + std::strlen(SCHEMA_RPK), sep);
+	std::string path(sep + 1);
+	const size_t first = path.find_first_not_of('/');
+	const size_t last = path.find_last_not_of('/');
+	path = (first == std::string::npos) ? std::string() : path.substr(first, last - first + 1);
+	return {packageURI, path};
+}
+
+RulePackageIndex::RulePackageIndex(const std::string& packageURI) {
+	// the resolve map lists all entries of the package, PRT only reads the archive header for it
+	prt::Status status = prt::STATUS_UNSPECIFIED_ERROR;
+	const ResolveMapUPtr resolveMap(prt::createResolveMap(toUTF16FromOSNarrow(packageURI).c_str(), nullptr, &status));
+	if (!resolveMap || status != prt::STATUS_OK)
+		return;
+
+	mDirectories.emplace();
+	size_t keyCount = 0;
+	const wchar_t* const* keys = resolveMap->getKeys(&keyCount);
+	for (size_t ki = 0; ki < keyCount; ki++) {
+		const wchar_t* uri = resolveMap->getString(keys[ki]);
+		if (uri == nullptr)
+			continue;
+		const std::string path = splitRulePackageUri(toOSNarrowFromUTF16(uri).c_str()).second;
+		if (path.empty())
+			continue;
+		mFiles.emplace(path);
+		for (std::string dir = getParentPath(path); !dir.empty(); dir = getParentPath(dir))
+			mDirectories.emplace(dir);
+	}
+}
+
+bool RulePackageIndex::isFile(const std::string& path) const {
+	return mFiles.count(path) > 0;
+}
+
+bool RulePackageIndex::isDirectory(const std::string& path) const {
+	return mDirectories.count(path) > 0;
+}
+
+bool RulePackageIndex::getContents(const std::string& dir, std::vector<std::string>& files,
+                                   std::vector<std::string>& dirs) const {
+	if (!isDirectory(dir))
+		return false;
+
+	for (const std::string& f : mFiles) {
+		if (getParentPath(f) == dir)
+			files.push_back(getName(f));
+	}
+	for (const std::string& d : mDirectories) {
+		if (!d.empty() && getParentPath(d) == dir)
+			dirs.push_back(getName(d));
+	}
+	return true;
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * splits rpk:file:/path/to/file.rpk!/nested/file.cgb into "file:/path/to/file.rpk" and "nested/file.cgb"
+ */
+std::pair<std::string, std::string> splitRulePackageUri(const char* source);
+
+/**
+ * the files and directories of a rule package as listed in its archive header (read once, nothing is extracted).
+ * paths are relative to the package root and percent-encoded like in the rpk: URIs.
+ */
+class RulePackageIndex {
+public:
+	explicit RulePackageIndex(const std::string& packageURI);
+
+	bool isFile(const std::string& path) const;
+	bool isDirectory(const std::string& path) const;
+
+	// appends the names of the files and directories directly inside dir
+	bool getContents(const std::string& dir, std::vector<std::string>& files, std::vector<std::string>& dirs) const;
+
+private:
+	std::set<std::string> mFiles;
+	std::set<std::string> mDirectories; // includes the root ""
+};
@@ -26,8 +26,11 @@
 
 namespace {
 
+constexpr size_t ENTRY_CACHE_CAPACITY = 64; // number of resolved rule package entries (e.g. textures) kept in memory
+
 CacheObjectUPtr prtCache; // TODO: prevent from growing too much
 
+std::unique_ptr<RulePackageEntryCache> rpkEntryCache;
 std::unique_ptr<RulePackageReader> rpkReader;
 std::unique_ptr<RulePackageInfoHelper> rpkInfoHelper;
 
@@ -36,8 +39,9 @@ std::unique_ptr<RulePackageInfoHelper> rpkInfoHelper;
 void installFSHelpers() {
 	prtCache.reset(prt::CacheObject::create(prt::CacheObject::CACHE_TYPE_NONREDUNDANT));
 
-	rpkReader = std::make_unique<RulePackageReader>(prtCache.get());
-	rpkInfoHelper = std::make_unique<RulePackageInfoHelper>(prtCache.get());
+	rpkEntryCache = std::make_unique<RulePackageEntryCache>(prtCache.get(), ENTRY_CACHE_CAPACITY);
+	rpkReader = std::make_unique<RulePackageReader>(rpkEntryCache.get());
+	rpkInfoHelper = std::make_unique<RulePackageInfoHelper>(rpkEntryCache.get());
 
 	std::clog << "CityEngine for Houdini: Registered custom FS reader for Rule Packages.\n";
 }
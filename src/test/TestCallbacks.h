@@ -55,6 +55,7 @@ class TestCallbacks : public HoudiniCallbacks {
 public:
 	std::vector<std::unique_ptr<CallbackResult>> results;
 	std::map<int32_t, AttributeMapBuilderUPtr> attrs;
+	std::vector<std::pair<size_t, prt::Status>> generateErrors;
 
 	void add(const wchar_t* name, const double* vtx, size_t vtxSize, const double* nrm, size_t nrmSize,
 	         const uint32_t* counts, size_t countsSize, const uint32_t* holeCounts, size_t holeCountsSize,
@@ -84,7 +85,7 @@ public:
 
 		cr.faceRanges.assign(faceRanges, faceRanges + faceRangesSize);
 
-		for (size_t mi = 0; mi < faceRangesSize - 1; mi++) {
+		for (size_t mi = 0; materials != nullptr && mi < faceRangesSize - 1; mi++) {
 			AttributeMapBuilderUPtr amb(prt::AttributeMapBuilder::createFromAttributeMap(materials[mi]));
 			cr.materials.emplace_back(amb->createAttributeMap());
 		}
@@ -98,6 +99,7 @@ public:
 	}
 
 	prt::Status generateError(size_t isIndex, prt::Status status, const wchar_t* message) override {
+		generateErrors.emplace_back(isIndex, status);
 		return prt::STATUS_OK;
 	}
 
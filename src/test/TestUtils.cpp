@@ -18,7 +18,7 @@
 
 #include "prt/API.h"
 
-#include "catch2/catch.hpp"
+#include <stdexcept>
 
 namespace {
 
@@ -27,18 +27,33 @@ constexpr const wchar_t* ENCODER_ID_CGA_PRINT = L"com.esri.prt.core.CGAPrintEnco
 constexpr const wchar_t* FILE_CGA_ERROR = L"CGAErrors.txt";
 constexpr const wchar_t* FILE_CGA_PRINT = L"CGAPrint.txt";
 
+// throws instead of REQUIRE to be usable by the benchmarks, catch reports the exception as test failure
+void require(bool condition, const char* what) {
+	if (!condition)
+		throw std::runtime_error(std::string("generate failed: ") + what);
+}
+
 } // namespace
 
-void generate(TestCallbacks& tc, const PRTContextUPtr& prtCtx, const std::filesystem::path& rpkPath,
+void generate(HoudiniCallbacks& callbacks, const PRTContextUPtr& prtCtx, const std::filesystem::path& rpkPath,
               const std::wstring& ruleFile, const std::vector<std::wstring>& initialShapeURIs,
               const std::vector<std::wstring>& startRules, bool triangulateFacesWithHoles) {
-	REQUIRE(initialShapeURIs.size() == startRules.size());
+	require(initialShapeURIs.size() == startRules.size(), "initial shape count");
+
+	auto setup = [&initialShapeURIs](size_t isIdx, prt::InitialShapeBuilder& isb, prt::AttributeMapBuilder&) {
+		require(isb.resolveGeometry(initialShapeURIs[isIdx].c_str()) == prt::STATUS_OK, "resolve geometry");
+	};
+	generate(callbacks, prtCtx, rpkPath, ruleFile, startRules, setup, triangulateFacesWithHoles);
+}
 
+void generate(HoudiniCallbacks& callbacks, const PRTContextUPtr& prtCtx, const std::filesystem::path& rpkPath,
+              const std::wstring& ruleFile, const std::vector<std::wstring>& startRules,
+              const InitialShapeSetup& setup, bool triangulateFacesWithHoles) {
 	ResolveMapSPtr rpkRM = prtCtx->getResolveMap(rpkPath);
-	REQUIRE(rpkRM);
+	require(rpkRM != nullptr, "resolve map");
 
 	auto cgb = getCGB(rpkRM); // key -> uri
-	REQUIRE(cgb);
+	require(cgb.has_value(), "rule file");
 
 	AttributeMapBuilderUPtr amb(prt::AttributeMapBuilder::create());
 	const RuleFileInfoUPtr ruleFileInfo(prt::createRuleFileInfo(cgb->second.c_str(), prtCtx->mPRTCache.get()));
@@ -64,8 +79,7 @@ void generate(TestCallbacks& tc, const PRTContextUPtr& prtCtx, const std::filesy
 	const AttributeMapUPtr isAttrsProto(amb->createAttributeMapAndReset());
 
 	GenerateData gd;
-	for (size_t i = 0; i < initialShapeURIs.size(); i++) {
-		const std::wstring& uri = initialShapeURIs[i];
+	for (size_t i = 0; i < startRules.size(); i++) {
 		const std::wstring& sr = startRules[i];
 
 		gd.mInitialShapeBuilders.emplace_back(prt::InitialShapeBuilder::create());
@@ -74,18 +88,19 @@ void generate(TestCallbacks& tc, const PRTContextUPtr& prtCtx, const std::filesy
 		gd.mRuleAttributeBuilders.emplace_back(
 		        prt::AttributeMapBuilder::createFromAttributeMap(isAttrsProto.get())); // TODO: use shared_ptr
 		const auto& rab = gd.mRuleAttributeBuilders.back();
+		setup(i, *isb, *rab);
 		gd.mRuleAttributes.emplace_back(rab->createAttributeMap());
 		const auto& am = gd.mRuleAttributes.back();
 
 		const std::wstring sn = L"shape" + std::to_wstring(i);
 
-		REQUIRE(isb->resolveGeometry(uri.c_str()) == prt::STATUS_OK);
-		REQUIRE(isb->setAttributes(ruleFile.c_str(), sr.c_str(), 0, sn.c_str(), am.get(), rpkRM.get()) ==
-		        prt::STATUS_OK);
+		require(isb->setAttributes(ruleFile.c_str(), sr.c_str(), 0, sn.c_str(), am.get(), rpkRM.get()) ==
+		                prt::STATUS_OK,
+		        "set attributes");
 
 		prt::Status status = prt::STATUS_UNSPECIFIED_ERROR;
 		const prt::InitialShape* is = isb->createInitialShapeAndReset(&status);
-		REQUIRE(status == prt::STATUS_OK);
+		require(status == prt::STATUS_OK, "create initial shape");
 		gd.mInitialShapes.emplace_back(is);
 	}
 
@@ -112,7 +127,18 @@ void generate(TestCallbacks& tc, const PRTContextUPtr& prtCtx, const std::filesy
 	                                                   cgaPrintOptions.get()};
 
 	prt::Status stat = prt::generate(gd.mInitialShapes.data(), gd.mInitialShapes.size(), nullptr, allEncoders.data(),
-	                                 allEncoders.size(), allEncoderOptions.data(), &tc, prtCtx->mPRTCache.get(),
-	                                 nullptr, generateOptions.get());
-	REQUIRE(stat == prt::STATUS_OK);
+	                                 allEncoders.size(), allEncoderOptions.data(), &callbacks,
+	                                 prtCtx->mPRTCache.get(), nullptr, generateOptions.get());
+	require(stat == prt::STATUS_OK, "generate");
+}
+
+CapturedShape createLot(double x, double z, const std::wstring& name, double width, double depth) {
+	CapturedShape shape;
+	shape.vertices = {x, 0, z, x + width, 0, z, x + width, 0, z + depth, x, 0, z + depth};
+	shape.indices = {0, 1, 2, 3};
+	shape.faceCounts = {4};
+	shape.ruleFile = L"bin/r1.cgb";
+	shape.startRule = L"Default$Init";
+	shape.name = name;
+	return shape;
 }
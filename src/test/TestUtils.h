@@ -19,11 +19,13 @@
 #include "TestCallbacks.h"
 
 #include "PRTContext.h"
+#include "SceneCapture.h"
 #include "Utils.h"
 
 #include <algorithm>
 #include <cassert>
 #include <filesystem>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -42,6 +44,25 @@ struct GenerateData { // TODO: could use ShapeData from production code
 	}
 };
 
-void generate(TestCallbacks& tc, const PRTContextUPtr& prtCtx, const std::filesystem::path& rpkPath,
+void generate(HoudiniCallbacks& callbacks, const PRTContextUPtr& prtCtx, const std::filesystem::path& rpkPath,
               const std::wstring& ruleFile, const std::vector<std::wstring>& initialShapeURIs,
               const std::vector<std::wstring>& startRules, bool triangulateFacesWithHoles = true);
+
+/**
+ * sets the geometry of the initial shape with the given index, additional initial shape attributes are optional
+ */
+using InitialShapeSetup =
+        std::function<void(size_t isIdx, prt::InitialShapeBuilder& isb, prt::AttributeMapBuilder& isAttrs)>;
+
+/**
+ * generates one initial shape per start rule, throws std::runtime_error on failure
+ */
+void generate(HoudiniCallbacks& callbacks, const PRTContextUPtr& prtCtx, const std::filesystem::path& rpkPath,
+              const std::wstring& ruleFile, const std::vector<std::wstring>& startRules,
+              const InitialShapeSetup& setup, bool triangulateFacesWithHoles = true);
+
+/**
+ * a width x depth rectangle on the ground plane with its first corner at (x, 0, z), to be generated with the start
+ * rule Default$Init of bin/r1.cgb in GenAttrs1.rpk
+ */
+CapturedShape createLot(double x, double z, const std::wstring& name = L"lot", double width = 1.0, double depth = 1.0);
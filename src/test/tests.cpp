@@ -17,11 +17,26 @@
 #include "TestCallbacks.h"
 #include "TestUtils.h"
 
+#include "CallbackRecording.h"
+#include "CookReport.h"
+#include "Deduplication.h"
+#include "DetailWriter.h"
+#include "GeometryStatistics.h"
 #include "HoleConverter.h"
+#include "OcclusionPipeline.h"
 #include "PRTContext.h"
+#include "Preview.h"
+#include "RPKDiskCache.h"
+#include "RegionOfInterest.h"
+#include "SceneCapture.h"
+#include "Sharding.h"
+#include "Tracing.h"
 #include "Utils.h"
 #include "encoder/HoudiniEncoder.h"
 
+#include "../palladio_fs/RulePackageCache.h"
+#include "../palladio_fs/RulePackageIndex.h"
+
 #include "prt/AttributeMap.h"
 #include "prtx/Geometry.h"
 #include "prtx/Mesh.h"
@@ -31,7 +46,13 @@
 
 #include <algorithm>
 #include <filesystem>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <numeric>
+#include <thread>
 
 namespace {
 
@@ -45,6 +66,31 @@ void compareReversed(const std::vector<T>& a, const std::vector<T>& b) {
 		CHECK(a[i] == b[num - i - 1]);
 }
 
+// counts the generated geometry per initial shape like ModelConverter
+class StatisticsCallbacks : public TestCallbacks {
+public:
+	GeometryStatisticsCounter<GeometryStatistics> counter;
+
+	void beginInitialShape(size_t isIndex) override {
+		counter.beginInitialShape(isIndex);
+	}
+
+	void add(const wchar_t* name, const double* vtx, size_t vtxSize, const double* nrm, size_t nrmSize,
+	         const uint32_t* counts, size_t countsSize, const uint32_t* holeCounts, size_t holeCountsSize,
+	         const uint32_t* holeIndices, size_t holeIndicesSize, const uint32_t* vertexIndices,
+	         size_t vertexIndicesSize, const uint32_t* normalIndices, size_t normalIndicesSize,
+	         double const* const* uvs, size_t const* uvsSizes, uint32_t const* const* uvCounts,
+	         size_t const* uvCountsSizes, uint32_t const* const* uvIndices, size_t const* uvIndicesSizes,
+	         uint32_t uvSets, const uint32_t* faceRanges, size_t faceRangesSize, const prt::AttributeMap** materials,
+	         const prt::AttributeMap** reports, const int32_t* shapeIDs) override {
+		counter.add(faceRangesSize, countsSize, vertexIndicesSize);
+		TestCallbacks::add(name, vtx, vtxSize, nrm, nrmSize, counts, countsSize, holeCounts, holeCountsSize,
+		                   holeIndices, holeIndicesSize, vertexIndices, vertexIndicesSize, normalIndices,
+		                   normalIndicesSize, uvs, uvsSizes, uvCounts, uvCountsSizes, uvIndices, uvIndicesSizes, uvSets,
+		                   faceRanges, faceRangesSize, materials, reports, shapeIDs);
+	}
+};
+
 } // namespace
 
 int main(int argc, char* argv[]) {
@@ -768,6 +814,40 @@ TEST_CASE("generate two cubes with two uv sets") {
 	}
 }
 
+TEST_CASE("shape statistics") {
+	const std::vector<std::wstring> initialShapeURIs = {toFileURI(testDataPath / "quad0.obj"),
+	                                                    toFileURI(testDataPath / "quad1.obj")};
+	const std::vector<std::wstring> startRules = {L"Default$OneSet", L"Default$TwoSets"};
+
+	// both initial shapes are generated in one call, the encoder announces each with beginInitialShape
+	StatisticsCallbacks tc;
+	std::vector<GeometryStatistics> statistics(initialShapeURIs.size());
+	tc.counter.setStatistics(statistics.data());
+	generate(tc, prtCtx, testDataPath / "uvsets.rpk", L"bin/r1.cgb", initialShapeURIs, startRules);
+	REQUIRE(tc.results.size() == 2);
+
+	CHECK(statistics[0].leafShapes == 1);
+	CHECK(statistics[0].faces == 6);
+	CHECK(statistics[0].vertices == 24);
+
+	CHECK(statistics[1].leafShapes == 6); // one leaf shape per face
+	CHECK(statistics[1].faces == 6);
+	CHECK(statistics[1].vertices == 24);
+
+	// without beginInitialShape (e.g. the extruded footprints) the geometry counts towards the given statistics,
+	// several add calls accumulate and geometry without face ranges has no leaf shapes
+	tc.counter.setStatistics(&statistics[0]);
+	CHECK(tc.counter.add(0, 2, 8) == &statistics[0]);
+	CHECK(statistics[0].leafShapes == 1);
+	CHECK(statistics[0].faces == 8);
+	CHECK(statistics[0].vertices == 32);
+
+	tc.counter.setStatistics(nullptr);
+	tc.counter.beginInitialShape(1);
+	CHECK(tc.counter.add(2, 1, 4) == nullptr);
+	CHECK(statistics[1].faces == 6);
+}
+
 TEST_CASE("generate with generic attributes") {
 	const std::vector<std::filesystem::path> initialShapeSources = {testDataPath / "quad0.obj"};
 	const std::vector<std::wstring> initialShapeURIs = {toFileURI(initialShapeSources[0])};
@@ -795,6 +875,399 @@ TEST_CASE("generate with generic attributes") {
 	}
 }
 
+TEST_CASE("record and replay callbacks") {
+	const std::vector<std::filesystem::path> initialShapeSources = {testDataPath / "quad0.obj"};
+	const std::vector<std::wstring> initialShapeURIs = {toFileURI(initialShapeSources[0])};
+	const std::vector<std::wstring> startRules = {L"Default$Init"};
+	const std::filesystem::path rpkPath = testDataPath / "GenAttrs1.rpk";
+	const std::wstring ruleFile = L"bin/r1.cgb";
+	const std::filesystem::path recordingFile = std::filesystem::temp_directory_path() / "pld_test_callbacks.pldrec";
+
+	TestCallbacks recorded;
+	{
+		CallbackRecording recording(recordingFile);
+		REQUIRE(recording.isOpen());
+		CallbackRecorder recorder(recording, recorded);
+		generate(recorder, prtCtx, rpkPath, ruleFile, initialShapeURIs, startRules);
+	}
+
+	TestCallbacks replayed;
+	CHECK(replayCallbacks(recordingFile, replayed) > 0);
+
+	REQUIRE(replayed.results.size() == recorded.results.size());
+	for (size_t i = 0; i < recorded.results.size(); i++) {
+		const CallbackResult& a = *recorded.results[i];
+		const CallbackResult& b = *replayed.results[i];
+		CHECK(a.name == b.name);
+		CHECK(a.vtx == b.vtx);
+		CHECK(a.cnts == b.cnts);
+		CHECK(a.vtxIdx == b.vtxIdx);
+		CHECK(a.uvIndices == b.uvIndices);
+		CHECK(a.faceRanges == b.faceRanges);
+		REQUIRE(a.materials.size() == b.materials.size());
+		REQUIRE(a.attrsPerShapeID.size() == b.attrsPerShapeID.size());
+		for (const auto& [shapeID, attrs] : a.attrsPerShapeID) {
+			const auto& replayedAttrs = b.attrsPerShapeID.at(shapeID);
+			CHECK(std::wcscmp(attrs->getString(L"Default$foo"), replayedAttrs->getString(L"Default$foo")) == 0);
+		}
+	}
+
+	std::filesystem::remove(recordingFile);
+}
+
+TEST_CASE("record and replay generate errors") {
+	const std::filesystem::path recordingFile = std::filesystem::temp_directory_path() / "pld_test_errors.pldrec";
+
+	TestCallbacks recorded;
+	{
+		CallbackRecording recording(recordingFile);
+		REQUIRE(recording.isOpen());
+		CallbackRecorder recorder(recording, recorded);
+		recorder.generateError(3, prt::STATUS_UNSPECIFIED_ERROR, L"cannot resolve rule file");
+	}
+
+	TestCallbacks replayed;
+	CHECK(replayCallbacks(recordingFile, replayed) == 1);
+	CHECK(replayed.generateErrors == recorded.generateErrors);
+	REQUIRE(replayed.generateErrors.size() == 1);
+	CHECK(replayed.generateErrors[0].first == 3);
+	CHECK(replayed.generateErrors[0].second == prt::STATUS_UNSPECIFIED_ERROR);
+
+	std::filesystem::remove(recordingFile);
+}
+
+TEST_CASE("replay callbacks per recorder stream") {
+	const std::filesystem::path recordingFile = std::filesystem::temp_directory_path() / "pld_test_streams.pldrec";
+
+	// two recorders share the recording like the generate threads of a cook and interleave their calls
+	TestCallbacks recorded0;
+	TestCallbacks recorded1;
+	{
+		CallbackRecording recording(recordingFile);
+		REQUIRE(recording.isOpen());
+		CallbackRecorder recorder0(recording, recorded0);
+		CallbackRecorder recorder1(recording, recorded1);
+		CHECK(recorder0.getStream() == 0);
+		CHECK(recorder1.getStream() == 1);
+		recorder0.generateError(0, prt::STATUS_UNSPECIFIED_ERROR, L"first");
+		recorder1.generateError(5, prt::STATUS_FILE_NOT_FOUND, L"second");
+		recorder0.generateError(1, prt::STATUS_OUT_OF_MEM, L"third");
+	}
+
+	std::map<uint32_t, TestCallbacks> replayed;
+	const auto getSink = [&replayed](uint32_t stream) -> HoudiniCallbacks& { return replayed[stream]; };
+	CHECK(replayCallbacks(recordingFile, getSink) == 3);
+	REQUIRE(replayed.size() == 2);
+	CHECK(replayed[0].generateErrors == recorded0.generateErrors);
+	CHECK(replayed[1].generateErrors == recorded1.generateErrors);
+	REQUIRE(replayed[0].generateErrors.size() == 2);
+	CHECK(replayed[0].generateErrors[1].first == 1);
+
+	// a recording of several recorders cannot be replayed into a single sink
+	TestCallbacks single;
+	CHECK_THROWS_AS(replayCallbacks(recordingFile, single), std::runtime_error);
+
+	std::filesystem::remove(recordingFile);
+}
+
+TEST_CASE("capture and read scene") {
+	const std::filesystem::path rpkPath = testDataPath / "GenAttrs1.rpk";
+	const std::filesystem::path sceneFile = std::filesystem::temp_directory_path() / "pld_test_scene.pldscene";
+	const ResolveMapSPtr resolveMap = prtCtx->getResolveMap(rpkPath);
+	REQUIRE(resolveMap);
+
+	// square with a square hole
+	CapturedShape shape;
+	shape.vertices = {0, 0, 0, 10, 0, 0, 10, 0, 10, 0, 0, 10, 2, 0, 2, 8, 0, 2, 8, 0, 8, 2, 0, 8};
+	shape.indices = {0, 1, 2, 3, 7, 6, 5, 4};
+	shape.faceCounts = {4, 4};
+	shape.holes = {0, 1, std::numeric_limits<uint32_t>::max()};
+	shape.uvSets.push_back({{0, 0, 1, 0, 1, 1, 0, 1, 0.2, 0.2, 0.8, 0.2, 0.8, 0.8, 0.2, 0.8}, shape.indices, {4, 4}});
+	shape.rulePackage = rpkPath;
+	shape.ruleFile = L"bin/r1.cgb";
+	shape.startRule = L"Default$Init";
+	shape.name = L"courtyard";
+	shape.randomSeed = 42;
+	AttributeMapBuilderUPtr amb(prt::AttributeMapBuilder::create());
+	amb->setString(L"Default$foo", L"bar");
+	shape.attributes.reset(amb->createAttributeMapAndReset());
+
+	const InitialShapeUPtr is = createInitialShape(shape, resolveMap.get());
+	REQUIRE(captureScene(sceneFile, {is.get()}, {rpkPath}, true, {ENCODER_ID_HOUDINI}, {nullptr}, nullptr));
+
+	const CapturedScene scene = readScene(sceneFile);
+	CHECK(scene.occlusion);
+	REQUIRE(scene.encoders.size() == 1);
+	CHECK(scene.encoders[0].id == ENCODER_ID_HOUDINI);
+	CHECK(!scene.encoders[0].options);
+	CHECK(!scene.generateOptions);
+
+	REQUIRE(scene.shapes.size() == 1);
+	const CapturedShape& captured = scene.shapes[0];
+	CHECK(captured.vertices == shape.vertices);
+	CHECK(captured.indices == shape.indices);
+	CHECK(captured.faceCounts == shape.faceCounts);
+	CHECK(captured.holes == shape.holes);
+	REQUIRE(captured.uvSets.size() == 1);
+	CHECK(captured.uvSets[0].uvs == shape.uvSets[0].uvs);
+	CHECK(captured.uvSets[0].indices == shape.uvSets[0].indices);
+	CHECK(captured.rulePackage == rpkPath);
+	CHECK(captured.ruleFile == shape.ruleFile);
+	CHECK(captured.startRule == shape.startRule);
+	CHECK(captured.name == shape.name);
+	CHECK(captured.randomSeed == shape.randomSeed);
+	CHECK(std::wcscmp(captured.attributes->getString(L"Default$foo"), L"bar") == 0);
+
+	CHECK(createInitialShape(captured, resolveMap.get()));
+	CHECK_THROWS_AS(readScene(testDataPath / "quad0.obj"), std::runtime_error);
+
+	std::filesystem::remove(sceneFile);
+}
+
+TEST_CASE("shard initial shapes") {
+	SECTION("keys") {
+		CHECK(Sharding::getKey(std::string("lot_1")) == Sharding::getKey(std::string("lot_1")));
+		CHECK(Sharding::getKey(std::string("lot_1")) != Sharding::getKey(std::string("lot_2")));
+		CHECK(Sharding::getKey(std::string("1")) != Sharding::getKey(1));
+		CHECK(Sharding::getKey(1) != Sharding::getKey(2));
+	}
+
+	SECTION("shards") {
+		constexpr size_t shardCount = 4;
+		std::vector<size_t> shapesPerShard(shardCount, 0);
+		for (int32_t cls = 0; cls < 1000; cls++) {
+			const size_t shard = Sharding::getShard(Sharding::getKey(cls), shardCount);
+			REQUIRE(shard < shardCount);
+			shapesPerShard[shard]++;
+		}
+		for (size_t n : shapesPerShard)
+			CHECK(n > 150); // consecutive classifier values are spread over all shards
+		CHECK(Sharding::getShard(Sharding::getKey(42), 1) == 0);
+	}
+
+	SECTION("neighbours") {
+		// a row of unit squares on the ground plane, one unit apart, and a large square far away
+		std::vector<Sharding::Bounds> bounds;
+		for (double x = 0.0; x < 10.0; x += 2.0)
+			bounds.push_back({{x, 0.0, 0.0}, {x + 1.0, 0.0, 1.0}});
+		bounds.push_back({{1000.0, 0.0, 0.0}, {2000.0, 0.0, 1000.0}});
+
+		const std::vector<bool> inShard = {false, false, true, false, false, false};
+		CHECK(Sharding::getNeighbours(bounds, inShard, 0.5).empty());
+		CHECK(Sharding::getNeighbours(bounds, inShard, 1.0) == std::vector<size_t>{1, 3});
+		CHECK(Sharding::getNeighbours(bounds, inShard, 3.0) == std::vector<size_t>{0, 1, 3, 4});
+		CHECK(Sharding::getNeighbours(bounds, {false, false, false, false, false, true}, 992.0) ==
+		      std::vector<size_t>{4});
+	}
+
+	SECTION("split") {
+		const ResolveMapSPtr resolveMap = prtCtx->getResolveMap(testDataPath / "GenAttrs1.rpk");
+		REQUIRE(resolveMap);
+
+		std::vector<InitialShapeUPtr> shapes;
+		InitialShapeNOPtrVector is;
+		for (double x = 0.0; x < 20.0; x += 2.0) {
+			shapes.emplace_back(createInitialShape(createLot(x, 0.0), resolveMap.get()));
+			is.push_back(shapes.back().get());
+		}
+		std::vector<uint64_t> keys;
+		std::transform(is.begin(), is.end(), std::back_inserter(keys),
+		               [](const prt::InitialShape* s) { return Sharding::getKey(s); });
+
+		// every initial shape is generated by exactly one shard
+		std::vector<size_t> generated;
+		for (size_t shard = 0; shard < 3; shard++) {
+			const Sharding::Split split = Sharding::split(is, keys, {shard, 3, true, 1.0});
+			generated.insert(generated.end(), split.shapes.begin(), split.shapes.end());
+			for (size_t o : split.occluders) {
+				CHECK(std::find(split.shapes.begin(), split.shapes.end(), o) == split.shapes.end());
+				const bool nextToShard = std::any_of(split.shapes.begin(), split.shapes.end(),
+				                                     [o](size_t s) { return s + 1 == o || o + 1 == s; });
+				CHECK(nextToShard);
+			}
+		}
+		std::sort(generated.begin(), generated.end());
+		std::vector<size_t> all(is.size());
+		std::iota(all.begin(), all.end(), 0);
+		CHECK(generated == all);
+
+		const Sharding::Bounds b = Sharding::getBounds(is[1]);
+		CHECK(b.min == std::array<double, 3>{2.0, 0.0, 0.0});
+		CHECK(b.max == std::array<double, 3>{3.0, 0.0, 1.0});
+	}
+}
+
+TEST_CASE("occlusion pipeline") {
+	const ResolveMapSPtr resolveMap = prtCtx->getResolveMap(testDataPath / "GenAttrs1.rpk");
+	REQUIRE(resolveMap);
+
+	std::vector<InitialShapeUPtr> shapes;
+	for (double x = 0.0; x < 20.0; x += 2.0)
+		shapes.emplace_back(createInitialShape(createLot(x, 0.0), resolveMap.get()));
+
+	std::vector<TestCallbacks> callbacks(3);
+	std::vector<prt::Callbacks*> callbacksPtrs;
+	for (auto& c : callbacks)
+		callbacksPtrs.push_back(&c);
+
+	OcclusionPipeline pipeline(callbacksPtrs, prtCtx->mPRTCache.get(), nullptr, 4); // two full and one partial batch
+	for (const auto& s : shapes)
+		pipeline.push(s.get());
+	CookReport cookReport;
+	const std::vector<prt::OcclusionSet::Handle> occlusionHandles = pipeline.finish(cookReport);
+
+	CHECK(occlusionHandles.size() == shapes.size());
+	for (const auto& c : callbacks)
+		CHECK(c.generateErrors.empty());
+	REQUIRE(cookReport.stages.size() == 1);
+	CHECK(std::string(cookReport.stages[0].first) == "occlusion");
+
+	pipeline.getOcclusionSet()->dispose(occlusionHandles.data(), occlusionHandles.size());
+}
+
+TEST_CASE("detail writer") {
+	constexpr size_t writesPerThread = 100;
+	std::vector<size_t> written; // only touched by the writer thread
+
+	DetailWriter detailWriter(64); // blocks after a few writes
+	std::vector<std::thread> generateThreads;
+	for (size_t ti = 0; ti < 4; ti++) {
+		generateThreads.emplace_back([&detailWriter, &written, ti]() {
+			for (size_t i = 0; i < writesPerThread; i++)
+				detailWriter.enqueue([&written, ti, i]() { written.push_back(ti * writesPerThread + i); }, 16);
+		});
+	}
+	for (auto& t : generateThreads)
+		t.join();
+	detailWriter.finish();
+
+	REQUIRE(written.size() == 4 * writesPerThread);
+	for (size_t ti = 0; ti < 4; ti++) { // the writes of each thread keep their order
+		std::vector<size_t> threadWrites;
+		std::copy_if(written.begin(), written.end(), std::back_inserter(threadWrites),
+		             [ti](size_t w) { return w / writesPerThread == ti; });
+		CHECK(std::is_sorted(threadWrites.begin(), threadWrites.end()));
+		CHECK(threadWrites.size() == writesPerThread);
+	}
+}
+
+TEST_CASE("deduplicate initial shapes") {
+	const ResolveMapSPtr resolveMap = prtCtx->getResolveMap(testDataPath / "GenAttrs1.rpk");
+	REQUIRE(resolveMap);
+
+	// three translated copies of the same lot, one with another seed and one with another shape
+	const std::vector<std::array<double, 2>> origins = {{0, 0}, {10, 0}, {10, 10}, {20, 0}, {30, 0}};
+	std::vector<InitialShapeUPtr> shapes;
+	InitialShapeNOPtrVector is;
+	for (size_t i = 0; i < origins.size(); i++) {
+		const auto [x, z] = origins[i];
+		CapturedShape shape = createLot(x, z, L"lot" + std::to_wstring(i), 1.0, (i == 4) ? 2.0 : 1.0);
+		shape.randomSeed = (i == 3) ? 7 : 0;
+		shapes.emplace_back(createInitialShape(shape, resolveMap.get()));
+		is.push_back(shapes.back().get());
+	}
+
+	const Deduplication::Classes classes = Deduplication::classify(is);
+	CHECK(classes.representatives == std::vector<size_t>{0, 3, 4});
+	REQUIRE(classes.duplicates.size() == 3);
+	REQUIRE(classes.duplicates[0].size() == 2);
+	CHECK(classes.duplicates[0][0].index == 1);
+	CHECK(classes.duplicates[0][0].offset == std::array<double, 3>{10, 0, 0});
+	CHECK(classes.duplicates[0][1].index == 2);
+	CHECK(classes.duplicates[0][1].offset == std::array<double, 3>{10, 0, 10});
+	CHECK(classes.duplicates[1].empty());
+	CHECK(classes.getDuplicateCount() == 2);
+
+	SECTION("emit copies") {
+		const InitialShapeNOPtrVector representatives = {is[0], is[3], is[4]};
+		TestCallbacks sink;
+		Deduplication::DuplicateEmitter emitter(sink, classes, is, 0);
+
+		const std::vector<double> vtx = {0, 0, 0, 1, 0, 0, 1, 1, 0};
+		const std::vector<uint32_t> counts = {3};
+		const std::vector<uint32_t> indices = {0, 1, 2};
+		const std::vector<uint32_t> faceRanges = {0, 1};
+		const AttributeMapBuilderUPtr amb(prt::AttributeMapBuilder::create());
+		const AttributeMapUPtr material(amb->createAttributeMap());
+		const prt::AttributeMap* materials[] = {material.get()};
+		const int32_t shapeIDs[] = {0};
+		for (size_t isIdx = 0; isIdx < representatives.size(); isIdx++) {
+			emitter.beginInitialShape(isIdx);
+			emitter.add(representatives[isIdx]->getName(), vtx.data(), vtx.size(), nullptr, 0, counts.data(),
+			            counts.size(), nullptr, 0, nullptr, 0, indices.data(), indices.size(), nullptr, 0, nullptr,
+			            nullptr, nullptr, nullptr, nullptr, nullptr, 0, faceRanges.data(), faceRanges.size(),
+			            materials, nullptr, shapeIDs);
+		}
+
+		REQUIRE(sink.results.size() == is.size());
+		CHECK(sink.results[0]->name == L"lot0");
+		CHECK(sink.results[1]->name == L"lot1");
+		CHECK(sink.results[1]->vtx == std::vector<double>{10, 0, 0, 11, 0, 0, 11, 1, 0});
+		CHECK(sink.results[2]->name == L"lot2");
+		CHECK(sink.results[2]->vtx == std::vector<double>{10, 0, 10, 11, 0, 10, 11, 1, 10});
+		CHECK(sink.results[3]->name == L"lot3");
+		CHECK(sink.results[3]->vtx == vtx);
+		CHECK(sink.results[4]->name == L"lot4");
+	}
+
+	SECTION("report errors for the duplicates") {
+		// the generate call of the second thread starts at the second representative (lot3)
+		TestCallbacks sink;
+		Deduplication::DuplicateEmitter emitter(sink, classes, is, 1);
+		emitter.generateError(1, prt::STATUS_UNSPECIFIED_ERROR, L"lot4 failed");
+		CHECK(sink.generateErrors == std::vector<std::pair<size_t, prt::Status>>{{4, prt::STATUS_UNSPECIFIED_ERROR}});
+
+		TestCallbacks firstSink;
+		Deduplication::DuplicateEmitter firstEmitter(firstSink, classes, is, 0);
+		firstEmitter.generateError(0, prt::STATUS_UNSPECIFIED_ERROR, L"lot0 failed");
+		REQUIRE(firstSink.generateErrors.size() == 3);
+		CHECK(firstSink.generateErrors[0].first == 0);
+		CHECK(firstSink.generateErrors[1].first == 1);
+		CHECK(firstSink.generateErrors[2].first == 2);
+	}
+}
+
+TEST_CASE("region of interest") {
+	auto cube = [](double x, double y, double z, double halfSize) {
+		return RegionOfInterest::Bounds{{x - halfSize, y - halfSize, z - halfSize},
+		                                {x + halfSize, y + halfSize, z + halfSize}};
+	};
+
+	SECTION("frustum") {
+		// a camera with a 90 degree field of view at the origin, looking down the negative z axis
+		const std::array<double, 16> identity = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+		const RegionOfInterest::Frustum frustum = RegionOfInterest::getFrustum(identity, 25.0, 50.0, 1.0, 1.0, 10.0);
+		CHECK(RegionOfInterest::intersects(frustum, cube(0, 0, -5, 0.5)));
+		CHECK(RegionOfInterest::intersects(frustum, cube(5.2, 0, -5, 0.5)));       // crosses the right plane
+		CHECK_FALSE(RegionOfInterest::intersects(frustum, cube(0, 0, 5, 0.5)));   // behind the camera
+		CHECK_FALSE(RegionOfInterest::intersects(frustum, cube(20, 0, -5, 0.5))); // right of the camera
+		CHECK_FALSE(RegionOfInterest::intersects(frustum, cube(0, 0, -11, 0.5))); // behind the far plane
+
+		// the same camera moved to x = 100 and turned to look down the negative x axis
+		const std::array<double, 16> turned = {0, 0, -1, 0, 0, 1, 0, 0, 1, 0, 0, 0, 100, 0, 0, 1};
+		const RegionOfInterest::Frustum turnedFrustum =
+		        RegionOfInterest::getFrustum(turned, 25.0, 50.0, 1.0, 1.0, 10.0);
+		CHECK(RegionOfInterest::intersects(turnedFrustum, cube(95, 0, 0, 0.5)));
+		CHECK_FALSE(RegionOfInterest::intersects(turnedFrustum, cube(105, 0, 0, 0.5)));
+	}
+
+	SECTION("spatial index") {
+		// a 100 x 100 grid of unit cubes two units apart, a shape without vertices and a large shape
+		std::vector<RegionOfInterest::Bounds> bounds;
+		for (int x = 0; x < 100; x++) {
+			for (int z = 0; z < 100; z++)
+				bounds.push_back(cube(x * 2.0, 0, z * 2.0, 0.5));
+		}
+		bounds.push_back({{1, 1, 1}, {0, 0, 0}});
+		bounds.push_back(cube(0, 0, 0, 1000));
+		const RegionOfInterest::SpatialIndex index(std::move(bounds));
+
+		CHECK(index.query(RegionOfInterest::Bounds{{9, -1, 9}, {13, 1, 11}}) == std::vector<size_t>{505, 605, 10001});
+		CHECK(index.query(cube(0, 0, 0, 1e9)).size() == 10001);
+		CHECK(index.query(cube(0, 2000, 0, 1)).empty());
+	}
+}
+
 TEST_CASE("detect RPK URIs") {
 	CHECK(!isRulePackageUri(nullptr));
 	CHECK(!isRulePackageUri(""));
@@ -921,4 +1394,512 @@ TEST_CASE("convert initial shape holes") {
 		const HoleConverter::FaceWithHoles expected = {{}};
 		CHECK(faceWithHole == expected);
 	}
-}
\ No newline at end of file
+}
+
+TEST_CASE("resolve map cache statistics") {
+	const std::filesystem::path tmpDir = std::filesystem::temp_directory_path() / "pld_test_resolve_map_cache";
+	std::filesystem::create_directories(tmpDir);
+
+	// each section uses its own copy to start with a cold cache entry
+	auto copyRPK = [&tmpDir](const std::string& name) {
+		const std::filesystem::path rpkPath = tmpDir / (name + ".rpk");
+		std::filesystem::copy_file(testDataPath / "GenAttrs1.rpk", rpkPath,
+		                           std::filesystem::copy_options::overwrite_existing);
+		return rpkPath;
+	};
+
+	const ResolveMapCache::Statistics initialStats = prtCtx->mResolveMapCache->getStatistics();
+
+	SECTION("hit") {
+		const std::filesystem::path rpkPath = copyRPK("hit");
+		const ResolveMapSPtr rm1 = prtCtx->getResolveMap(rpkPath);
+		const ResolveMapSPtr rm2 = prtCtx->getResolveMap(rpkPath);
+		REQUIRE(rm1);
+		CHECK(rm1 == rm2);
+
+		const ResolveMapCache::Statistics stats = prtCtx->mResolveMapCache->getStatistics();
+		CHECK(stats.hits >= initialStats.hits + 1);
+		CHECK(stats.reloads == initialStats.reloads);
+		CHECK(stats.flushedPRTEntries == initialStats.flushedPRTEntries);
+	}
+
+	SECTION("reload after change") {
+		const std::filesystem::path rpkPath = copyRPK("reload");
+		const ResolveMapSPtr rm1 = prtCtx->getResolveMap(rpkPath);
+		REQUIRE(rm1);
+
+		const auto ts = std::filesystem::last_write_time(rpkPath);
+		std::filesystem::last_write_time(rpkPath, ts + std::chrono::seconds(1));
+
+		const ResolveMapSPtr rm2 = prtCtx->getResolveMap(rpkPath, ResolveMapCache::Validation::FORCED);
+		REQUIRE(rm2);
+		CHECK(rm1 != rm2);
+
+		const ResolveMapCache::Statistics stats = prtCtx->mResolveMapCache->getStatistics();
+		CHECK(stats.reloads == initialStats.reloads + 1);
+		CHECK(stats.flushedPRTEntries > initialStats.flushedPRTEntries);
+	}
+
+	SECTION("throttled validation") {
+		const std::filesystem::path rpkPath = copyRPK("throttled");
+		const ResolveMapSPtr rm1 = prtCtx->getResolveMap(rpkPath);
+		REQUIRE(rm1);
+		const size_t validations = prtCtx->mResolveMapCache->getStatistics().validations;
+
+		// changes within the validation interval are not picked up
+		const auto ts = std::filesystem::last_write_time(rpkPath);
+		std::filesystem::last_write_time(rpkPath, ts + std::chrono::seconds(1));
+
+		const ResolveMapSPtr rm2 = prtCtx->getResolveMap(rpkPath);
+		CHECK(rm1 == rm2);
+
+		const ResolveMapCache::Statistics stats = prtCtx->mResolveMapCache->getStatistics();
+		CHECK(stats.validations == validations);
+		CHECK(stats.reloads == initialStats.reloads);
+	}
+
+	SECTION("concurrent lookups load only once") {
+		const std::filesystem::path rpkPath = copyRPK("concurrent");
+		constexpr size_t NUM_THREADS = 8;
+		std::vector<ResolveMapSPtr> resolveMaps(NUM_THREADS);
+		std::vector<std::future<void>> futures;
+		for (size_t ti = 0; ti < NUM_THREADS; ti++) {
+			futures.emplace_back(std::async(std::launch::async, [&resolveMaps, &rpkPath, ti]() {
+				resolveMaps[ti] = prtCtx->getResolveMap(rpkPath);
+			}));
+		}
+		std::for_each(futures.begin(), futures.end(), [](std::future<void>& f) { f.wait(); });
+
+		REQUIRE(resolveMaps.front());
+		CHECK(std::all_of(resolveMaps.begin(), resolveMaps.end(),
+		                  [&resolveMaps](const ResolveMapSPtr& rm) { return rm == resolveMaps.front(); }));
+
+		const ResolveMapCache::Statistics stats = prtCtx->mResolveMapCache->getStatistics();
+		CHECK(stats.misses == initialStats.misses + 1);
+		CHECK(stats.hits == initialStats.hits + NUM_THREADS - 1);
+		CHECK(stats.loadTime > initialStats.loadTime);
+	}
+
+	std::filesystem::remove_all(tmpDir);
+}
+
+TEST_CASE("resolve map cache eviction") {
+	const std::filesystem::path tmpDir = std::filesystem::temp_directory_path() / "pld_test_resolve_map_cache_eviction";
+	std::filesystem::create_directories(tmpDir);
+
+	std::vector<std::filesystem::path> rpks;
+	for (const std::string& n : {"a", "b", "c"}) {
+		rpks.emplace_back(tmpDir / (n + ".rpk"));
+		std::filesystem::copy_file(testDataPath / "GenAttrs1.rpk", rpks.back(),
+		                           std::filesystem::copy_options::overwrite_existing);
+	}
+	const uintmax_t rpkSize = std::filesystem::file_size(rpks.front());
+
+	ResolveMapCache::Limits limits;
+	limits.maxEntries = 1;
+	ResolveMapCache rmc(tmpDir / "unpack", nullptr, limits);
+
+	ResolveMapSPtr rmA = rmc.get(rpks[0]).first;
+	REQUIRE(rmA);
+
+	// a resolve map in use must never be evicted
+	ResolveMapSPtr rmB = rmc.get(rpks[1]).first;
+	REQUIRE(rmB);
+	CHECK(rmc.getStatistics().entries == 2);
+	CHECK(rmc.getStatistics().evictions == 0);
+	CHECK(rmc.getStatistics().residentSize == 2 * rpkSize);
+
+	rmA.reset();
+	rmB.reset();
+	const ResolveMapSPtr rmC = rmc.get(rpks[2]).first;
+	REQUIRE(rmC);
+
+	const ResolveMapCache::Statistics stats = rmc.getStatistics();
+	CHECK(stats.entries == 1);
+	CHECK(stats.evictions == 2);
+	CHECK(stats.residentSize == rpkSize);
+	CHECK(rmc.get(rpks[2]).second == ResolveMapCache::CacheStatus::HIT);
+	CHECK(rmc.get(rpks[0]).second == ResolveMapCache::CacheStatus::MISS);
+
+	std::filesystem::remove_all(tmpDir);
+}
+
+TEST_CASE("resolve map cache keys") {
+	const std::filesystem::path tmpDir = std::filesystem::temp_directory_path() / "pld_test_resolve_map_cache_keys";
+	std::filesystem::create_directories(tmpDir / "sub");
+
+	const std::filesystem::path rpkPath = tmpDir / "GenAttrs1.rpk";
+	std::filesystem::copy_file(testDataPath / "GenAttrs1.rpk", rpkPath,
+	                           std::filesystem::copy_options::overwrite_existing);
+	ResolveMapCache rmc(tmpDir / "unpack", nullptr);
+	const ResolveMapCache::LookupResult r1 = rmc.get(rpkPath);
+	REQUIRE(r1.first);
+	CHECK(r1.second == ResolveMapCache::CacheStatus::MISS);
+
+	CHECK(ResolveMapCache::getKey(tmpDir / "sub" / ".." / "GenAttrs1.rpk") == ResolveMapCache::getKey(rpkPath));
+	const ResolveMapCache::LookupResult r2 = rmc.get(tmpDir / "sub" / ".." / "GenAttrs1.rpk");
+	CHECK(r2.first == r1.first);
+	CHECK(r2.second == ResolveMapCache::CacheStatus::HIT);
+
+#ifdef PLD_LINUX // creating symlinks requires elevated privileges on Windows
+	const std::filesystem::path symlinkPath = tmpDir / "sub" / "link.rpk";
+	std::filesystem::remove(symlinkPath);
+	std::filesystem::create_symlink(rpkPath, symlinkPath);
+
+	const ResolveMapCache::LookupResult r3 = rmc.get(symlinkPath);
+	CHECK(r3.first == r1.first);
+	CHECK(r3.second == ResolveMapCache::CacheStatus::HIT);
+#endif
+
+	CHECK(rmc.getStatistics().entries == 1);
+
+	std::filesystem::remove_all(tmpDir);
+}
+
+TEST_CASE("embedded RPK in memory") {
+	std::ifstream in(testDataPath / "uvsets.rpk", std::ifstream::binary);
+	const std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	REQUIRE(!content.empty());
+	const RPKDiskCache::ContentKey contentKey = RPKDiskCache::getContentKey(content.data(), content.size());
+
+	const std::filesystem::path tmpDir = std::filesystem::temp_directory_path() / "pld_test_embedded_rpk_in_memory";
+	ResolveMapCache rmc(tmpDir / "unpack", nullptr);
+	const auto copy1 = std::make_shared<const std::string>(content);
+	const auto copy2 = std::make_shared<const std::string>(content);
+	const std::shared_ptr<const char> data =
+	        rmc.retainEmbeddedRPK(std::shared_ptr<const char>(copy1, copy1->data()), copy1->size(), contentKey);
+	REQUIRE(data.get() == copy1->data());
+	CHECK(rmc.retainEmbeddedRPK(std::shared_ptr<const char>(copy2, copy2->data()), copy2->size(), contentKey) ==
+	      data); // identical embedded RPKs share one copy
+	CHECK_FALSE(std::filesystem::exists(tmpDir / "unpack"));
+
+	const std::wstring rpkURI = toMemoryURI(data.get(), content.size(), L".rpk");
+	prt::Status status = prt::STATUS_UNSPECIFIED_ERROR;
+	const ResolveMapUPtr resolveMap(prt::createResolveMap(rpkURI.c_str(), nullptr, &status));
+	REQUIRE(status == prt::STATUS_OK);
+
+	const wchar_t* textureURI = nullptr;
+	size_t keyCount = 0;
+	const wchar_t* const* keys = resolveMap->getKeys(&keyCount);
+	for (size_t k = 0; k < keyCount; k++) {
+		if (std::wstring(keys[k]).find(L"uvtest.png") != std::wstring::npos)
+			textureURI = resolveMap->getString(keys[k]);
+	}
+	REQUIRE(textureURI != nullptr);
+
+	// palladio_fs resolves the asset URIs of in-memory packages through the retained copy
+	const std::pair<std::string, std::string> texture = splitRulePackageUri(toOSNarrowFromUTF16(textureURI).c_str());
+	REQUIRE(!texture.first.empty());
+	const RulePackageIndex index(texture.first);
+	CHECK(index.isFile(texture.second));
+	CHECK(index.isDirectory(".ws/ESRI.lib/assets/General"));
+}
+
+TEST_CASE("rpk disk cache") {
+	const std::filesystem::path tmpDir = std::filesystem::temp_directory_path() / "pld_test_rpk_disk_cache";
+	std::filesystem::remove_all(tmpDir);
+	const std::filesystem::path cacheDir = tmpDir / "cache";
+
+	const std::filesystem::path rpkPath = testDataPath / "GenAttrs1.rpk";
+	const std::wstring rpkURI = toFileURI(rpkPath);
+	const RPKDiskCache::ContentKey contentKey = RPKDiskCache::getContentKey(rpkPath);
+	REQUIRE(contentKey.isValid());
+	CHECK(contentKey.size == std::filesystem::file_size(rpkPath));
+
+	// another rule package with the same content
+	auto getOtherKey = [&contentKey](char c) {
+		RPKDiskCache::ContentKey k = contentKey;
+		k.digest.back() = c;
+		return k;
+	};
+
+	auto getEntryCount = [&cacheDir]() {
+		return std::count_if(std::filesystem::directory_iterator(cacheDir), std::filesystem::directory_iterator(),
+		                     [](const auto& de) { return de.is_directory() && de.path().filename() != "locks"; });
+	};
+
+	SECTION("content key") {
+		const std::string abc = "abc";
+		const RPKDiskCache::ContentKey k = RPKDiskCache::getContentKey(abc.data(), abc.size());
+		CHECK(k.digest == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+		CHECK(k.size == 3);
+
+		std::ifstream in(rpkPath, std::ifstream::binary);
+		const std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		CHECK(RPKDiskCache::getContentKey(content.data(), content.size()) == contentKey);
+		CHECK_FALSE(RPKDiskCache::getContentKey(tmpDir / "missing.rpk").isValid());
+	}
+
+	SECTION("reuse unpacked rule package") {
+		RPKDiskCache session1(cacheDir, 0);
+		const ResolveMapSPtr rm1 = session1.get(rpkURI, contentKey);
+		REQUIRE(rm1);
+
+		RPKDiskCache session2(cacheDir, 0);
+		const ResolveMapSPtr rm2 = session2.get(rpkURI, contentKey);
+		REQUIRE(rm2);
+
+		const auto cgb1 = getCGB(rm1);
+		const auto cgb2 = getCGB(rm2);
+		REQUIRE(cgb1);
+		REQUIRE(cgb2);
+		CHECK(cgb1->second == cgb2->second);
+		CHECK(getEntryCount() == 1);
+	}
+
+	SECTION("verify manifest") {
+		RPKDiskCache rdc(cacheDir, 0);
+		REQUIRE(rdc.get(rpkURI, contentKey));
+
+		// an entry whose manifest does not match the content key is unpacked again
+		const std::filesystem::path manifest = cacheDir / contentKey.digest / "resolvemap.txt";
+		REQUIRE(std::filesystem::exists(manifest));
+		std::ofstream(manifest, std::ofstream::binary)
+		        << "#" << contentKey.digest << "\t" << contentKey.size + 1 << "\n";
+
+		const ResolveMapSPtr rm = rdc.get(rpkURI, contentKey);
+		REQUIRE(rm);
+		CHECK(getCGB(rm));
+	}
+
+	SECTION("prune unused entries") {
+		RPKDiskCache rdc(cacheDir, 1); // every entry exceeds the size limit
+		ResolveMapSPtr rm1 = rdc.get(rpkURI, getOtherKey('0'));
+		REQUIRE(rm1);
+
+		// entries in use are never pruned
+		const ResolveMapSPtr rm2 = rdc.get(rpkURI, getOtherKey('1'));
+		REQUIRE(rm2);
+		CHECK(getEntryCount() == 2);
+
+		rm1.reset();
+		const ResolveMapSPtr rm3 = rdc.get(rpkURI, getOtherKey('2'));
+		REQUIRE(rm3);
+		CHECK(getEntryCount() == 2);
+	}
+
+	std::filesystem::remove_all(tmpDir);
+}
+
+TEST_CASE("rule package cache") {
+	int64_t modificationTime = 1;
+	RulePackageCache<std::string> cache(2, [&modificationTime](const char*) { return modificationTime; });
+
+	size_t creations = 0;
+	const auto create = [&creations]() {
+		creations++;
+		return std::make_shared<const std::string>("entry " + std::to_string(creations));
+	};
+	const char* source = "rpk:file:/tmp/foo.rpk!/bar.jpg";
+
+	const RulePackageCache<std::string>::ValueSPtr e1 = cache.get(source, source, create);
+	REQUIRE(e1);
+	CHECK(*e1 == "entry 1");
+
+	SECTION("hit") {
+		CHECK(cache.get(source, source, create) == e1);
+		CHECK(creations == 1);
+	}
+
+	SECTION("changed modification time") {
+		modificationTime = 2;
+		const RulePackageCache<std::string>::ValueSPtr e2 = cache.get(source, source, create);
+		REQUIRE(e2);
+		CHECK(*e2 == "entry 2");
+		CHECK(cache.get(source, source, create) == e2);
+		CHECK(creations == 2);
+	}
+
+	SECTION("failures are not cached") {
+		const auto fail = [&creations]() {
+			creations++;
+			return RulePackageCache<std::string>::ValueSPtr();
+		};
+		CHECK(!cache.get("other", source, fail));
+		CHECK(!cache.get("other", source, fail));
+		CHECK(creations == 3);
+	}
+}
+
+TEST_CASE("rule package index") {
+	const std::string packageURI = toOSNarrowFromUTF16(toFileURI(testDataPath / "uvsets.rpk"));
+	const RulePackageIndex index(packageURI);
+
+	CHECK(index.isDirectory(""));
+	CHECK(index.isDirectory("bin"));
+	CHECK(index.isDirectory(".ws/ESRI.lib/assets/General"));
+	CHECK_FALSE(index.isDirectory("bin/r1.cgb"));
+	CHECK_FALSE(index.isDirectory("foo"));
+	CHECK(index.isFile("bin/r1.cgb"));
+	CHECK(index.isFile(".ws/ESRI.lib/assets/General/uvtest.png"));
+	CHECK_FALSE(index.isFile("bin"));
+
+	std::vector<std::string> files, dirs;
+	REQUIRE(index.getContents("", files, dirs));
+	CHECK(std::find(dirs.begin(), dirs.end(), "bin") != dirs.end());
+	CHECK(std::find(dirs.begin(), dirs.end(), ".ws") != dirs.end());
+
+	files.clear();
+	dirs.clear();
+	REQUIRE(index.getContents(".ws/ESRI.lib/assets/General", files, dirs));
+	CHECK(files == std::vector<std::string>{"uvtest.png"});
+	CHECK(dirs == std::vector<std::string>{"Dirtmap"});
+
+	CHECK_FALSE(index.getContents("foo", files, dirs));
+
+	const RulePackageIndex missing(toOSNarrowFromUTF16(toFileURI(testDataPath / "missing.rpk")));
+	CHECK_FALSE(missing.isDirectory(""));
+
+	CHECK(splitRulePackageUri("rpk:file:/foo/bar.rpk!/my/asset.jpg") ==
+	      std::make_pair(std::string("file:/foo/bar.rpk"), std::string("my/asset.jpg")));
+	CHECK(splitRulePackageUri("file:/foo/bar.rpk").first.empty());
+}
+
+TEST_CASE("preload resolve map") {
+	const std::filesystem::path tmpDir = std::filesystem::temp_directory_path() / "pld_test_preload";
+	std::filesystem::create_directories(tmpDir);
+	const std::filesystem::path rpkPath = tmpDir / "GenAttrs1.rpk";
+	std::filesystem::copy_file(testDataPath / "GenAttrs1.rpk", rpkPath,
+	                           std::filesystem::copy_options::overwrite_existing);
+
+	const ResolveMapCache::Statistics initialStats = prtCtx->mResolveMapCache->getStatistics();
+
+	// the lookup either waits for the preload or loads the RPK itself, but never loads it twice
+	prtCtx->preloadResolveMap(rpkPath);
+	const ResolveMapSPtr rm = prtCtx->getResolveMap(rpkPath);
+	REQUIRE(rm);
+
+	const ResolveMapCache::Statistics stats = prtCtx->mResolveMapCache->getStatistics();
+	CHECK(stats.misses == initialStats.misses + 1);
+
+	// embedded RPKs can only be read on the main thread, a preload skips them
+	CHECK(ResolveMapCache::isEmbedded("opdef:/Object/foo?bar.rpk"));
+	prtCtx->preloadResolveMap("opdef:/Object/foo?bar.rpk");
+	CHECK(prtCtx->mResolveMapCache->getStatistics().misses == stats.misses);
+
+	std::filesystem::remove_all(tmpDir);
+}
+
+TEST_CASE("trace cook") {
+	const std::filesystem::path traceDir = std::filesystem::temp_directory_path() / "pld_test_trace";
+	std::filesystem::remove_all(traceDir);
+
+	SECTION("disabled") {
+		tracing::setTraceDirectory({});
+		{
+			PLD_TRACE_COOK("cook");
+			PLD_TRACE_SCOPE("stage");
+		}
+		CHECK_FALSE(std::filesystem::exists(traceDir));
+	}
+
+	SECTION("enabled") {
+		tracing::setTraceDirectory(traceDir);
+		{
+			PLD_TRACE_COOK("cook");
+			PLD_TRACE_SCOPE("main stage");
+			std::async(std::launch::async, [] { PLD_TRACE_SCOPE("worker stage"); }).wait();
+		}
+		tracing::setTraceDirectory({});
+
+		const std::filesystem::path traceFile = traceDir / "cook.json";
+		REQUIRE(std::filesystem::exists(traceFile));
+		std::ifstream in(traceFile);
+		const std::string trace((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		CHECK(trace.find("\"main stage\"") != std::string::npos);
+		CHECK(trace.find("\"worker stage\"") != std::string::npos);
+		CHECK(trace.find("\"thread_name\"") != std::string::npos);
+	}
+
+	std::filesystem::remove_all(traceDir);
+}
+
+TEST_CASE("cook report") {
+	CookReport report;
+	report.addStage("generation", CookReport::Duration(2.0));
+	report.threads = 4;
+	report.threadWallTime = CookReport::Duration(2.0);
+	report.threadBusyTime = CookReport::Duration(6.0);
+
+	ResolveMapCache::Statistics before;
+	before.hits = 3;
+	ResolveMapCache::Statistics after;
+	after.hits = 5;
+	after.misses = 1;
+	report.setResolveMapCacheStatistics(before, after);
+
+	CHECK(report.getThreadUtilization() == Approx(0.75));
+	CHECK(report.rpkCacheHits == 2);
+	CHECK(report.rpkCacheMisses == 1);
+
+	const std::string json = report.toJSON();
+	CHECK(json.find("\"stages\": [{\"name\": \"generation\", \"time\": 2.000000}]") != std::string::npos);
+	CHECK(json.find("\"threadUtilization\": 0.750000") != std::string::npos);
+}
+
+TEST_CASE("preview footprints") {
+	const ResolveMapSPtr resolveMap = prtCtx->getResolveMap(testDataPath / "GenAttrs1.rpk");
+	REQUIRE(resolveMap);
+
+	CapturedShape shape = createLot(0.0, 0.0);
+
+	SECTION("height attribute") {
+		const AttributeMapBuilderUPtr amb(prt::AttributeMapBuilder::create());
+		amb->setFloat(L"Default$height", 5.0);
+		shape.attributes.reset(amb->createAttributeMap());
+		const InitialShapeUPtr is = createInitialShape(shape, resolveMap.get());
+		CHECK(Preview::getHeight(is.get(), L"height", 10.0) == 5.0);
+		CHECK(Preview::getHeight(is.get(), L"width", 10.0) == 10.0);
+	}
+
+	SECTION("extrusion") {
+		const InitialShapeUPtr is = createInitialShape(shape, resolveMap.get());
+		TestCallbacks sink;
+		Preview::addExtrudedFootprint(sink, is.get(), 5.0);
+
+		REQUIRE(sink.results.size() == 1);
+		const CallbackResult& cr = *sink.results[0];
+		CHECK(cr.name == L"lot");
+		CHECK(cr.vtx.size() == 8 * 3);
+		CHECK(cr.vtx[4 * 3 + 1] == 5.0);
+		CHECK(cr.cnts == std::vector<uint32_t>(6, 4));
+		CHECK(cr.holeCnts.empty());
+		CHECK(cr.faceRanges == std::vector<uint32_t>{0, 6});
+
+		// the top face and the first wall in houdini (clockwise) winding, the lot is clockwise seen from above
+		CHECK(std::vector<uint32_t>(cr.vtxIdx.begin(), cr.vtxIdx.begin() + 4) == std::vector<uint32_t>{4, 5, 6, 7});
+		CHECK(std::vector<uint32_t>(cr.vtxIdx.begin() + 8, cr.vtxIdx.begin() + 12) ==
+		      std::vector<uint32_t>{7, 6, 2, 3});
+	}
+
+	SECTION("clockwise footprint with hole") {
+		shape.vertices = {0, 0, 0, 4, 0, 0, 4, 0, 4, 0, 0, 4, 1, 0, 1, 1, 0, 3, 3, 0, 3, 3, 0, 1};
+		shape.indices = {0, 1, 2, 3, 4, 5, 6, 7};
+		shape.faceCounts = {4, 4};
+		shape.holes = {0, 1, std::numeric_limits<uint32_t>::max()};
+		const InitialShapeUPtr is = createInitialShape(shape, resolveMap.get());
+		TestCallbacks sink;
+		Preview::addExtrudedFootprint(sink, is.get(), 5.0);
+
+		REQUIRE(sink.results.size() == 1);
+		const CallbackResult& cr = *sink.results[0];
+		CHECK(cr.cnts.size() == 12); // top and bottom with hole, four outer and four inner walls
+		REQUIRE(cr.holeCnts.size() == 12);
+		CHECK(cr.holeCnts[0] == 1);
+		CHECK(cr.holeCnts[2] == 1);
+		CHECK(cr.holeIdx == std::vector<uint32_t>{1, 3});
+
+		// the outer ring is reversed to face upwards
+		CHECK(std::vector<uint32_t>(cr.vtxIdx.begin(), cr.vtxIdx.begin() + 4) == std::vector<uint32_t>{8, 9, 10, 11});
+	}
+
+	SECTION("no height") {
+		const InitialShapeUPtr is = createInitialShape(shape, resolveMap.get());
+		TestCallbacks sink;
+		Preview::addExtrudedFootprint(sink, is.get(), 0.0);
+
+		REQUIRE(sink.results.size() == 1);
+		CHECK(sink.results[0]->vtx == shape.vertices);
+		CHECK(sink.results[0]->cnts == std::vector<uint32_t>{4});
+	}
+}
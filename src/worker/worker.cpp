@@ -0,0 +1,149 @@
+/*
+ * Copyright 2014-2025 Esri R&D Zurich and VRBN
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * generation worker process of the generate node, see WorkerGenerate.h
+ * usage: palladio_worker SCENE.pldscene RESULT.pldrec
+ */
+
+#include "CallbackRecording.h"
+#include "HeadlessGenerate.h"
+#include "LogHandler.h"
+#include "PRTContext.h"
+#include "SceneCapture.h"
+
+#include <exception>
+#include <iostream>
+
+namespace {
+
+// exit codes, see WorkerGenerate.cpp
+constexpr int EXIT_OK = 0;
+constexpr int EXIT_SETUP_FAILED = 1;
+constexpr int EXIT_USAGE = 2;
+constexpr int EXIT_GENERATE_FAILED = 3;
+
+/**
+ * the generated geometry only goes into the recording, the messages go into the log of the worker
+ */
+class WorkerSink : public HoudiniCallbacks {
+public:
+	~WorkerSink() override = default;
+
+	void add(const wchar_t*, const double*, size_t, const double*, size_t, const uint32_t*, size_t, const uint32_t*,
+	         size_t, const uint32_t*, size_t, const uint32_t*, size_t, const uint32_t*, size_t, double const* const*,
+	         size_t const*, uint32_t const* const*, size_t const*, uint32_t const* const*, size_t const*, uint32_t,
+	         const uint32_t*, size_t, const prt::AttributeMap**, const prt::AttributeMap**,
+	         const int32_t*) override {}
+
+	prt::Status generateError(size_t isIndex, prt::Status status, const wchar_t* message) override {
+		LOG_WRN << "initial shape " << isIndex << ": " << message;
+		return prt::STATUS_OK;
+	}
+	prt::Status assetError(size_t isIndex, prt::CGAErrorLevel, const wchar_t* key, const wchar_t*,
+	                       const wchar_t* message) override {
+		LOG_WRN << "initial shape " << isIndex << ": asset " << key << ": " << message;
+		return prt::STATUS_OK;
+	}
+	prt::Status cgaError(size_t isIndex, int32_t, prt::CGAErrorLevel, int32_t, int32_t,
+	                     const wchar_t* message) override {
+		LOG_WRN << "initial shape " << isIndex << ": CGA error: " << message;
+		return prt::STATUS_OK;
+	}
+	prt::Status cgaPrint(size_t isIndex, int32_t shapeID, const wchar_t* txt) override {
+		LOG_INF << isIndex << ": " << shapeID << ": " << txt;
+		return prt::STATUS_OK;
+	}
+
+	prt::Status cgaReportBool(size_t, int32_t, const wchar_t*, bool) override {
+		return prt::STATUS_OK;
+	}
+	prt::Status cgaReportFloat(size_t, int32_t, const wchar_t*, double) override {
+		return prt::STATUS_OK;
+	}
+	prt::Status cgaReportString(size_t, int32_t, const wchar_t*, const wchar_t*) override {
+		return prt::STATUS_OK;
+	}
+	prt::Status attrBool(size_t, int32_t, const wchar_t*, bool) override {
+		return prt::STATUS_OK;
+	}
+	prt::Status attrFloat(size_t, int32_t, const wchar_t*, double) override {
+		return prt::STATUS_OK;
+	}
+	prt::Status attrString(size_t, int32_t, const wchar_t*, const wchar_t*) override {
+		return prt::STATUS_OK;
+	}
+
+#if ((PRT_VERSION_MAJOR > 1 && PRT_VERSION_MINOR > 1) || PRT_VERSION_MAJOR > 2)
+	prt::Status attrBoolArray(size_t, int32_t, const wchar_t*, const bool*, size_t, size_t) override {
+		return prt::STATUS_OK;
+	}
+	prt::Status attrFloatArray(size_t, int32_t, const wchar_t*, const double*, size_t, size_t) override {
+		return prt::STATUS_OK;
+	}
+	prt::Status attrStringArray(size_t, int32_t, const wchar_t*, const wchar_t* const*, size_t, size_t) override {
+		return prt::STATUS_OK;
+	}
+#elif (PRT_VERSION_MAJOR > 1 && PRT_VERSION_MINOR > 0)
+	prt::Status attrBoolArray(size_t, int32_t, const wchar_t*, const bool*, size_t) override {
+		return prt::STATUS_OK;
+	}
+	prt::Status attrFloatArray(size_t, int32_t, const wchar_t*, const double*, size_t) override {
+		return prt::STATUS_OK;
+	}
+	prt::Status attrStringArray(size_t, int32_t, const wchar_t*, const wchar_t* const*, size_t) override {
+		return prt::STATUS_OK;
+	}
+#endif
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+	if (argc != 3) {
+		std::cerr << "usage: palladio_worker SCENE.pldscene RESULT.pldrec" << std::endl;
+		return EXIT_USAGE;
+	}
+	const std::filesystem::path sceneFile = argv[1];
+	const std::filesystem::path resultFile = argv[2];
+
+	// the worker is installed next to the PRT libraries, the default extension dir contains our codec
+	PRTContext prtCtx;
+	if (!prtCtx.isAlive())
+		return EXIT_SETUP_FAILED;
+
+	try {
+		const CapturedScene scene = readScene(sceneFile);
+		const std::vector<InitialShapeUPtr> initialShapes = createInitialShapes(scene.shapes, prtCtx);
+		InitialShapeNOPtrVector is;
+		for (const auto& s : initialShapes)
+			is.push_back(s.get());
+
+		CallbackRecording recording(resultFile);
+		if (!recording.isOpen())
+			return EXIT_SETUP_FAILED;
+
+		// a single generate call keeps the initial shape indices of the recording relative to the scene
+		WorkerSink sink;
+		CallbackRecorder recorder(recording, sink);
+		const size_t failedCalls = generateHeadless(is, getGenerateSetup(scene), {&recorder}, prtCtx.mPRTCache.get());
+		return (failedCalls == 0) ? EXIT_OK : EXIT_GENERATE_FAILED;
+	}
+	catch (const std::exception& e) {
+		LOG_ERR << "worker failed: " << e.what();
+		return EXIT_SETUP_FAILED;
+	}
+}